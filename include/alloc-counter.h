@@ -0,0 +1,148 @@
+/**
+ * @file alloc-counter.h
+ * @class AllocCounter, AllocScope, TrackingAllocator
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Allocation counting for tests and benchmarks. Linking alloc-counter.cpp
+ * replaces the global operator new and delete with versions that count
+ * into the calling thread, which catches the containers' bare new and
+ * delete as well as everything else. TrackingAllocator attributes the
+ * allocations of one allocator-aware container to a tally of its own.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct AllocStats
+* Allocation counts. bytes is what was asked for, not what the allocator
+* rounded it up to.
+*/
+struct AllocStats {
+	std::uint64_t allocations = 0;
+	std::uint64_t deallocations = 0;
+	std::uint64_t bytes = 0;
+
+	AllocStats operator-(const AllocStats& other) const
+	{
+		return {allocations - other.allocations,
+			deallocations - other.deallocations, bytes - other.bytes};
+	}
+};
+
+/**
+* @class AllocCounter
+* The calling thread's counts from the global operator new and delete.
+* Counting is a thread-local add, so threads don't contend.
+*/
+class AllocCounter {
+public:
+	/**
+	 * Returns the calling thread's counts since it started.
+	 */
+	static AllocStats thread();
+
+	/**
+	 * Called by the replacement operators.
+	 */
+	static void allocated(std::size_t bytes) noexcept;
+	static void deallocated() noexcept;
+};
+
+/**
+* @class AllocScope
+* Counts the calling thread's allocations from construction on, e.g. to
+* assert that a hit path allocates nothing:
+*
+*     AllocScope scope;
+*     cache.get(key, value);
+*     assert(scope.stats().allocations == 0);
+*/
+class AllocScope {
+public:
+	AllocScope() : _start(AllocCounter::thread()) {}
+
+	AllocStats stats() const { return AllocCounter::thread() - _start; }
+private:
+	AllocStats _start;
+};
+
+/**
+* @struct AllocTally
+* Counts shared by the copies of a TrackingAllocator. Atomic, since a
+* container's copies may allocate from several threads.
+*/
+struct AllocTally {
+	std::atomic<std::uint64_t> allocations{0};
+	std::atomic<std::uint64_t> deallocations{0};
+	std::atomic<std::uint64_t> bytes{0};
+
+	AllocStats stats() const
+	{
+		return {allocations.load(std::memory_order_relaxed),
+			deallocations.load(std::memory_order_relaxed),
+			bytes.load(std::memory_order_relaxed)};
+	}
+};
+
+/**
+* @class TrackingAllocator
+* A standard allocator that counts into an AllocTally, then allocates
+* through std::allocator. Rebound copies count into the same tally, so a
+* node-based container's node allocations are included.
+*/
+template <typename T>
+class TrackingAllocator {
+public:
+	using value_type = T;
+
+	explicit TrackingAllocator(AllocTally& tally) noexcept : _tally(&tally) {}
+
+	template <typename U>
+	TrackingAllocator(const TrackingAllocator<U>& other) noexcept :
+		_tally(other.tally()) {}
+
+	T* allocate(std::size_t n)
+	{
+		_tally->allocations.fetch_add(1, std::memory_order_relaxed);
+		_tally->bytes.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept
+	{
+		_tally->deallocations.fetch_add(1, std::memory_order_relaxed);
+		std::allocator<T>().deallocate(p, n);
+	}
+
+	AllocTally* tally() const noexcept { return _tally; }
+
+	template <typename U>
+	bool operator==(const TrackingAllocator<U>& other) const noexcept
+	{
+		return _tally == other.tally();
+	}
+
+	template <typename U>
+	bool operator!=(const TrackingAllocator<U>& other) const noexcept
+	{
+		return _tally != other.tally();
+	}
+private:
+	AllocTally *_tally;
+};
+}
@@ -0,0 +1,91 @@
+/**
+ * @file backing-store.h
+ * @class BackingStore, FileStore
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * The store a write-back CacheManager flushes to, and a local file-backed
+ * stand-in for it.
+ */
+
+#pragma once
+
+#include "binary-io.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class BackingStore
+* The slow store behind a cache. Implementations must be thread-safe.
+*/
+template <typename K, typename V>
+class BackingStore {
+public:
+	virtual ~BackingStore() {}
+
+	/**
+	 * Writes a batch of key-value pairs; keys in a batch are unique. Throws
+	 * on failure, in which case none of the batch counts as written.
+	 *
+	 * @param std::vector<std::pair<K, V>> batch The pairs to write.
+	 */
+	virtual void write_batch(const std::vector<std::pair<K, V>>& batch) = 0;
+
+	/**
+	 * Reads the value associated with the key.
+	 *
+	 * @return TRUE if found; FALSE if not.
+	 */
+	virtual bool read(const K& key, V& value) = 0;
+};
+
+/**
+* @class FileStore
+* A BackingStore kept as an append-only log file of csc::Codec records, with
+* the latest value of each key indexed in memory. Reopening the file replays
+* the log. Counts batches and pairs written, for tests.
+*/
+template <typename K, typename V>
+class FileStore : public BackingStore<K, V> {
+public:
+	/**
+	 * Opens the log at path, replaying any records already in it.
+	 */
+	explicit FileStore(const std::string& path);
+
+	void write_batch(const std::vector<std::pair<K, V>>& batch) override;
+	bool read(const K& key, V& value) override;
+
+	/**
+	 * Returns the number of write_batch() calls.
+	 */
+	std::uint64_t batches();
+
+	/**
+	 * Returns the number of pairs written.
+	 */
+	std::uint64_t writes();
+private:
+	std::mutex _mutex;
+	std::ofstream _log;
+	std::unordered_map<K, V> _values;
+	std::uint64_t _batches;
+	std::uint64_t _writes;
+};
+}
+#include "backing-store.tpp"
@@ -0,0 +1,110 @@
+/**
+ * @file bench.h
+ * @class Bench
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * A small microbenchmark harness for the cache-bench target.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct BenchOptions
+* How many times to run each benchmark, and which ones.
+*/
+struct BenchOptions {
+	std::size_t warmup = 1;			// Untimed runs before measuring.
+	std::size_t repetitions = 11;	// Timed runs.
+	std::string filter;				// Run only names containing this.
+};
+
+/**
+* @struct BenchResult
+* One benchmark, summarized over its repetitions.
+*/
+struct BenchResult {
+	std::string name;
+	std::size_t ops = 0;		// Operations per repetition.
+	std::size_t repetitions = 0;
+	double median_ns = 0;		// Per operation, median repetition.
+	double min_ns = 0;			// Per operation, fastest repetition.
+	double max_ns = 0;			// Per operation, slowest repetition.
+	double ops_per_sec = 0;		// At the median.
+	// Per operation, over the timed repetitions, on the calling thread.
+	double allocs_per_op = 0;
+	double bytes_per_op = 0;
+};
+
+/**
+ * Keeps the compiler from discarding a value a benchmark computes.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+* @class Bench
+* Times a body that does a fixed number of operations: warmup runs first,
+* then repetitions, each timed whole and divided by the operation count.
+* An untimed setup, if given, runs before every run, so a body that
+* consumes its input (inserts, removes) starts from the same state each
+* time. Results print as a table or as JSON for tools/bench-compare.py.
+* Allocations are counted by alloc-counter.cpp, which cache-bench links.
+*/
+class Bench {
+public:
+	using Body = std::function<void()>;
+
+	/**
+	 * Constructor.
+	 */
+	explicit Bench(const BenchOptions& options = BenchOptions());
+
+	/**
+	 * Runs and records a benchmark, unless the filter skips it.
+	 *
+	 * @param ops The operations one call of body does.
+	 */
+	void run(const std::string& name, std::size_t ops, const Body& body);
+	void run(const std::string& name, std::size_t ops, const Body& setup,
+		const Body& body);
+
+	/**
+	 * Returns the results so far, in run order.
+	 */
+	const std::vector<BenchResult>& results() const;
+
+	/**
+	 * Prints the results as an aligned table.
+	 */
+	void report(std::ostream& out) const;
+
+	/**
+	 * Prints the results as a JSON object with a "benchmarks" array.
+	 */
+	void json(std::ostream& out) const;
+private:
+	using Clock = std::chrono::steady_clock;
+
+	BenchOptions _options;
+	std::vector<BenchResult> _results;
+};
+}
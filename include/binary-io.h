@@ -0,0 +1,219 @@
+/**
+ * @file binary-io.h
+ * @class BinaryWriter, BinaryReader, Codec
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Buffered binary streams and the versioned dump format shared by HashMap
+ * and CacheManager.
+ *
+ * A dump is a DumpHeader, then `count` entries of key and value, each
+ * encoded by Codec, then a trailer of DUMP_END and `count` again so a
+ * truncated file is detected. Integers are little-endian, as written by
+ * the host; dumps are not portable across byte orders.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class BinaryWriter
+* Collects small writes in a large buffer and hands them to the ostream in
+* big blocks.
+*/
+class BinaryWriter {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param std::ostream out The stream to write to.
+	 * @param std::size_t buffer The buffer size in bytes.
+	 */
+	explicit BinaryWriter(std::ostream& out,
+		std::size_t buffer = DEFAULT_BUFFER);
+
+	/**
+	 * Destructor. Flushes the buffer.
+	 */
+	~BinaryWriter();
+
+	// Disallow copy and assignment.
+	BinaryWriter(const BinaryWriter& other) = delete;
+	BinaryWriter& operator=(const BinaryWriter& other) = delete;
+
+	/**
+	 * Appends n bytes.
+	 */
+	void write(const void* data, std::size_t n);
+
+	/**
+	 * Appends a trivially copyable value as its raw bytes.
+	 */
+	template <typename T>
+	void put(const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+			"put() needs a trivially copyable type");
+		write(&value, sizeof(T));
+	}
+
+	/**
+	 * Writes the buffer out. Throws std::ios_base::failure if the stream
+	 * fails.
+	 */
+	void flush();
+
+	static constexpr std::size_t DEFAULT_BUFFER = 1 << 20;
+private:
+	std::ostream& _out;
+	std::vector<char> _buffer;
+	std::size_t _used;
+};
+
+/**
+* @class BinaryReader
+* Reads the istream in blocks and serves small reads from the buffer. Blocks
+* are taken only from what the stream has already buffered, so finish() can
+* hand the unread rest back and a dump can be followed by other data.
+*/
+class BinaryReader {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param std::istream in The stream to read from.
+	 * @param std::size_t buffer The buffer size in bytes.
+	 */
+	explicit BinaryReader(std::istream& in,
+		std::size_t buffer = BinaryWriter::DEFAULT_BUFFER);
+
+	// Disallow copy and assignment.
+	BinaryReader(const BinaryReader& other) = delete;
+	BinaryReader& operator=(const BinaryReader& other) = delete;
+
+	/**
+	 * Reads exactly n bytes. Throws std::runtime_error on a short read.
+	 */
+	void read(void* data, std::size_t n);
+
+	/**
+	 * Reads a trivially copyable value from its raw bytes.
+	 */
+	template <typename T>
+	T get()
+	{
+		static_assert(std::is_trivially_copyable<T>::value,
+			"get() needs a trivially copyable type");
+		T value;
+		read(&value, sizeof(T));
+		return value;
+	}
+
+	/**
+	 * Gives the bytes read ahead but not consumed back to the stream, so it
+	 * reads on from just past the last byte consumed.
+	 */
+	void finish();
+private:
+	/**
+	 * Refills the buffer. Returns FALSE at end of stream.
+	 */
+	bool fill();
+
+	std::istream& _in;
+	std::vector<char> _buffer;
+	std::size_t _pos;
+	std::size_t _end;
+};
+
+/**
+* @struct Codec
+* Encodes one key or value. The generic Codec copies the raw bytes, so it
+* only accepts trivially copyable types; specialize it for anything else.
+*/
+template <typename T>
+struct Codec {
+	static_assert(std::is_trivially_copyable<T>::value,
+		"specialize csc::Codec for types that are not trivially copyable");
+
+	static void write(BinaryWriter& out, const T& value) { out.put(value); }
+	static T read(BinaryReader& in) { return in.get<T>(); }
+};
+
+/**
+* C++ string Codec: a 32-bit length, then the bytes.
+*/
+template <>
+struct Codec<std::string> {
+	// Longest run read before the string grows again.
+	static constexpr std::size_t STRING_CHUNK = 1 << 16;
+
+	static void write(BinaryWriter& out, const std::string& value);
+	static std::string read(BinaryReader& in);
+};
+
+/**
+* @enum DumpKind
+* What wrote a dump, and so whether its entry order means anything.
+*/
+enum class DumpKind : std::uint16_t {
+	HASH_MAP = 1,		// Table order.
+	CACHE_MANAGER = 2,	// LRU order: least recently used first.
+	TRACE = 3,			// Trace records, by thread, oldest first.
+	ACCESS_TRACE = 4,	// Key accesses to replay, oldest first.
+	BPLUS_TREE = 5		// Key order, ascending.
+};
+
+/**
+* @struct DumpHeader
+* The first bytes of every dump.
+*/
+struct DumpHeader {
+	std::uint32_t magic;
+	std::uint16_t version;
+	DumpKind kind;
+	std::uint64_t count;
+};
+
+constexpr std::uint32_t DUMP_MAGIC = 0x4d435343;	// "CSCM"
+constexpr std::uint32_t DUMP_END = 0x444e4543;		// "CEND"
+constexpr std::uint16_t DUMP_VERSION = 1;
+
+/**
+ * Writes a DumpHeader for count entries.
+ */
+void write_dump_header(BinaryWriter& out, DumpKind kind, std::uint64_t count);
+
+/**
+ * Reads and validates a DumpHeader. Throws std::runtime_error if the magic or
+ * the version is wrong.
+ */
+DumpHeader read_dump_header(BinaryReader& in);
+
+/**
+ * Writes the trailer of a dump of count entries.
+ */
+void write_dump_trailer(BinaryWriter& out, std::uint64_t count);
+
+/**
+
+
+ */
+void read_dump_trailer(BinaryReader& in, std::uint64_t count);
+}
@@ -0,0 +1,272 @@
+/**
+ * @file bplus-tree.h
+ * @class BPlusTree
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * An ordered map as a cache-conscious B+tree: nodes a whole number of cache
+ * lines, keys packed apart from values, and in-node search by SIMD compare
+ * and movemask for integral keys.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <type_traits>
+
+#include "binary-io.h"
+#include "thread-pool.h"
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct BulkLoadOptions
+* How BPlusTree::bulk_load() packs its nodes.
+*/
+struct BulkLoadOptions {
+	// Share of each node's slots to fill, in (0, 1]. 1 packs the nodes full
+	// for a read-mostly tree; lower leaves room for inserts before a split.
+	double fill = 1.0;
+	// Builds leaves and inner levels in parallel on pool if set and the
+	// input is random access.
+	ThreadPool *pool = nullptr;
+};
+
+/**
+* @class BPlusTree
+* Keys live in every node, values only in the leaves, and the leaves are
+* linked in key order for range scans. A node holds LINES cache lines of
+* keys (at least 4 keys), so a lookup touches a handful of lines per level
+* and the tree is shallow: 100M 64-bit keys fit in six levels at the
+* default 4 lines.
+*
+* Within a node, 32- and 64-bit integral keys are searched with AVX2 or SSE
+* compares, a vector of keys per instruction, when the build targets them
+* (see CSC_NATIVE in CMakeLists.txt), and by a branch-free scan otherwise.
+* Other keys are binary searched with Compare.
+*
+* Sorted input is better bulk loaded than inserted: insert() splits leaves
+* in half, so ascending inserts leave them half empty, where bulk_load()
+* packs them to BulkLoadOptions::fill and builds the inner levels over them
+* bottom-up, with no search.
+*
+* K and V must be default-constructible. Not thread-safe.
+*/
+template <typename K, typename V, typename Compare = std::less<K>,
+	std::size_t LINES = 4>
+class BPlusTree {
+public:
+	static constexpr std::size_t CACHE_LINE = 64;
+	// Keys per node: LINES cache lines of them.
+	static constexpr std::size_t NODE_KEYS =
+		LINES * CACHE_LINE / sizeof(K) < 4 ? 4 :
+		LINES * CACHE_LINE / sizeof(K);
+
+	/**
+	 * Constructor. An empty tree allocates nothing.
+	 */
+	BPlusTree();
+
+	/**
+	 * Destructor.
+	 */
+	~BPlusTree();
+
+	/*
+	 * Move constructor.
+	 */
+	BPlusTree(BPlusTree&& other) noexcept;
+
+	/**
+	 * Move assignment operator.
+	 */
+	BPlusTree& operator=(BPlusTree&& other) noexcept;
+
+	// Disallow copy and assignment.
+	BPlusTree(const BPlusTree& other) = delete;
+	BPlusTree& operator=(const BPlusTree& other) = delete;
+
+	/**
+	 * Inserts the key-value pair, or replaces the value if the key is
+	 * present.
+	 *
+	 * @return TRUE if the key was inserted; FALSE if it was replaced.
+	 */
+	bool insert(const K& key, const V& value);
+
+	/**
+	 * Replaces the contents with the pairs of [first, last), which must be
+	 * in strictly ascending key order. Each pair is read once and each node
+	 * written once, bottom-up; the leaves hold options.fill of their slots,
+	 * spread evenly so no node is left nearly empty.
+	 *
+	 * Throws std::invalid_argument, leaving the tree empty, if the keys are
+	 * out of order or repeat.
+	 *
+	 * @param It first, last A forward range of pairs, as with std::map.
+	 */
+	template <typename It>
+	void bulk_load(It first, It last,
+		const BulkLoadOptions& options = BulkLoadOptions());
+
+	/**
+	 * Writes the pairs in key order as a BPLUS_TREE dump.
+	 */
+	void dump(std::ostream& out) const;
+
+	/**
+	 * Replaces the contents with a BPLUS_TREE dump. Pairs are read straight
+	 * into leaves, which are added as the pairs arrive, so the dump is
+	 * never buffered and its count never sizes an allocation; the levels
+	 * above are built once the trailer checks out. Throws
+	 * std::runtime_error, leaving the tree empty, if the dump is malformed,
+	 * and std::invalid_argument if it is out of order.
+	 */
+	void load(std::istream& in,
+		const BulkLoadOptions& options = BulkLoadOptions());
+
+	/**
+	 * Returns a pointer to the value of key, or nullptr. The pointer is
+	 * valid until the next insert().
+	 */
+	V* find(const K& key);
+	const V* find(const K& key) const;
+
+	bool contains(const K& key) const;
+
+	/**
+	 * Calls fn on the key-value pairs with from <= key < to, in key order,
+	 * walking the leaf chain.
+	 *
+	 * @param Fn fn Callable as fn(const K& key, const V& value).
+	 *
+	 * @return std::size_t The number of pairs visited.
+	 */
+	template <typename Fn>
+	std::size_t scan(const K& from, const K& to, Fn fn) const;
+
+	/**
+	 * Calls fn on every key-value pair, in key order.
+	 *
+	 * @param Fn fn Callable as fn(const K& key, const V& value).
+	 */
+	template <typename Fn>
+	void for_each(Fn fn) const;
+
+	/**
+	 * Removes every pair and frees every node.
+	 */
+	void clear();
+
+	std::size_t size() const { return _size; }
+
+	bool empty() const { return _size == 0; }
+
+	/**
+	 * Returns the number of levels: 0 if empty, 1 for a lone leaf.
+	 */
+	std::size_t height() const { return _height; }
+
+	/**
+	 * Returns the bytes held by nodes, and the share of key slots in use.
+	 */
+	std::size_t bytes() const;
+	double fill() const;
+private:
+	// Nodes per parallel bulk load task: enough that a task is worth
+	// handing off.
+	static constexpr std::size_t BUILD_GRAIN = 1024;
+
+	struct alignas(CACHE_LINE) Leaf {
+		K keys[NODE_KEYS];
+		V values[NODE_KEYS];
+		Leaf *next = nullptr;
+		std::uint32_t count = 0;
+	};
+
+	struct alignas(CACHE_LINE) Inner {
+		K keys[NODE_KEYS];
+		// children[i] holds the keys below keys[i], and at or above
+		// keys[i - 1].
+		void *children[NODE_KEYS + 1];
+		std::uint32_t count = 0;
+	};
+
+	/**
+	 * Returns the number of keys[0..n) below key, or with INCLUSIVE at or
+	 * below it: the slot key goes in a leaf, or the child it is under.
+	 */
+	template <bool INCLUSIVE>
+	std::size_t rank(const K *keys, std::size_t n, const K& key) const;
+
+	/**
+	 * Returns the leaf key belongs in.
+	 */
+	Leaf* leaf_for(const K& key) const;
+
+	/**
+	 * Splits the full leaf, inserting key and value, and returns the new
+	 * right half and its first key through right and separator.
+	 */
+	void split_leaf(Leaf *leaf, std::size_t pos, const K& key, const V& value,
+		Leaf*& right, K& separator);
+
+	/**
+	 * Inserts separator and right child at pos of the inner node, splitting
+	 * it if full; a split returns the new right half and the key that moves
+	 * up through right and separator, else sets right to nullptr.
+	 */
+	void insert_inner(Inner *inner, std::size_t pos, void*& right,
+		K& separator);
+
+	/**
+	 * Bulk loads n pairs: fill_leaf(leaf, begin, end) writes pairs
+	 * [begin, end) to an empty leaf, on pool if parallel.
+	 */
+	template <typename FillLeaf>
+	void build(std::size_t n, const BulkLoadOptions& options, bool parallel,
+		FillLeaf fill_leaf);
+
+	/**
+	 * Links leaves, which hold n pairs in all, and builds the inner levels
+	 * over them, on pool if parallel. Takes the leaves: all are freed if
+	 * they turn out out of order.
+	 */
+	void build_levels(std::vector<Leaf*>& leaves, std::size_t n,
+		const BulkLoadOptions& options, bool parallel);
+
+	/**
+	 * Returns the pairs per bulk loaded leaf, or throws
+	 * std::invalid_argument if options.fill is out of range.
+	 */
+	static std::size_t leaf_pairs(const BulkLoadOptions& options);
+
+	/**
+	 * Throws std::invalid_argument unless keys[0..n) ascend strictly.
+	 */
+	void check_order(const K *keys, std::size_t n) const;
+
+	/**
+	 * Frees the subtree of node, level levels above the leaves.
+	 */
+	void destroy(void *node, std::size_t level);
+
+	void *_root;
+	Leaf *_first;
+	std::size_t _size;
+	std::size_t _height;
+	std::size_t _leaves;
+	std::size_t _inners;
+	Compare _less;
+};
+}
+#include "bplus-tree.tpp"
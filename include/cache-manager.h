@@ -1,23 +1,98 @@
 #pragma once
 
+#include "hash-map.h"
+#include "linked-list.h"
+#include "thread-pool.h"
+#include "binary-io.h"
+#include "spill-tier.h"
+#include "backing-store.h"
+#include "write-back.h"
+#include "negative-cache.h"
+#include "hot-keys.h"
+#include "near-cache.h"
+#include "version-table.h"
+#include "removal-listener.h"
+#include "maintenance.h"
+#include "memory-pressure.h"
+#include "shards.h"
+#include "cache-stats.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <istream>
+#include <list>
+#include <ostream>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
 
-template <typename K, typename V>
+/**
+* @struct ExpiryOptions
+* Time-to-live and refresh-ahead window for CacheManager entries.
+*/
+struct ExpiryOptions {
+	std::chrono::milliseconds ttl{0};	// 0 means entries never expire.
+	double refresh_ratio = 0.8;	// Reload once this much of the TTL is used.
+};
+
+/**
+* @enum CasResult
+* Outcome of CacheManager::cas(), as in memcached.
+*/
+enum class CasResult {
+	STORED,		// The version matched and the value was stored.
+	EXISTS,		// The entry changed since gets().
+	NOT_FOUND	// The entry is not cached.
+};
+}
+
+template <typename K, typename V, typename Stats = csc::CacheStats>
 class CacheManager {
 public:
+	/**
+	 * Fetches the value for a key from the backend on a miss. Returns TRUE and
+	 * sets value if found; FALSE if not.
+	 */
+	using Loader = std::function<bool(const K& key, V& value)>;
+
 	/** 
 	 * Return an instance of CacheManager.
 	 */
 	static CacheManager* instance();
 
+	/**
+	 * Destructor. Waits for background reloads, then stops the disk tier's
+	 * reads, since both write into the cache's members. A loader that never
+	 * returns blocks it.
+	 */
+	~CacheManager();
+
     /**
      * Retrieves the value associated with the key, and updates its position.
      *
      * @param key The key to lookup.
-     * @return The value associated with the key, or throws an exception if not found.
+     * @return A pointer to the value associated with the key, or nullptr if 
+     * not found.
      */
-    V get(const K& key);
+    V* get(const K& key);
 
     /**
      * Inserts or updates the key-value pair in the cache.
@@ -25,7 +100,331 @@ public:
      * @param key The key to insert/update.
      * @param value The value to associate with the key.
      */
-    void put(const K& key, const V& value);
+    void insert(const K& key, const V& value);
+
+    /**
+     * Calls fn on every cached key-value pair, in parallel. Point operations
+     * from other threads may run during the walk.
+     *
+     * @param fn Callable as fn(const K& key, const V& value).
+     */
+    template <typename Fn>
+    void for_each(Fn fn);
+
+    /**
+     * Invalidates every entry that pred returns TRUE for, spilled ones
+     * included. Matching entries are found in parallel without holding the
+     * cache lock; only the unlinking of the matches is serialized with point
+     * operations.
+     *
+     * @param pred Callable as pred(const K& key, const V& value).
+     * @return The number of entries invalidated.
+     */
+    template <typename Pred>
+    std::size_t erase_if(Pred pred);
+
+    /**
+     * Returns a copy of every entry that pred returns TRUE for, in parallel.
+     *
+     * @param pred Callable as pred(const K& key, const V& value).
+     * @return The matching key-value pairs.
+     */
+    template <typename Pred>
+    std::vector<std::pair<K, V>> collect(Pred pred);
+
+    /**
+     * Writes the cache to out in the binary dump format of binary-io.h, least
+     * recently used entry first. The entries are copied under the cache lock
+     * and written after it is released, so the dump is a consistent snapshot
+     * and serving is only paused for the copy, not for the I/O.
+     *
+     * @param out The stream to write to.
+     */
+    void dump(std::ostream& out);
+
+    /**
+     * Loads a dump written by dump() and restores its LRU order. If the dump
+     * holds more entries than the capacity, the least recently used ones are
+     * skipped. Entries already cached are kept unless the dump has the same
+     * key.
+     *
+     * @param in The stream to read from.
+     */
+    void load(std::istream& in);
+
+    /**
+     * Adds a disk tier below the cache. Evicted entries are spilled to it
+     * instead of dropped, and a miss in memory falls through to it; a hit on
+     * disk is promoted back into memory. Spills are appended under the cache
+     * lock, so an eviction that fills the tier's write buffer pays for the
+     * segment write.
+     *
+     * @param options Where and how the tier stores entries.
+     */
+    void enable_spill(const csc::SpillOptions& options);
+
+    /**
+     * Retrieves the value associated with the key without blocking on disk.
+     * A memory hit is returned ready. A miss is looked up in the spill tier
+     * on its I/O threads and promoted when the read completes.
+     *
+     * @param key The key to lookup.
+     * @return A future holding a copy of the value, or std::nullopt if the
+     * key is in neither tier.
+     */
+    std::future<std::optional<V>> get_async(const K& key);
+
+    /**
+     * Puts the cache in front of store in write-back mode. Puts only update
+     * memory and mark the key dirty; a background flusher writes the latest
+     * value of each dirty key to the store in batches. A dirty entry is
+     * flushed before it is evicted.
+     *
+     * @param store The store to write to; the cache takes ownership.
+     * @param options Batch size and flush interval.
+     */
+    void enable_write_back(std::unique_ptr<csc::BackingStore<K, V>> store,
+        const csc::WriteBackOptions& options = csc::WriteBackOptions());
+
+    /**
+     * Sets the loader that get() falls back to on a miss, after the spill
+     * tier. The loader runs without the cache lock.
+     *
+     * @param loader The backend lookup.
+     */
+    void set_loader(Loader loader);
+
+    /**
+     * Sets the TTL and refresh-ahead window. A get() on an expired entry is
+     * a miss. A get() on an entry past the refresh threshold but not yet
+     * expired returns the current value at once and schedules one reload
+     * through the loader on the shared ThreadPool; further gets of the key
+     * don't schedule another until it lands. The TTL counts from when a
+     * value entered memory, so an entry promoted from the spill tier starts
+     * a new one.
+     *
+     * @param options The TTL and refresh ratio.
+     */
+    void set_expiry(const csc::ExpiryOptions& options);
+
+    /**
+     * Adds a filter of keys the loader reported absent. A get() of such a
+     * key returns nullptr after one lookup in the concurrent table, without
+     * the cache lock or the backend. Inserting a key removes it from the
+     * filter. Like
+     * enable_spill(), call this before the cache is shared.
+     *
+     * @param options The filter's size and false positive rate.
+     */
+    void enable_negative_cache(const csc::NegativeCacheOptions& options);
+
+    /**
+     * Tracks the most read keys and replicates the hot ones into a small
+     * read-only table per thread. A get() of a replicated key is served from
+     * the calling thread's copy without the cache lock. Every change to an
+     * entry bumps its stripe in a VersionTable, which invalidates the copies
+     * on all threads. Like enable_spill(), call this before the cache is
+     * shared.
+     *
+     * @param options Tracker tuning and replica table size.
+     */
+    void enable_hot_keys(const csc::HotKeyOptions& options);
+
+    /**
+     * Returns up to k of the most read keys, hottest first, with their
+     * sampled counts; empty if hot-key tracking is not enabled.
+     */
+    std::vector<csc::HotKey<K>> hot_keys(std::size_t k);
+
+    /**
+     * Adds a small thread-local L1 cache of recent hits in front of the
+     * shared table, using the same per-thread copies and VersionTable checks
+     * as hot-key replication, but admitting every hit. A repeated get() on
+     * the same thread is then served without the cache lock until the entry
+     * changes or is evicted. The pointer get() returns from L1 stays valid
+     * until the thread's next get(). Like enable_spill(), call this before
+     * the cache is shared.
+     *
+     * @param slots Copies kept per thread, in two-way sets.
+     */
+    void enable_near_cache(std::size_t slots);
+
+    /*
+     * Atomic operations, memcached style. Each runs entirely under the cache
+     * lock, so no other operation sees it half done. Apart from gets(), they
+     * act on the entries in memory; they don't consult the spill tier or the
+     * loader. An entry past its TTL counts as not cached. Every store gives
+     * the entry a new 64-bit CAS version and goes through write-back like
+     * insert().
+     */
+
+    /**
+     * Retrieves the value associated with the key, with its CAS version.
+     *
+     * @return TRUE if found; FALSE if not.
+     */
+    bool gets(const K& key, V& value, std::uint64_t& cas);
+
+    /**
+     * Stores value only if the entry's CAS version is still cas.
+     */
+    csc::CasResult cas(const K& key, const V& value, std::uint64_t cas);
+
+    /**
+     * Stores the pair only if the key is not cached.
+     *
+     * @return TRUE if stored; FALSE if the key was already cached.
+     */
+    bool add(const K& key, const V& value);
+
+    /**
+     * Stores the pair only if the key is cached.
+     *
+     * @return TRUE if stored; FALSE if the key was not cached.
+     */
+    bool replace(const K& key, const V& value);
+
+    /**
+     * Adds delta to a cached counter.
+     *
+     * @return The new value, or std::nullopt if the key is not cached.
+     */
+    std::optional<V> incr(const K& key, V delta);
+
+    /**
+     * Subtracts delta from a cached counter; an unsigned counter stops at
+     * zero.
+     *
+     * @return The new value, or std::nullopt if the key is not cached.
+     */
+    std::optional<V> decr(const K& key, V delta);
+
+    /**
+     * Returns the cached value, or stores and returns fn(key) if there is
+     * none. fn runs under the cache lock and must not call back into the
+     * cache.
+     *
+     * @param fn Callable as V fn(const K& key).
+     */
+    template <typename Fn>
+    V compute_if_absent(const K& key, Fn fn);
+
+    /**
+     * Replaces the entry with fn's result: fn gets the current value, or
+     * nullptr if the key is not cached, and returns the new value, or
+     * std::nullopt to remove the entry. fn runs under the cache lock and
+     * must not call back into the cache.
+     *
+     * @param fn Callable as std::optional<V> fn(const K& key, const V* value).
+     * @return The new value, or std::nullopt if the entry was removed.
+     */
+    template <typename Fn>
+    std::optional<V> compute(const K& key, Fn fn);
+
+    /**
+     * Removes the key from memory and the spill tier. The backing store is
+     * not touched.
+     *
+     * @return TRUE if the key was cached; FALSE if not.
+     */
+    bool remove(const K& key);
+
+    /**
+     * Registers a listener for entries leaving the cache, with the cause.
+     * Listeners run on a dispatcher thread, in batches, never on the thread
+     * that removed the entry; the removal only copies the entry into a
+     * lock-free queue. When the queue is full, notifications are dropped and
+     * counted rather than slowing the cache down.
+     *
+     * @param listener Callable as listener(const K& key, const V& value,
+     * csc::RemovalCause cause).
+     * @param options Queue size and batch size; used by the first call only.
+     */
+    void add_removal_listener(
+        typename csc::RemovalDispatcher<K, V>::Listener listener,
+        const csc::RemovalOptions& options = csc::RemovalOptions());
+
+    /**
+     * Returns the number of removal notifications dropped on a full queue.
+     */
+    std::uint64_t dropped_removals();
+
+    /**
+     * Moves upkeep off the request path: a scheduler sweeps expired entries
+     * in bounded slices, oldest first, and compacts the spill tier now and
+     * then. It runs on its own thread, or, with options.own_thread unset,
+     * whenever the owner calls run_maintenance(). Its pace follows the
+     * write rate. Like enable_spill(), call this before the cache is
+     * shared. Calling it again replaces the scheduler and its options.
+     *
+     * @param options Slice length and pacing.
+     */
+    void enable_maintenance(
+        const csc::MaintenanceOptions& options = csc::MaintenanceOptions());
+
+    /**
+     * Runs one round of maintenance, for an owner-driven scheduler.
+     *
+     * @return How long to wait before the next round.
+     */
+    std::chrono::microseconds run_maintenance();
+
+    /**
+     * Changes the capacity. Shrinking evicts the excess, least recently used
+     * first, in batches that let other operations through.
+     *
+     * @param capacity The new maximum number of items.
+     */
+    void set_capacity(std::size_t capacity);
+
+    /**
+     * Returns the current capacity.
+     */
+    std::size_t capacity();
+
+    /**
+     * Steers the capacity by memory pressure, read from cgroup v2 or the
+     * process RSS as options say. The maintenance scheduler polls it, at
+     * most every options.interval and no faster than its own pace, and
+     * shrinks the cache in batched evictions as pressure rises, then grows
+     * it back, never past the capacity at the time of this call, as
+     * pressure falls. Starts maintenance with default options if it isn't
+     * running; a later enable_maintenance() keeps steering.
+     *
+     * @param options Where to read memory use, thresholds and pacing.
+     */
+    void enable_memory_pressure(const csc::MemoryPressureOptions& options);
+
+    /**
+     * Samples get() keys to estimate the miss ratio this workload would see
+     * at every cache size, for sizing the cache. A key outside the sample
+     * costs a hash and a compare. Like enable_spill(), call this before the
+     * cache is shared.
+     *
+     * @param options Sampling rate, memory bound and curve resolution.
+     */
+    void enable_mrc(const csc::MrcOptions& options = csc::MrcOptions());
+
+    /**
+     * Returns (cache size, estimated LRU miss ratio) pairs, or none if
+     * enable_mrc() wasn't called.
+     */
+    std::vector<std::pair<std::size_t, double>> miss_ratio_curve();
+
+    /**
+     * Returns the hit, miss, write, removal and load counters, and the
+     * get()/insert() latency histograms if enabled. Counting costs a relaxed
+     * add to a per-thread stripe; CacheManager<K, V, csc::NoStats> drops it
+     * at compile time.
+     */
+    csc::StatsSnapshot stats() const;
+
+    /**
+     * Records get() and insert() latency into log-linear histograms, at two
+     * clock reads per call. Like enable_spill(), call this before the cache
+     * is shared.
+     */
+    void enable_latency_histograms();
 
 protected:
     /**
@@ -36,20 +435,175 @@ protected:
 	CacheManager(std::size_t capacity);
 private:
 	static CacheManager *_instance;
-	std::size_t _capacity
+	std::size_t _capacity;
+	// Guards _map, _queue and _nodes together for point operations. Bulk
+	// operations
+	// rely on _map's own bucket locks instead.
+	std::mutex _mutex;
 	std::unique_ptr<csc::HashMap<K, V>> _map;
 	std::unique_ptr<csc::LinkedList<K>> _queue;
+	// Each queued key's node, so a relink is O(1) rather than a search.
+	std::unordered_map<K, const csc::DLLNode<K>*> _nodes;
+	// Optional disk tier for evicted entries; nullptr if not enabled.
+	std::unique_ptr<csc::SpillTier<K, V>> _spill;
+	// Optional write-back to a slower store; nullptr if not enabled. The
+	// flusher is declared after the store so it is destroyed first.
+	std::unique_ptr<csc::BackingStore<K, V>> _store;
+	std::unique_ptr<csc::WriteBack<K, V>> _write_back;
+	// Miss handling and expiry; the load time is kept only with a TTL set.
+	using Clock = std::chrono::steady_clock;
+	Loader _loader;
+	csc::ExpiryOptions _expiry;
+	// Load stamps in time order, for the expiry sweep. A new stamp moves
+	// the key's node to the back, so there is one per key.
+	using Stamps = std::list<std::pair<Clock::time_point, K>>;
+	Stamps _expiry_order;
+	// Each stamped key's node in _expiry_order.
+	std::unordered_map<K, typename Stamps::iterator> _loaded_at;
+	// Keys with a reload in flight; _refreshed is notified when it empties.
+	std::unordered_set<K> _refreshing;
+	std::condition_variable _refreshed;
+	// Keys the loader reported absent; nullptr if not enabled.
+	std::unique_ptr<csc::NegativeCache<K>> _absent;
+	// Hot-key tracking and per-thread replicas; nullptr if not enabled.
+	std::unique_ptr<csc::HotKeys<K>> _hot;
+	// Per-thread copies: 0 slots if disabled; every hit if _near_all, else
+	// only hot keys.
+	std::size_t _front_slots;
+	bool _near_all;
+	// Bumped, with _mutex held, on every change to an entry of the stripe.
+	csc::VersionTable _versions;
+	std::hash<K> _hasher;
+	// Tells this cache's per-thread replicas from another instance's.
+	std::uint64_t _id;
+	// The CAS version of each entry in memory.
+	std::unordered_map<K, std::uint64_t> _cas_ids;
+	std::uint64_t _next_cas;
+	// Delivers removal notifications; nullptr until a listener is added.
+	std::unique_ptr<csc::RemovalDispatcher<K, V>> _removals;
+	// Miss-ratio-curve sampler; nullptr if not enabled.
+	std::unique_ptr<csc::Shards<K>> _shards;
+	// Counters, or nothing with csc::NoStats.
+	Stats _stats;
+	static constexpr std::int64_t ENTRY_BYTES = sizeof(K) + sizeof(V);
+	// Capacity controller polled by maintenance; nullptr if not enabled.
+	std::shared_ptr<csc::MemoryPressure> _pressure;
+	// Declared last, so its thread stops before anything it touches goes.
+	// Shared, so run_maintenance() can run it without the cache lock.
+	std::shared_ptr<csc::Maintenance> _maintenance;
 
     /**
      * Removes the least recently used item from the cache.
      */
     void evict();
+
+    /**
+     * Stores the pair and marks it dirty for write-back. Called with _mutex
+     * held.
+     */
+    void write(const K& key, const V& value);
+
+    /**
+     * Inserts or updates the pair and stamps its load time, without marking
+     * it dirty. Called with _mutex held.
+     */
+    void place(const K& key, const V& value);
+
+    /**
+     * Evicts until the cache fits its capacity or the deadline passes.
+     *
+     * @return TRUE if over capacity still.
+     */
+    bool shrink(Clock::time_point deadline);
+
+    /**
+     * Moves the key to the front of the LRU queue, queueing it if it isn't.
+     * Called with _mutex held.
+     */
+    void touch(const K& key);
+
+    /**
+     * Takes the key off the LRU queue, if it is on it. Called with _mutex
+     * held.
+     */
+    void unqueue(const K& key);
+
+    /**
+     * Records the key's load time, if there is a TTL. Called with _mutex
+     * held.
+     */
+    void stamp(const K& key);
+
+    /**
+     * Removes an expired entry, flushing it first if dirty unless the
+     * caller already has. Called with _mutex held.
+     */
+    void expire(const K& key, bool flush = true);
+
+    /**
+     * Expiry task: removes expired entries, oldest first, until caught up or
+     * past the deadline. Dirty ones are flushed between lock holds.
+     *
+     * @return TRUE if expired entries are left.
+     */
+    bool sweep_expired(Clock::time_point deadline);
+
+    /**
+     * Checks whether the key's TTL has run out. Called with _mutex held.
+     */
+    bool expired(const K& key, Clock::time_point now) const;
+
+    /**
+     * Returns the key's value, or nullptr if it is not cached. An expired
+     * entry is dropped and reads as not cached. Called with _mutex held.
+     */
+    V* live(const K& key);
+
+    /**
+     * Checks whether the key is past its refresh threshold. Called with
+     * _mutex held.
+     */
+    bool due(const K& key, Clock::time_point now) const;
+
+    /**
+     * Schedules a background reload of the key unless one is in flight.
+     * Called with _mutex held.
+     */
+    void refresh(const K& key);
+
+    /**
+     * Invalidates every replica of the key. Called with _mutex held.
+     */
+    void invalidate(const K& key);
+
+    /**
+     * Notifies removal listeners and drops the key's replicas, load time and
+     * CAS version as it leaves memory. Called with _mutex held, before the
+     * entry is removed from the map.
+     */
+    void retire(const K& key, csc::RemovalCause cause);
+
+    /**
+     * Returns when a replica of the key must stop being served: at its
+     * refresh threshold or expiry, if there is a TTL. Called with _mutex
+     * held.
+     */
+    Clock::time_point deadline(const K& key) const;
+
+    /**
+     * Returns the calling thread's L1 and replica table for this cache.
+     */
+    csc::NearCache<K, V>& front();
+
+    /**
+     * Returns a process-unique CacheManager id.
+     */
+    static std::uint64_t next_id();
+
+	static constexpr std::size_t DEFAULT_CAPACITY = 1 << 10;
+	static constexpr std::size_t MAP_BUCKETS = 1 << 16;
+	static constexpr std::size_t SWEEP_BATCH = 64;
+	static constexpr std::size_t EVICT_BATCH = 64;
 };
 
-/**
- * void set(const K& key, const V& value);
- * void add(const K& key, const V& value);
- * void replace(const K& key, const V& value);
- * V get(const K& key);
- * V delete(const K& key);
- */
+#include "cache-manager.tpp"
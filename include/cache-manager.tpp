@@ -1,68 +1,999 @@
-template <typename K, typename V>
-CacheManager<K, V>* CacheManager::_instance = 0;
+template <typename K, typename V, typename Stats>
+CacheManager<K, V, Stats>* CacheManager<K, V, Stats>::_instance = 0;
 
-template <typename K, typename V>
-CacheManager<K, V>* CacheManager<K, V>::instance()
+template <typename K, typename V, typename Stats>
+CacheManager<K, V, Stats>* CacheManager<K, V, Stats>::instance()
 {
 	if (_instance == 0) {
-		_instance = new CacheManager;
+		_instance = new CacheManager(DEFAULT_CAPACITY);
 	}
 	return _instance;
 }
 
-template <typename K, typename V>
-CacheManager<K, V>::CacheManager(std::size_t capacity) :
+template <typename K, typename V, typename Stats>
+CacheManager<K, V, Stats>::CacheManager(std::size_t capacity) :
 	_capacity(capacity),
-	_map(std::make_unique<csc::HashMap<K, V>()),
-	_queue(std::make_unique<csc::LinkedList<K>()) 
+	// CacheManager is shared between threads, so its map is concurrent.
+	_map(std::make_unique<csc::HashMap<K, V>>(MAP_BUCKETS, true)),
+	_queue(std::make_unique<csc::LinkedList<K>>()),
+	_front_slots(0),
+	_near_all(false),
+	_id(next_id()),
+	_next_cas(0)
 {
 	// do nothing
 }
 
-template <typename K, typename V>
-V* CacheManager<K, V>::get(const K& key)
+template <typename K, typename V, typename Stats>
+CacheManager<K, V, Stats>::~CacheManager()
 {
-    if (!_map->contains(key)) {
-		// xxx handle cache misses
+	// Reloads run on the shared pool, which outlives the cache.
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_refreshed.wait(lock, [this]() { return _refreshing.empty(); });
+	}
+	if (_spill) {
+		_spill->close();
+	}
+}
+
+template <typename K, typename V, typename Stats>
+V* CacheManager<K, V, Stats>::get(const K& key)
+{
+	CSC_TRACE_SCOPE(CACHE_GET);
+	[[maybe_unused]] auto timer = _stats.time_get();
+	if (_shards) {
+		_shards->access(key);
+	}
+	// A known miss needs neither the lock nor the backend. A filter hit is
+	// confirmed against the concurrent map, since a colliding add() can
+	// mark a cached key again after its insert forgot it.
+	if (_absent && _absent->absent(key) && !_map->contains(key)) {
+		_stats.miss();
 		return nullptr;
-    }
-    // Get a pointer to the value.
-    V *v = _map->get(key);
-    // Move the accessed key to the front of the queue.
-    _queue->remove(key);
-    _queue->push_front(key);
-    return v;
+	}
+	std::size_t hash = _hasher(key);
+	// Served from this thread's copy while it is current.
+	if (_front_slots > 0) {
+		V *copy = front().get(key, hash, _versions);
+		if (copy != nullptr) {
+			if (_hot) {
+				_hot->record(key);
+			}
+			_stats.hit();
+			return copy;
+		}
+	}
+	Loader loader;
+	{
+		CSC_TRACE_BEGIN(waiting, LOCK_WAIT);
+		std::lock_guard<std::mutex> lock(_mutex);
+		CSC_TRACE_END(waiting);
+		if (_map->contains(key)) {
+			Clock::time_point now = Clock::now();
+			if (!expired(key, now)) {
+				// Get a pointer to the value.
+				V *v = _map->get(key);
+				// Move the accessed key to the front of the queue.
+				CSC_TRACE_BEGIN(relink, LRU_RELINK);
+				touch(key);
+				CSC_TRACE_END(relink);
+				bool hot = _hot && _hot->record(key);
+				if ((hot || _near_all) && _front_slots > 0) {
+					front().put(key, hash, *v,
+						_versions.current(_versions.stripe(hash)),
+						deadline(key));
+				}
+				// Serve the current value; reload it in the background.
+				if (due(key, now)) {
+					refresh(key);
+				}
+				_stats.hit();
+				return v;
+			}
+			// Expired: drop it and handle the lookup as a miss.
+			expire(key);
+		}
+		loader = _loader;
+	}
+	_stats.miss();
+	// The disk read and the load run without the cache lock.
+	V value;
+	if (!(_spill && _spill->take(key, value))) {
+		if (!loader) {
+			return nullptr;
+		}
+		auto started = _stats.start();
+		CSC_TRACE_BEGIN(loading, LOAD);
+		bool found = loader(key, value);
+		CSC_TRACE_END(loading);
+		_stats.loaded(found, started);
+		if (!found) {
+			if (_absent) {
+				// Unless it was inserted while the loader ran.
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (!_map->contains(key)) {
+					_absent->add(key);
+				}
+			}
+			return nullptr;
+		}
+	}
+	std::lock_guard<std::mutex> lock(_mutex);
+	// An insert that landed while the lock was released is newer than what
+	// was read or loaded, so it is served rather than overwritten.
+	V *resident = _map->get(key);
+	if (resident != nullptr && !expired(key, Clock::now())) {
+		return resident;
+	}
+	place(key, value);
+	return _map->get(key);
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::insert(const K& key, const V& value)
+{
+	CSC_TRACE_SCOPE(CACHE_INSERT);
+	[[maybe_unused]] auto timer = _stats.time_put();
+	CSC_TRACE_BEGIN(waiting, LOCK_WAIT);
+	std::lock_guard<std::mutex> lock(_mutex);
+	CSC_TRACE_END(waiting);
+	write(key, value);
 }
 
-template <typename K, typename V>
-void CacheManager<K, V>::insert(const K& key, const V& value)
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::write(const K& key, const V& value)
 {
+	// Called with _mutex held.
+	_stats.put();
+	place(key, value);
+	if (_write_back) {
+		_write_back->mark_dirty(key, value);
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::place(const K& key, const V& value)
+{
+	// Called with _mutex held.
+	invalidate(key);
+	// Forgotten before the map changes, so a lock-free absent() check never
+	// sees the key both cached and recorded absent.
+	if (_absent) {
+		_absent->forget(key);
+	}
     if (_map->contains(key)) {
+		if (_removals) {
+			_removals->notify(key, *_map->get(key),
+				csc::RemovalCause::REPLACED);
+		}
+		_stats.removed(csc::RemovalCause::REPLACED);
         // Update existing value.
         _map->replace(key, value);
         // Move the key to the front.
-        _queue->remove(key);
-        _queue->push_front(key);
+		CSC_TRACE_BEGIN(relink, LRU_RELINK);
+        touch(key);
+		CSC_TRACE_END(relink);
 	} else {
         if (_map->size() >= _capacity) {
             evict();
         }
         // Insert new key-value pair.
         _map->insert(key, value);
+		_stats.resident(ENTRY_BYTES);
         // Add the key to the front of the queue.
-        _queue->push_front(key);
+        touch(key);
     }
+	stamp(key);
+	_cas_ids[key] = ++_next_cas;
+	if (_maintenance) {
+		_maintenance->note_write();
+	}
 }
 
-template <typename K, typename V>
-void CacheManager<K, V>::evict()
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::evict()
 {
+	// Called with _mutex held.
+	CSC_TRACE_SCOPE(EVICT);
     if (!_queue->empty()) {
     	// Get the least recently used key (at the end of the queue).
     	K k = _queue->back();
+		// A dirty entry must reach the store before it leaves memory.
+		if (_write_back) {
+			_write_back->flush(k);
+		}
+		retire(k, csc::RemovalCause::SIZE);
+		// Keep it on disk rather than dropping it, if there is a disk tier.
+		// This stays under the cache lock, so a remove() or insert() of the
+		// key can't be overtaken by a stale spill. Most puts only append to
+		// the tier's buffer; one in buffer_bytes writes a batch out.
+		if (_spill) {
+			_spill->put(k, *_map->get(k));
+		}
     	// Remove it from the map and queue.
     	_map->remove(k);
-    	_queue->pop_back();
+    	unqueue(k);
 	}
 	// else, do nothing
 }
+
+template <typename K, typename V, typename Stats>
+template <typename Fn>
+void CacheManager<K, V, Stats>::for_each(Fn fn)
+{
+	_map->for_each(fn);
+}
+
+template <typename K, typename V, typename Stats>
+template <typename Pred>
+std::size_t CacheManager<K, V, Stats>::erase_if(Pred pred)
+{
+	// Scan without the cache lock; the map's bucket locks keep the scan safe.
+	std::vector<std::pair<K, V>> victims = _map->collect(pred);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	std::size_t erased = 0;
+	for (const auto& kv : victims) {
+		// The entry may have been replaced or evicted since the scan.
+		const V *v = _map->get(kv.first);
+		if (v == nullptr || !pred(kv.first, *v)) {
+			continue;
+		}
+		retire(kv.first, csc::RemovalCause::EXPLICIT);
+		_map->remove(kv.first);
+		unqueue(kv.first);
+		if (_spill) {
+			_spill->erase(kv.first);
+		}
+		++erased;
+	}
+	if (_spill) {
+		// Spilled entries are matched on their own; the tier reads each one
+		// back, so the cache lock is not held for that.
+		lock.unlock();
+		erased += _spill->erase_if(pred);
+	}
+	return erased;
+}
+
+template <typename K, typename V, typename Stats>
+template <typename Pred>
+std::vector<std::pair<K, V>> CacheManager<K, V, Stats>::collect(Pred pred)
+{
+	return _map->collect(pred);
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::dump(std::ostream& out)
+{
+	// Snapshot in MRU-to-LRU queue order.
+	std::vector<std::pair<K, V>> entries;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		entries.reserve(_queue->size());
+		for (const csc::DLLNode<K> *node = _queue->begin(); node != nullptr;
+			node = node->get_next()) {
+			const K& key = node->get_element();
+			entries.emplace_back(key, *_map->get(key));
+		}
+	}
+
+	csc::BinaryWriter writer(out);
+	csc::write_dump_header(writer, csc::DumpKind::CACHE_MANAGER, 
+		entries.size());
+	// LRU first, so load() can push each entry to the front in turn.
+	for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+		csc::Codec<K>::write(writer, it->first);
+		csc::Codec<V>::write(writer, it->second);
+	}
+	csc::write_dump_trailer(writer, entries.size());
+	writer.flush();
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::load(std::istream& in)
+{
+	csc::BinaryReader reader(in);
+	csc::DumpHeader header = csc::read_dump_header(reader);
+	if (header.kind != csc::DumpKind::CACHE_MANAGER) {
+		throw std::runtime_error("Not a CacheManager dump");
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	// Only the most recently used entries that fit are kept.
+	std::uint64_t skip = header.count > _capacity ? 
+		header.count - _capacity : 0;
+	_map->reserve(header.count - skip);
+	for (std::uint64_t n = 0; n < header.count; ++n) {
+		K key = csc::Codec<K>::read(reader);
+		V value = csc::Codec<V>::read(reader);
+		if (n < skip) {
+			continue;
+		}
+		invalidate(key);
+		if (_absent) {
+			_absent->forget(key);
+		}
+		if (_map->contains(key)) {
+			_map->replace(key, value);
+		} else {
+			if (_map->size() >= _capacity) {
+				evict();
+			}
+			_map->insert(key, value);
+			_stats.resident(ENTRY_BYTES);
+		}
+		touch(key);
+		stamp(key);
+		_cas_ids[key] = ++_next_cas;
+	}
+	csc::read_dump_trailer(reader, header.count);
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_spill(const csc::SpillOptions& options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_spill = std::make_unique<csc::SpillTier<K, V>>(options);
+}
+
+template <typename K, typename V, typename Stats>
+std::future<std::optional<V>> CacheManager<K, V, Stats>::get_async(const K& key)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_map->contains(key)) {
+			V value = *_map->get(key);
+			touch(key);
+			std::promise<std::optional<V>> ready;
+			ready.set_value(value);
+			return ready.get_future();
+		}
+	}
+	if (!_spill) {
+		std::promise<std::optional<V>> missed;
+		missed.set_value(std::nullopt);
+		return missed.get_future();
+	}
+	// Promote on the I/O thread once the read lands. The value is a clean
+	// copy, so it is placed, not inserted: nothing is written back.
+	return _spill->get_async(key, [this, key](std::optional<V>& value) {
+		if (value) {
+			_spill->erase(key);
+			std::lock_guard<std::mutex> lock(_mutex);
+			// An insert that landed during the read is newer.
+			V *resident = _map->get(key);
+			if (resident != nullptr) {
+				value = *resident;
+			} else {
+				place(key, *value);
+			}
+		}
+	});
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_write_back(
+	std::unique_ptr<csc::BackingStore<K, V>> store,
+	const csc::WriteBackOptions& options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_write_back.reset();
+	_store = std::move(store);
+	_write_back = std::make_unique<csc::WriteBack<K, V>>(*_store, options);
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::set_loader(Loader loader)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_loader = std::move(loader);
+	// What the old loader didn't find, the new one might.
+	if (_absent) {
+		_absent->clear();
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::set_expiry(const csc::ExpiryOptions& options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_expiry = options;
+	// Replica deadlines follow the TTL.
+	_versions.bump_all();
+	// Entries cached before a TTL was set count from now.
+	Clock::time_point now = Clock::now();
+	for (const csc::DLLNode<K> *node = _queue->begin(); node != nullptr;
+		node = node->get_next()) {
+		const K& key = node->get_element();
+		if (_loaded_at.find(key) == _loaded_at.end()) {
+			_loaded_at.emplace(key,
+				_expiry_order.emplace(_expiry_order.end(), now, key));
+		}
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_negative_cache(
+	const csc::NegativeCacheOptions& options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_absent = std::make_unique<csc::NegativeCache<K>>(options);
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::touch(const K& key)
+{
+	// Called with _mutex held.
+	auto it = _nodes.find(key);
+	if (it != _nodes.end()) {
+		_queue->move_to_front(it->second);
+	} else {
+		_nodes.emplace(key, _queue->push_front(key));
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::unqueue(const K& key)
+{
+	// Called with _mutex held.
+	auto it = _nodes.find(key);
+	if (it != _nodes.end()) {
+		_queue->erase(it->second);
+		_nodes.erase(it);
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::stamp(const K& key)
+{
+	// Called with _mutex held.
+	if (_expiry.ttl.count() > 0) {
+		Clock::time_point now = Clock::now();
+		auto it = _loaded_at.find(key);
+		if (it != _loaded_at.end()) {
+			// Relink rather than append, so no stale stamp is left behind.
+			_expiry_order.splice(_expiry_order.end(), _expiry_order,
+				it->second);
+			it->second->first = now;
+		} else {
+			_loaded_at.emplace(key,
+				_expiry_order.emplace(_expiry_order.end(), now, key));
+		}
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::expire(const K& key, bool flush)
+{
+	// Called with _mutex held.
+	if (flush && _write_back) {
+		_write_back->flush(key);
+	}
+	retire(key, csc::RemovalCause::EXPIRED);
+	_map->remove(key);
+	unqueue(key);
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::expired(const K& key,
+	Clock::time_point now) const
+{
+	// Called with _mutex held.
+	if (_expiry.ttl.count() <= 0) {
+		return false;
+	}
+	auto it = _loaded_at.find(key);
+	return it != _loaded_at.end() && now - it->second->first >= _expiry.ttl;
+}
+
+template <typename K, typename V, typename Stats>
+V* CacheManager<K, V, Stats>::live(const K& key)
+{
+	// Called with _mutex held.
+	V *v = _map->get(key);
+	if (v != nullptr && expired(key, Clock::now())) {
+		expire(key);
+		return nullptr;
+	}
+	return v;
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::due(const K& key, Clock::time_point now) const
+{
+	// Called with _mutex held.
+	if (_expiry.ttl.count() <= 0 || !_loader) {
+		return false;
+	}
+	auto it = _loaded_at.find(key);
+	return it != _loaded_at.end() &&
+		now - it->second->first >= _expiry.ttl * _expiry.refresh_ratio;
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::refresh(const K& key)
+{
+	// Called with _mutex held. One reload per key at a time.
+	if (!_refreshing.insert(key).second) {
+		return;
+	}
+	Loader loader = _loader;
+	// Every write gives the entry a new CAS id; the reload lands only if
+	// the id is the same afterwards.
+	auto it = _cas_ids.find(key);
+	std::uint64_t version = it != _cas_ids.end() ? it->second : 0;
+	csc::ThreadPool::shared().submit([this, key, loader, version]() {
+		V value;
+		bool loaded = false;
+		try {
+			loaded = loader(key, value);
+		} catch (...) {
+			// The entry is left as is and expires on schedule.
+		}
+		std::lock_guard<std::mutex> lock(_mutex);
+		// Don't bring back an entry that was evicted meanwhile, nor
+		// overwrite one written meanwhile.
+		auto it = _cas_ids.find(key);
+		if (loaded && _map->contains(key) && it != _cas_ids.end() &&
+			it->second == version) {
+			try {
+				place(key, value);
+			} catch (...) {
+				// do nothing
+			}
+		}
+		_refreshing.erase(key);
+		if (_refreshing.empty()) {
+			_refreshed.notify_all();
+		}
+	});
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_hot_keys(
+	const csc::HotKeyOptions& options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_front_slots = std::max(_front_slots, options.front_slots);
+	_hot = std::make_unique<csc::HotKeys<K>>(options);
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_near_cache(std::size_t slots)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_front_slots = std::max(_front_slots, slots);
+	_near_all = slots > 0;
+}
+
+template <typename K, typename V, typename Stats>
+std::vector<csc::HotKey<K>> CacheManager<K, V, Stats>::hot_keys(std::size_t k)
+{
+	if (!_hot) {
+		return std::vector<csc::HotKey<K>>();
+	}
+	return _hot->top(k);
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::invalidate(const K& key)
+{
+	// Called with _mutex held.
+	_versions.bump(_versions.stripe(_hasher(key)));
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::retire(const K& key, csc::RemovalCause cause)
+{
+	// Called with _mutex held, while the entry is still in the map.
+	if (_removals) {
+		const V *v = _map->get(key);
+		if (v != nullptr) {
+			_removals->notify(key, *v, cause);
+		}
+	}
+	_stats.removed(cause);
+	_stats.resident(-ENTRY_BYTES);
+	invalidate(key);
+	auto it = _loaded_at.find(key);
+	if (it != _loaded_at.end()) {
+		_expiry_order.erase(it->second);
+		_loaded_at.erase(it);
+	}
+	_cas_ids.erase(key);
+}
+
+template <typename K, typename V, typename Stats>
+typename CacheManager<K, V, Stats>::Clock::time_point
+CacheManager<K, V, Stats>::deadline(const K& key) const
+{
+	// Called with _mutex held.
+	auto it = _loaded_at.find(key);
+	if (_expiry.ttl.count() <= 0 || it == _loaded_at.end()) {
+		return Clock::time_point::max();
+	}
+	// Stop at the refresh threshold, so the shared path can schedule it.
+	auto life = _loader ? _expiry.ttl * _expiry.refresh_ratio :
+		std::chrono::duration<double, std::milli>(_expiry.ttl);
+	return it->second->first +
+		std::chrono::duration_cast<Clock::duration>(life);
+}
+
+template <typename K, typename V, typename Stats>
+csc::NearCache<K, V>& CacheManager<K, V, Stats>::front()
+{
+	// Rebuilt if the thread last used another CacheManager of this type.
+	struct Local {
+		std::uint64_t owner = 0;
+		std::unique_ptr<csc::NearCache<K, V>> cache;
+	};
+	static thread_local Local local;
+	if (local.owner != _id) {
+		local.cache = std::make_unique<csc::NearCache<K, V>>(_front_slots);
+		local.owner = _id;
+	}
+	return *local.cache;
+}
+
+template <typename K, typename V, typename Stats>
+std::uint64_t CacheManager<K, V, Stats>::next_id()
+{
+	static std::atomic<std::uint64_t> next(1);
+	return next.fetch_add(1);
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::gets(const K& key, V& value, std::uint64_t& cas)
+{
+	// Goes through get() so a miss is filled like any other read.
+	if (get(key) == nullptr) {
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(_mutex);
+	const V *v = _map->get(key);
+	if (v == nullptr) {
+		return false;
+	}
+	value = *v;
+	cas = _cas_ids[key];
+	return true;
+}
+
+template <typename K, typename V, typename Stats>
+csc::CasResult CacheManager<K, V, Stats>::cas(const K& key, const V& value,
+	std::uint64_t cas)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (live(key) == nullptr) {
+		return csc::CasResult::NOT_FOUND;
+	}
+	auto it = _cas_ids.find(key);
+	if (it == _cas_ids.end()) {
+		return csc::CasResult::NOT_FOUND;
+	}
+	if (it->second != cas) {
+		return csc::CasResult::EXISTS;
+	}
+	write(key, value);
+	return csc::CasResult::STORED;
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::add(const K& key, const V& value)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (live(key) != nullptr) {
+		return false;
+	}
+	write(key, value);
+	return true;
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::replace(const K& key, const V& value)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (live(key) == nullptr) {
+		return false;
+	}
+	write(key, value);
+	return true;
+}
+
+template <typename K, typename V, typename Stats>
+std::optional<V> CacheManager<K, V, Stats>::incr(const K& key, V delta)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const V *v = live(key);
+	if (v == nullptr) {
+		return std::nullopt;
+	}
+	V next = *v + delta;
+	write(key, next);
+	return next;
+}
+
+template <typename K, typename V, typename Stats>
+std::optional<V> CacheManager<K, V, Stats>::decr(const K& key, V delta)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const V *v = live(key);
+	if (v == nullptr) {
+		return std::nullopt;
+	}
+	// Like memcached, an unsigned counter stops at zero.
+	V next = (std::is_unsigned<V>::value && *v < delta) ? V(0) : *v - delta;
+	write(key, next);
+	return next;
+}
+
+template <typename K, typename V, typename Stats>
+template <typename Fn>
+V CacheManager<K, V, Stats>::compute_if_absent(const K& key, Fn fn)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	const V *v = live(key);
+	if (v != nullptr) {
+		return *v;
+	}
+	V value = fn(key);
+	write(key, value);
+	return value;
+}
+
+template <typename K, typename V, typename Stats>
+template <typename Fn>
+std::optional<V> CacheManager<K, V, Stats>::compute(const K& key, Fn fn)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::optional<V> next = fn(key, static_cast<const V*>(live(key)));
+	if (next) {
+		write(key, *next);
+	} else if (_map->contains(key)) {
+		retire(key, csc::RemovalCause::EXPLICIT);
+		_map->remove(key);
+		unqueue(key);
+	}
+	return next;
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::remove(const K& key)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	// A spilled copy must not come back after the delete.
+	bool found = _spill && _spill->erase(key);
+	if (_map->contains(key)) {
+		retire(key, csc::RemovalCause::EXPLICIT);
+		_map->remove(key);
+		unqueue(key);
+		found = true;
+	}
+	return found;
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::add_removal_listener(
+	typename csc::RemovalDispatcher<K, V>::Listener listener,
+	const csc::RemovalOptions& options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_removals) {
+		_removals = std::make_unique<csc::RemovalDispatcher<K, V>>(options);
+	}
+	_removals->add_listener(std::move(listener));
+}
+
+template <typename K, typename V, typename Stats>
+std::uint64_t CacheManager<K, V, Stats>::dropped_removals()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _removals ? _removals->dropped() : 0;
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_maintenance(
+	const csc::MaintenanceOptions& options)
+{
+	// Tasks take _mutex inside a run, so set up before taking it here.
+	auto maintenance = std::make_unique<csc::Maintenance>(options);
+	maintenance->add_task("expiry", [this](csc::Maintenance::Clock::time_point
+		deadline) {
+		return sweep_expired(deadline);
+	});
+	// Compaction rewrites whole segments, so it is not sliced; run it rarely.
+	maintenance->add_task("spill-reclaim", [this](
+		csc::Maintenance::Clock::time_point) {
+		if (_spill) {
+			_spill->reclaim();
+		}
+		return false;
+	}, std::chrono::milliseconds(1000));
+	// Idle until enable_memory_pressure(). Polls every interval; finishes a
+	// shrink on the runs between.
+	maintenance->add_task("memory-pressure", [this,
+		last = Clock::time_point()](Clock::time_point deadline) mutable {
+		std::shared_ptr<csc::MemoryPressure> controller;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			controller = _pressure;
+		}
+		if (!controller) {
+			return false;
+		}
+		Clock::time_point now = Clock::now();
+		if (now - last >= controller->options().interval) {
+			last = now;
+			// Reads cgroup or proc files, so not under the lock.
+			double usage = controller->usage();
+			std::lock_guard<std::mutex> lock(_mutex);
+			_capacity = controller->adjust(_capacity, usage);
+		}
+		return shrink(deadline);
+	});
+	std::shared_ptr<csc::Maintenance> old;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		old = std::move(_maintenance);
+		_maintenance = std::move(maintenance);
+	}
+	// Stopped without the lock: its thread may be waiting for it.
+	old.reset();
+}
+
+template <typename K, typename V, typename Stats>
+std::chrono::microseconds CacheManager<K, V, Stats>::run_maintenance()
+{
+	std::shared_ptr<csc::Maintenance> maintenance;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		maintenance = _maintenance;
+	}
+	if (!maintenance) {
+		return std::chrono::microseconds::max();
+	}
+	return maintenance->run_once();
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::sweep_expired(Clock::time_point deadline)
+{
+	std::vector<std::pair<Clock::time_point, K>> batch;
+	for (;;) {
+		batch.clear();
+		bool caught_up = false;
+		{
+			// Short lock holds, so user operations interleave.
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_expiry.ttl.count() <= 0) {
+				_loaded_at.clear();
+				_expiry_order.clear();
+				return false;
+			}
+			Clock::time_point now = Clock::now();
+			// Oldest first; the rest of the list is younger. The stamps stay
+			// linked until their entries expire below.
+			auto next = _expiry_order.begin();
+			while (batch.size() < SWEEP_BATCH) {
+				if (next == _expiry_order.end() ||
+					now - next->first < _expiry.ttl) {
+					caught_up = true;
+					break;
+				}
+				batch.push_back(*next++);
+			}
+		}
+		// Dirty entries go to the store without the cache lock. They stay
+		// cached meanwhile, so a read can't miss and load a stale value.
+		if (_write_back) {
+			for (const auto& next : batch) {
+				_write_back->flush(next.second);
+			}
+		}
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (const auto& next : batch) {
+				// A store during the flush queued a new stamp; any later
+				// write would have, so what is left here is clean.
+				auto it = _loaded_at.find(next.second);
+				if (it == _loaded_at.end() ||
+					it->second->first != next.first) {
+					continue;
+				}
+				expire(next.second, false);
+			}
+		}
+		if (caught_up) {
+			return false;
+		}
+		if (Clock::now() >= deadline) {
+			return true;
+		}
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::set_capacity(std::size_t capacity)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_capacity = std::max<std::size_t>(capacity, 1);
+	}
+	shrink(Clock::time_point::max());
+}
+
+template <typename K, typename V, typename Stats>
+std::size_t CacheManager<K, V, Stats>::capacity()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _capacity;
+}
+
+template <typename K, typename V, typename Stats>
+bool CacheManager<K, V, Stats>::shrink(Clock::time_point deadline)
+{
+	for (;;) {
+		{
+			// Evict in batches, so user operations interleave.
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (std::size_t n = 0; n < EVICT_BATCH; ++n) {
+				if (_map->size() <= _capacity || _queue->empty()) {
+					return false;
+				}
+				evict();
+			}
+		}
+		if (Clock::now() >= deadline) {
+			return true;
+		}
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_memory_pressure(
+	const csc::MemoryPressureOptions& options)
+{
+	bool started;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_pressure = std::make_shared<csc::MemoryPressure>(options,
+			_capacity);
+		started = static_cast<bool>(_maintenance);
+	}
+	// Every scheduler has the task; it picks up _pressure on its next run.
+	if (!started) {
+		enable_maintenance();
+	}
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_mrc(const csc::MrcOptions& options)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_shards = std::make_unique<csc::Shards<K>>(options);
+}
+
+template <typename K, typename V, typename Stats>
+std::vector<std::pair<std::size_t, double>>
+CacheManager<K, V, Stats>::miss_ratio_curve()
+{
+	if (!_shards) {
+		return {};
+	}
+	return _shards->curve();
+}
+
+template <typename K, typename V, typename Stats>
+csc::StatsSnapshot CacheManager<K, V, Stats>::stats() const
+{
+	return _stats.snapshot();
+}
+
+template <typename K, typename V, typename Stats>
+void CacheManager<K, V, Stats>::enable_latency_histograms()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_stats.enable_latency();
+}
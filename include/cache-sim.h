@@ -0,0 +1,228 @@
+/**
+ * @file cache-sim.h
+ * @class AccessTrace, SimPolicy
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Key-access traces and the replacement policies cache-sim replays them
+ * against, next to CacheManager's own LRU.
+ *
+ * A trace is plain text, one access per line as `key [size]`, or binary: a
+ * dump (see binary-io.h) of kind ACCESS_TRACE whose entries are a 64-bit
+ * key and a 32-bit size in bytes. Text keys that aren't decimal numbers
+ * are hashed; blank lines and lines starting with '#' are skipped; size
+ * defaults to 1.
+ */
+
+#pragma once
+
+#include "mapped-region.h"
+#include "cache-manager.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct Access
+* One access of a trace.
+*/
+struct Access {
+	std::uint64_t key;
+	std::uint32_t size;
+};
+
+/**
+* @class AccessTrace
+* A trace file, memory-mapped read-only. Any number of cursors can read it
+* at once, each from the start, without copying it into memory.
+*/
+class AccessTrace {
+public:
+	/**
+	 * Maps the trace at path, binary if it starts with a dump header and
+	 * text otherwise. Throws std::system_error if it can't be mapped,
+	 * std::runtime_error if a binary trace is truncated.
+	 */
+	static AccessTrace open(const std::string& path);
+
+	/**
+	 * Writes the text trace at text to binary as a binary trace, and
+	 * returns the number of accesses.
+	 */
+	static std::uint64_t convert(const std::string& text,
+		const std::string& binary);
+
+	/**
+	* @class Cursor
+	* Reads a trace from the start.
+	*/
+	class Cursor {
+	public:
+		/**
+		 * Reads the next access into access; FALSE at the end.
+		 */
+		bool next(Access& access);
+	private:
+		friend class AccessTrace;
+
+		Cursor(const char *begin, const char *end, bool binary) :
+			_pos(begin), _end(end), _binary(binary) {}
+
+		const char *_pos;
+		const char *_end;
+		bool _binary;
+	};
+
+	Cursor cursor() const;
+
+	bool binary() const { return _binary; }
+private:
+	AccessTrace(MappedRegion region, bool binary, std::size_t skip,
+		std::size_t length);
+
+	MappedRegion _region;
+	bool _binary;
+	const char *_begin;
+	const char *_end;
+};
+
+/**
+* @class SimPolicy
+* A replacement policy over a number of entries, as the simulator sees it:
+* access() looks a key up, admits it on a miss, and reports a hit.
+*/
+class SimPolicy {
+public:
+	virtual ~SimPolicy() = default;
+
+	/**
+	 * Accesses the index-th access of the trace; TRUE on a hit.
+	 */
+	virtual bool access(const Access& access, std::uint64_t index) = 0;
+};
+
+/**
+* @class CachePolicy
+* CacheManager's own LRU as a SimPolicy. Its constructor is protected; it is
+* a singleton.
+*/
+class CachePolicy : public SimPolicy,
+	private CacheManager<std::uint64_t, std::uint32_t> {
+public:
+	explicit CachePolicy(std::size_t capacity) : CacheManager(capacity) {}
+
+	bool access(const Access& access, std::uint64_t index) override;
+};
+
+/**
+* @class FifoPolicy
+* Evicts in insertion order; a hit changes nothing.
+*/
+class FifoPolicy : public SimPolicy {
+public:
+	explicit FifoPolicy(std::size_t capacity) : _capacity(capacity) {}
+
+	bool access(const Access& access, std::uint64_t index) override;
+private:
+	std::size_t _capacity;
+	std::deque<std::uint64_t> _queue;
+	std::unordered_set<std::uint64_t> _keys;
+};
+
+/**
+* @class ClockPolicy
+* Second chance: a hit sets a reference bit, and the hand clears bits until
+* it finds an entry without one to evict. LRU-like at FIFO's cost per hit.
+*/
+class ClockPolicy : public SimPolicy {
+public:
+	explicit ClockPolicy(std::size_t capacity) : _capacity(capacity),
+		_hand(0) {}
+
+	bool access(const Access& access, std::uint64_t index) override;
+private:
+	struct Slot {
+		std::uint64_t key;
+		bool referenced;
+	};
+
+	std::size_t _capacity;
+	std::vector<Slot> _slots;
+	std::unordered_map<std::uint64_t, std::size_t> _index;
+	std::size_t _hand;
+};
+
+/**
+* @class OptPolicy
+* Belady's optimal policy: evicts the entry used again furthest in the
+* future. Not implementable in a real cache, but the upper bound on hit
+* ratio for a size. Reads the whole trace up front and holds 8 bytes per
+* access, which policies for several sizes can share.
+*/
+class OptPolicy : public SimPolicy {
+public:
+	// For each access, the index of the next access to the same key; NEVER
+	// if there is none. Read-only, so any number of policies can share it.
+	using NextUses = std::shared_ptr<const std::vector<std::uint64_t>>;
+
+	/**
+	 * Reads the trace once for the next uses.
+	 */
+	static NextUses next_uses(const AccessTrace& trace);
+
+	OptPolicy(const AccessTrace& trace, std::size_t capacity);
+	OptPolicy(NextUses next, std::size_t capacity);
+
+	bool access(const Access& access, std::uint64_t index) override;
+private:
+	std::size_t _capacity;
+	NextUses _next;
+	// Cached keys by their next use, furthest last.
+	std::set<std::pair<std::uint64_t, std::uint64_t>> _order;
+	std::unordered_map<std::uint64_t, std::uint64_t> _cached;
+
+	static constexpr std::uint64_t NEVER = ~std::uint64_t(0);
+};
+
+/**
+* @struct SimResult
+* The outcome of replaying a trace against one policy and size.
+*/
+struct SimResult {
+	std::string policy;
+	std::size_t capacity = 0;
+	std::uint64_t accesses = 0;
+	std::uint64_t hits = 0;
+	std::uint64_t bytes = 0;
+	std::uint64_t hit_bytes = 0;
+	double seconds = 0;
+
+	double hit_ratio() const;
+	double byte_hit_ratio() const;
+	double accesses_per_sec() const;
+};
+
+/**
+ * Replays trace against policy and returns what it hit; name and capacity
+ * only label the result.
+ */
+SimResult simulate(const AccessTrace& trace, SimPolicy& policy,
+	const std::string& name, std::size_t capacity);
+}
@@ -0,0 +1,248 @@
+/**
+ * @file cache-stats.h
+ * @class CacheStats
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Hit, miss, removal and load counters for CacheManager, with optional
+ * latency histograms, and a NoStats policy that compiles them out.
+ */
+
+#pragma once
+
+#include "removal-listener.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct HistogramSnapshot
+* Bucket counts of a LatencyHistogram at one point in time.
+*/
+struct HistogramSnapshot {
+	std::vector<std::uint64_t> counts;	// Empty if latency isn't recorded.
+	std::uint64_t count = 0;
+
+	/**
+	 * Returns the value, in nanoseconds, at or below which the fraction p
+	 * of the recorded values fall, to the histogram's precision; 0 if
+	 * nothing was recorded.
+	 */
+	std::uint64_t percentile(double p) const;
+
+	/**
+	 * Returns the mean in nanoseconds, from bucket midpoints.
+	 */
+	double mean() const;
+};
+
+/**
+* @class LatencyHistogram
+* Log-linear histogram of nanosecond durations, as in HDR Histogram: each
+* power of two is split into 2^SUB_BITS equal buckets, so a value lands in a
+* bucket within 1/16 of it, from 1 ns up to the full 64-bit range, in under
+* a thousand buckets. Recording is a bucket index and one relaxed add to
+* the calling thread's stripe.
+*/
+class LatencyHistogram {
+public:
+	/**
+	 * Constructor.
+	 */
+	LatencyHistogram();
+
+	// Disallow copy and assignment.
+	LatencyHistogram(const LatencyHistogram& other) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram& other) = delete;
+
+	/**
+	 * Records one duration.
+	 */
+	void record(std::uint64_t ns);
+
+	/**
+	 * Sums the stripes.
+	 */
+	HistogramSnapshot snapshot() const;
+
+	/**
+	 * Maps a value to its bucket, and a bucket to its lowest and highest
+	 * values.
+	 */
+	static std::size_t bucket(std::uint64_t ns);
+	static std::uint64_t lowest(std::size_t bucket);
+	static std::uint64_t highest(std::size_t bucket);
+
+	static constexpr std::size_t SUB_BITS = 4;
+	static constexpr std::size_t BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+	static constexpr std::size_t STRIPES = 8;
+private:
+	struct alignas(64) Stripe {
+		std::array<std::atomic<std::uint64_t>, BUCKETS> counts{};
+	};
+
+	std::unique_ptr<Stripe[]> _stripes;
+};
+
+/**
+* @class StatsCounter
+* A counter split over cache-line-padded stripes, one per group of threads,
+* so threads counting at once don't contend on one line. add() is one
+* relaxed add; sum() reads every stripe.
+*/
+class StatsCounter {
+public:
+	/**
+	 * Adds n, which may be negative for a gauge.
+	 */
+	void add(std::int64_t n = 1);
+
+	/**
+	 * Returns the total over the stripes.
+	 */
+	std::int64_t sum() const;
+
+	/**
+	 * Returns the calling thread's stripe, assigned on first use.
+	 */
+	static std::size_t stripe();
+
+	static constexpr std::size_t STRIPES = 16;
+private:
+	struct alignas(64) Slot {
+		std::atomic<std::int64_t> value{0};
+	};
+
+	std::array<Slot, STRIPES> _slots;
+};
+
+/**
+* @struct StatsSnapshot
+* Counters of a CacheManager at one point in time. Stripes are read one by
+* one, so counts taken while operations run may be off by those in flight.
+*/
+struct StatsSnapshot {
+	std::uint64_t hits = 0;
+	std::uint64_t misses = 0;
+	std::uint64_t puts = 0;				// insert() and the other writes.
+	// Entries that left memory, indexed by RemovalCause.
+	std::array<std::uint64_t, 4> removals{};
+	std::uint64_t loads = 0;			// Loader calls that found the key.
+	std::uint64_t load_failures = 0;	// Loader calls that didn't.
+	std::chrono::nanoseconds load_time{0};	// Spent in the loader.
+	// Entries held times sizeof(K) + sizeof(V); heap data isn't counted.
+	std::int64_t bytes = 0;
+	HistogramSnapshot get_latency;
+	HistogramSnapshot put_latency;
+
+	/**
+	 * Returns hits / (hits + misses), or 0 before any lookup.
+	 */
+	double hit_ratio() const;
+
+	/**
+	 * Returns the removals for one cause.
+	 */
+	std::uint64_t removed(RemovalCause cause) const;
+};
+
+/**
+* @class CacheStats
+* The default statistics policy of CacheManager. Counters are always on;
+* latency histograms cost two clock reads per operation and are off until
+* enable_latency().
+*/
+class CacheStats {
+public:
+	/**
+	 * Records the latency of one operation into a histogram when it goes
+	 * out of scope; does nothing if latency is off.
+	 */
+	class Timer {
+	public:
+		explicit Timer(LatencyHistogram *histogram);
+		~Timer();
+		Timer(const Timer& other) = delete;
+		Timer& operator=(const Timer& other) = delete;
+	private:
+		LatencyHistogram *_histogram;
+		std::chrono::steady_clock::time_point _start;
+	};
+
+	static constexpr bool ENABLED = true;
+
+	void hit();
+	void miss();
+	void put();
+	void removed(RemovalCause cause);
+	void resident(std::int64_t bytes);
+
+	/**
+	 * Returns a start time for loaded().
+	 */
+	std::chrono::steady_clock::time_point start() const;
+
+	/**
+	 * Records one loader call begun at start.
+	 */
+	void loaded(bool found, std::chrono::steady_clock::time_point start);
+
+	/**
+	 * Turns on the latency histograms. Call before the cache is shared.
+	 */
+	void enable_latency();
+
+	Timer time_get();
+	Timer time_put();
+
+	StatsSnapshot snapshot() const;
+private:
+	StatsCounter _hits;
+	StatsCounter _misses;
+	StatsCounter _puts;
+	std::array<StatsCounter, 4> _removals;
+	StatsCounter _loads;
+	StatsCounter _load_failures;
+	StatsCounter _load_ns;
+	StatsCounter _bytes;
+	std::unique_ptr<LatencyHistogram> _get_latency;
+	std::unique_ptr<LatencyHistogram> _put_latency;
+};
+
+/**
+* @class NoStats
+* Statistics policy that records nothing. Every call is an empty inline
+* function, so a CacheManager<K, V, NoStats> has no counting code at all.
+*/
+class NoStats {
+public:
+	struct Timer {};
+
+	static constexpr bool ENABLED = false;
+
+	void hit() {}
+	void miss() {}
+	void put() {}
+	void removed(RemovalCause) {}
+	void resident(std::int64_t) {}
+	std::chrono::steady_clock::time_point start() const { return {}; }
+	void loaded(bool, std::chrono::steady_clock::time_point) {}
+	void enable_latency() {}
+	Timer time_get() { return {}; }
+	Timer time_put() { return {}; }
+	StatsSnapshot snapshot() const { return {}; }
+};
+}
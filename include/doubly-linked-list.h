@@ -27,45 +27,27 @@ namespace csc {
 template <typename T>
 class DLLNode {
 public:
-	Node(const T& element) : 
+	DLLNode(const T& element) : 
 		_element(element), _next(nullptr), _prev(nullptr) {}
-	Node(const T& element, DLLNode* next, DLLNode* prev) : 
+	DLLNode(const T& element, DLLNode* next, DLLNode* prev) : 
 		_element(element), _next(next), _prev(prev) {}
-	~Node() {}
+	~DLLNode() {}
 
-	T get_element() const { return _element; }
+	const T& get_element() const { return _element; }
 	DLLNode* get_next() const { return _next; }
 	DLLNode* get_prev() const { return _prev; }
 
 	void set_element(T element) { _element = element; }
-	void set_next(Node* next) { _next = next; }
-	void set_prev(Node* prev) { _prev = prev; }
+	void set_next(DLLNode* next) { _next = next; }
+	void set_prev(DLLNode* prev) { _prev = prev; }
 private:
 	T _element;
 	DLLNode* _next;
 	DLLNode* _prev;
 };
 
-template <typename T>
-class DLLIterator : public csc::Iterator<T> {
-public:
-	DLLIterator& operator++();
-	DLLIterator operator++(int);
-	T& operator*() const;
-	void add(const T& element);
-	void delete();
-protected:
-	/**
-	* new and delete are protected so heap allocation is disallowed. Must be 
-	* allocated on the stack, for RAII.
-	*/
-	explicit DLLIterator(DLLNode<T> node) : _node(node) {}
-private:
-	DLLNode<T> *_node;
-};
-
 /**
-* @class DoublyDoublyLinkedList
+* @class DoublyLinkedList
 * DoublyLinkedList, specialized as a Queue to be used for keeping track of order 
 * in LRU CacheManager.
 */
@@ -80,7 +62,7 @@ public:
 	/** 
 	 * Destructor.
 	 */
-	~DoublyLinkedList() { clear(); }
+	~DoublyLinkedList();
 
 	/**
 	 * Copy constructor.
@@ -102,71 +84,88 @@ public:
 	 */
 	DoublyLinkedList<T>& operator=(DoublyLinkedList<T>&& rhs) noexcept;
 
-	friend class DLLIterator<T>;
-
 	/**
-	 * Overloaded ostream operator, '<<'.
-	 */
-	friend ostream& operator<<(ostream& out, const DoublyLinkedList& dll) const;
-
- 	/**
-	 * Overloaded istream operator, '>>'.
-	 */
-	friend istream& operator>>(istream& in, DoublyLinkedList& dll) const;
-
-	/**
-	 * Returns the first element of DoublyLinkedList.
+	 * Returns the first element of DoublyLinkedList. Throws an exception if 
+	 * the list is empty.
 	 *
 	 * @return T element The first element.
 	 */
-	T* front() const;
+	T front() const;
 
 	/**
-	 * Returns the last element of DoublyLinkedList.
+	 * Returns the last element of DoublyLinkedList. Throws an exception if 
+	 * the list is empty.
 	 *
 	 * @return T element The last element.
 	 */
-	T* back() const;
+	T back() const;
 
 	/**
-	 * Returns the first element of DoublyLinkedList and deletes it from the 
-	 * list.
+	 * Adds a new node at the beginning of the list.
 	 *
-	 * @return T element The first element.
+	 * @param T element The element to be inserted.
+	 *
+	 * @return const DLLNode<T>* node The new node, for move_to_front() and
+	 * erase().
 	 */
-	T* pop_front();
+	const DLLNode<T>* push_front(T element);
 
 	/**
-	 * Adds a new node at the beginning of the list.
+	 * Adds a new node at the end of the list.
 	 *
-	 * @param int element
-	 * The element to be inserted.
+	 * @param T element The element to be inserted.
 	 */
-	void push_front(const T& element);
+	void push_back(T element);
+
+	/**
+	 * Returns and removes the element at the front of the list. Throws an 
+	 * exception if the list is empty.
+	 */
+	T pop_front();
 
 	/**
 	 * Returns and removes the element at the back of the list. Throws an 
 	 * exception if the list is empty.
 	 */
-	T* pop_back();
+	T pop_back();
 
 	/**
-	 * Inserts an element after the DLLNode.
+	 * Inserts an element at the index, from 0 to size().
 	 *
 	 * @param T element The element to be inserted.
-	 * @param DLLNode<T> node The node to insert after.
+	 * @param int index The index it will have.
 	 */
-	void insert(const T& element, DLLNode<T>* node);	
+	bool insert(T element, int index);	
 
 	/**
-	 * Searches for a node with a specific elementue and deletes it from the list.
+	 * Searches for a node with a specific element and deletes it from the 
+	 * list. Throws an exception if the list is empty.
 	 *
-	 * @param int element
-	 * The element to be deleted.
+	 * @param T element The element to be deleted.
 	 *
 	 * @return TRUE if deleted, FALSE if not deleted
 	 */
-	bool remove(const T& element);
+	bool remove(T element);
+
+	/**
+	 * Moves a node of this list to the front, in O(1).
+	 *
+	 * @param const DLLNode<T>* node The node.
+	 */
+	void move_to_front(const DLLNode<T>* node);
+
+	/**
+	 * Deletes a node of this list, in O(1).
+	 *
+	 * @param const DLLNode<T>* node The node.
+	 */
+	void erase(const DLLNode<T>* node);
+
+	/**
+	 * Returns the element at the index. Throws an exception if the index is
+	 * out of range.
+	 */
+	T get(int index) const;
 
 	/**
 	 * Checks if DoublyLinkedList contains an element.
@@ -176,18 +175,27 @@ public:
 	 * @return TRUE if the list contains the element; FALSE if the list does not
 	 * contain the element.
 	 */
-	bool contains(const T& element) const;
+	bool contains(T element) const;
 
 	/**
-	 * Finds an element and returns an Iterator to it, or nullptr if the element 
-	 * was not found.
+	 * Finds an element and returns its node, or nullptr if the element was
+	 * not found. Throws an exception if the list is empty.
 	 *
 	 * @param T element The element to find.
 	 *
-	 * @return STTIterator<T> iterator An iterator pointing to the element, or 
-	 * nullptr if not found.
+	 * @return const DLLNode<T>* node The element's node, or nullptr.
+	 */
+	const DLLNode<T>* find(T element) const;
+
+	/**
+	 * Prints the list to stdout.
 	 */
-	DLLIterator<T> find(const T& element);
+	void print() const;
+
+	/**
+	* Clears all DoublyLinkedList's Nodes and deallocates their memory.
+	*/
+	void clear();
  	
 	/**
 	* Returns the size of DoublyLinkedList.
@@ -204,20 +212,19 @@ public:
 	bool empty() const;
 
 	/** 
-	 * Returns an Iterator pointing to the beginning (first element) of 
-	 * DoublyLinkedList.
+	 * Returns the first node of DoublyLinkedList, or nullptr if empty. Walk
+	 * the list with get_next().
 	 *
-	 * @return DLLIterator iterator An Iterator pointing to begin.
+	 * @return const DLLNode<T>* node The head.
 	 */
-	DLLIterator<T> begin() const;
+	const DLLNode<T>* begin() const;
 
 	/** 
-	 * Returns an Iterator pointing to the end (last element) of 
-	 * DoublyLinkedList.
+	 * Returns the last node of DoublyLinkedList, or nullptr if empty.
 	 *
-	 * @return DLLIterator iterator An Iterator pointing to end.
+	 * @return const DLLNode<T>* node The tail.
 	 */
-	DLLIterator<T> end() const;
+	const DLLNode<T>* end() const;
 private:
 	void copy_calling_list_empty(const DoublyLinkedList<T>& other);
 	void copy_lists_same_length(const DoublyLinkedList<T>& other);
@@ -225,19 +232,18 @@ private:
 	void copy_calling_list_shorter(const DoublyLinkedList<T>& other);
 
 	/**
-	* Searches for an element and returns the Node before it. The element's node
-	* can be accessed by get_next().
+	* Throws an exception unless 0 <= index <= size().
 	*/
-	DLLNode<T>* search(const T& element);
+	void index_out_of_range(int index) const;
 
 	/**
-	* Clears all SinglyLinkedList's Nodes and deallocates their memory.
+	* Unlinks the node and deallocates it.
 	*/
-	void clear();
+	void unlink(DLLNode<T>* node);
 
 	DLLNode<T>* _head;
 	DLLNode<T>* _tail;
-	std::size_t _size;
+	std::size_t _count;
 };
 }
 #include "doubly-linked-list.tpp"
@@ -12,10 +12,19 @@
 #pragma once
 
 #include "singly-linked-list.h"
+#include "thread-pool.h"
+#include "binary-io.h"
+#include "trace.h"
 
+#include <atomic>
 #include <cstddef>
+#include <istream>
+#include <ostream>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 /**
 * @namespace csc
@@ -23,6 +32,14 @@
 */
 namespace csc {
 
+/**
+* Generic Hash function, over the key's bytes.
+*/
+template <typename K>
+struct Hash {
+	std::size_t operator()(const K& key) const;
+};
+
 /**
 * C-String Hash function.
 */
@@ -39,14 +56,6 @@ struct Hash<std::string> {
 	std::size_t operator()(const std::string& str) const;
 };
 
-/**
-* Generic Hash function.
-*/
-template <typename K>
-struct Hash<K> {
-	std::size_t operator()(const K& key) const;
-};
-
 /**
  * @class HashNode
  * HashNode is a key-value pair for HashMap.
@@ -54,18 +63,21 @@ struct Hash<K> {
 template <typename K, typename V>
 class HashNode {
 public:
-	HashNode(const K& key) : _key(key), _value(nullptr) {}
+	HashNode(const K& key) : _key(key), _value() {}
 	HashNode(const K& key, const V& value) : _key(key), _value(value) {}
-	K get_key() const { return _key; }
-	V get_value() const { return _value; }
+	const K& get_key() const { return _key; }
+	const V& get_value() const { return _value; }
+	V& get_value() { return _value; }
 	void set_value(const V& value) { _value = value; }
-protected:
-    // Disallow copy and assignment.
-    HashNode(const HashNode& other);
-    HashNode& operator=(const HashNode& other);
+
+	/**
+	 * HashNodes are equal by key, so a bucket is searched with a HashNode
+	 * holding only the key.
+	 */
+	bool operator==(const HashNode& other) const { return _key == other._key; }
+	bool operator!=(const HashNode& other) const { return !(*this == other); }
 private:
-	const std::size_t _hash;
-	const K _key;
+	K _key;
 	V _value;
 };
 
@@ -73,7 +85,7 @@ private:
 * @class HashMap
 * Chained HashMap.
 */
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F = Hash<K>>
 class HashMap {
 public:
     /**
@@ -81,7 +93,7 @@ public:
 	 * ListPtr is a pointer to a SinglyLinkedList of HashNodes. HashMap has
 	 * exclusive ownership of any ListPtrs.
      */
-    typedef std::unique_ptr<DoublyLinkedList<HashNode<K, V>>> ListPtr;
+    typedef std::unique_ptr<SinglyLinkedList<HashNode<K, V>>> ListPtr;
 
 	/**
 	 * Default constructor.
@@ -93,10 +105,20 @@ public:
 	 */
 	HashMap(std::size_t buckets);
 
+	/**
+	 * Overloaded constructor for a concurrent HashMap. A concurrent HashMap
+	 * guards its buckets with striped locks, so point operations and bulk
+	 * operations may run from several threads at once.
+	 *
+	 * @param std::size_t buckets The number of table buckets.
+	 * @param bool concurrent TRUE to guard the buckets with locks.
+	 */
+	HashMap(std::size_t buckets, bool concurrent);
+
 	/** 
 	 * Destructor.
 	 */
-	~HashMap() { clear(); }
+	~HashMap();
 
 	/**
 	 * Copy constructor.
@@ -106,7 +128,7 @@ public:
 	/*
 	 * Move constructor.
 	 */
-	HashMap(HashMap&& src);
+	HashMap(HashMap&& src) noexcept;
 
 	/**
 	 * Assignment operator.
@@ -116,20 +138,60 @@ public:
 	/**
 	 * Move assignment operator.
 	 */
-	HashMap& operator=(HashMap&& rhs);
+	HashMap& operator=(HashMap&& rhs) noexcept;
 
 	/**
-	 * Overloaded ostream operator, '<<'.
+	 * Overloaded ostream operator, '<<'. Writes a binary dump; see dump().
 	 */
-	friend ostream& operator<<(ostream& out, const SinglyLinkedList& sll) const;
+	friend std::ostream& operator<<(std::ostream& out, const HashMap& map)
+	{
+		map.dump(out);
+		return out;
+	}
 
  	/**
-	 * Overloaded istream operator, '>>'.
+	 * Overloaded istream operator, '>>'. Reads a binary dump; see load().
+	 */
+	friend std::istream& operator>>(std::istream& in, HashMap& map)
+	{
+		map.load(in);
+		return in;
+	}
+
+	/**
+	 * Writes every key-value pair to out in the binary dump format of 
+	 * binary-io.h. Keys and values are encoded by csc::Codec. The table is
+	 * walked in place, so no other thread may write to HashMap meanwhile.
+	 *
+	 * @param std::ostream out The stream to write to.
+	 */
+	void dump(std::ostream& out) const;
+
+	/**
+	 * Replaces the contents of HashMap with a binary dump read from in. The
+	 * table is sized from the entry count in the header up to MAX_RESERVE,
+	 * and doubles past that as entries arrive. Leaves in just past the
+	 * dump. No other thread may use HashMap
+	 * meanwhile. Throws std::runtime_error if in does not hold a HashMap
+	 * dump, or ends early.
+	 *
+	 * @param std::istream in The stream to read from.
+	 */
+	void load(std::istream& in);
+
+	/**
+	 * Grows an empty HashMap's table for count entries, to a power of two
+	 * buckets at a load factor of at most one. Never shrinks the table, and
+	 * sizes for at most MAX_RESERVE entries, since count may come from an
+	 * untrusted dump. Does nothing if HashMap is not empty.
+	 *
+	 * @param std::size_t count The expected number of entries.
 	 */
-	friend istream& operator>>(istream& in, SinglyLinkedList& sll) const;
+	void reserve(std::size_t count);
 
 	/**
-	 * Associates the specified value with the specified key in this map.
+	 * Associates the specified value with the specified key in this map,
+	 * replacing the value if the key is present.
 	 *
 	 * @param int key
 	 * The key to be inserted.
@@ -163,14 +225,9 @@ public:
 	bool remove(const K& key, const V& value);
 
 	/**
-	 * Gets the value (a copy) associated with the key.
-	 *
-	 * @param K key The key to get the value.
-	 */
-	V get(const K& key) const;
-
-	/**
-	 * Gets a pointer (a reference) to the value associated with the key.
+	 * Gets a pointer (a reference) to the value associated with the key, or
+	 * nullptr if the key is not present. The pointer is valid until the key
+	 * is removed.
 	 *
 	 * @param K key The key to get the value.
 	 */
@@ -189,8 +246,10 @@ public:
 	 *
 	 * @param K key The key to replace the mapped value.
 	 * @param V value The new value.
+	 *
+	 * @return TRUE if replaced; FALSE if the key is not present.
 	 */
-	void replace(const K& key, const V& value);
+	bool replace(const K& key, const V& value);
 
 	/**
 	* Returns the size of HashMap.
@@ -205,18 +264,86 @@ public:
 	* @return TRUE if empty; FALSE if not empty.
 	*/
 	bool empty() const;
-private:
+
+	/**
+	 * Calls fn on every key-value pair. The table is split into ranges of
+	 * buckets that are walked in parallel on pool, so fn may be called from
+	 * several threads at once. On a concurrent HashMap each bucket is locked
+	 * while it is walked; fn must not call back into HashMap.
+	 *
+	 * @param Fn fn Callable as fn(const K& key, const V& value).
+	 * @param ThreadPool pool The pool to run on.
+	 */
+	template <typename Fn>
+	void for_each(Fn fn, ThreadPool& pool = ThreadPool::shared()) const;
+
+	/**
+	 * Removes every key-value pair that pred returns TRUE for. Runs in 
+	 * parallel like for_each().
+	 *
+	 * @param Pred pred Callable as pred(const K& key, const V& value).
+	 * @param ThreadPool pool The pool to run on.
+	 *
+	 * @return std::size_t The number of pairs removed.
+	 */
+	template <typename Pred>
+	std::size_t erase_if(Pred pred, ThreadPool& pool = ThreadPool::shared());
+
+	/**
+	 * Returns a copy of every key-value pair that pred returns TRUE for. Runs 
+	 * in parallel like for_each(); each bucket is copied atomically, the 
+	 * table as a whole is not.
+	 *
+	 * @param Pred pred Callable as pred(const K& key, const V& value).
+	 * @param ThreadPool pool The pool to run on.
+	 *
+	 * @return std::vector<std::pair<K, V>> The matching pairs.
+	 */
+	template <typename Pred>
+	std::vector<std::pair<K, V>> collect(Pred pred, 
+		ThreadPool& pool = ThreadPool::shared()) const;
+
 	/**
-	 * Clears the contents and deallocates memory of HashMap.
+	 * Removes every key-value pair. The table keeps its buckets.
 	 */
 	void clear();
+private:
+	/**
+	 * Returns the bucket of key.
+	 */
+	std::size_t bucket(const K& key) const;
+
+	/**
+	 * Locks the stripe guarding a bucket. Returns an empty lock if HashMap is 
+	 * not concurrent.
+	 */
+	std::unique_lock<std::mutex> lock_bucket(std::size_t bucket) const;
+
+	/**
+	 * Moves every entry into a new table of buckets buckets. Not
+	 * thread-safe; load() uses it to grow past MAX_RESERVE.
+	 */
+	void rehash(std::size_t buckets);
+
+	/**
+	 * Number of buckets per bulk operation range: at most BULK_GRAIN, so a 
+	 * range of the table stays in L1 while it is walked, and small enough 
+	 * to give each worker in pool several ranges to balance over.
+	 */
+	std::size_t bulk_grain(const ThreadPool& pool) const;
 
-	constexpr std::size_t TABLE_BUCKETS = 16;	// Power of two for DJR % 2^k.
+	static constexpr std::size_t TABLE_BUCKETS = 16;	// Power of two for DJR % 2^k.
+	static constexpr std::size_t LOCK_STRIPES = 64;	// Locks for concurrent mode.
+	static constexpr std::size_t BULK_GRAIN = 1024;	// Buckets per bulk range.
+	static constexpr std::size_t MAX_RESERVE = 1 << 22;	// Cap for reserve().
 
 	std::size_t _buckets;		
-	ListPtr[] _table;
-	std::size_t _size;
+	ListPtr *_table;
+	std::atomic<std::size_t> _size;
 	F _hash;
+	// Striped bucket locks; bucket i is guarded by _locks[i % LOCK_STRIPES].
+	// nullptr unless HashMap is concurrent.
+	std::unique_ptr<std::mutex[]> _locks;
 };
 }
 #include "hash-map.tpp"
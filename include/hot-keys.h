@@ -0,0 +1,111 @@
+/**
+ * @file hot-keys.h
+ * @class HotKeys
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Approximate top-K tracking of the most frequently read keys.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct HotKeyOptions
+* Tuning for HotKeys and the per-thread replicas of hot entries.
+*/
+struct HotKeyOptions {
+	std::size_t capacity = 64;			// Counters kept; bounds the top-K.
+	std::uint32_t sample_every = 16;	// Count one in this many reads.
+	double threshold = 0.01;			// Share of samples that makes a key hot.
+	std::uint64_t window = 1 << 16;		// Samples between count halvings.
+	std::size_t front_slots = 64;		// Replica slots per thread.
+};
+
+/**
+* @struct HotKey
+* One tracked key. The key's true count lies in [count - error, count].
+*/
+template <typename K>
+struct HotKey {
+	K key;
+	std::uint64_t count;
+	std::uint64_t error;
+};
+
+/**
+* @class HotKeys
+* The Space-Saving algorithm over a sample of reads: capacity counters kept
+* in a min-heap, where an untracked key takes over the smallest counter and
+* inherits its count as error. Counts are halved every window samples so
+* the list follows the current workload.
+*
+* record() is meant for the read path. It samples, and it uses try_lock,
+* so a busy tracker drops the sample rather than making the reader wait.
+*/
+template <typename K>
+class HotKeys {
+public:
+	/**
+	 * Constructor.
+	 */
+	explicit HotKeys(const HotKeyOptions& options = HotKeyOptions());
+
+	/**
+	 * Counts a read of the key, if it is sampled.
+	 *
+	 * @return TRUE if the read was sampled and the key is hot; FALSE if not.
+	 */
+	bool record(const K& key);
+
+	/**
+	 * Returns up to k tracked keys, hottest first.
+	 */
+	std::vector<HotKey<K>> top(std::size_t k);
+
+	/**
+	 * Returns the number of samples in the current window.
+	 */
+	std::uint64_t samples();
+
+	static constexpr std::uint64_t MIN_HOT_COUNT = 8;
+private:
+	/**
+	 * Counts one sample. Called with _mutex held.
+	 *
+	 * @return TRUE if the key is hot.
+	 */
+	bool count(const K& key);
+
+	/**
+	 * Restores the heap below/above index i. Called with _mutex held.
+	 */
+	void sift_down(std::size_t i);
+	void sift_up(std::size_t i);
+
+	/**
+	 * Swaps two heap slots and their positions. Called with _mutex held.
+	 */
+	void swap(std::size_t a, std::size_t b);
+
+	HotKeyOptions _options;
+	std::mutex _mutex;
+	std::vector<HotKey<K>> _heap;
+	std::unordered_map<K, std::size_t> _pos;
+	std::uint64_t _samples;
+};
+}
+#include "hot-keys.tpp"
@@ -0,0 +1,28 @@
+/**
+ * @file linked-list.h
+ * @class LinkedList
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2024-08-30
+ *
+ * LinkedList, the list CacheManager keeps its LRU order in.
+ */
+
+#pragma once
+
+#include "doubly-linked-list.h"
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @typedef LinkedList
+* The LRU queue is a DoublyLinkedList: most recently used at the front.
+*/
+template <typename T>
+using LinkedList = DoublyLinkedList<T>;
+}
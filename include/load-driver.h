@@ -0,0 +1,142 @@
+/**
+ * @file load-driver.h
+ * @class LoadDriver
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Multi-threaded closed- and open-loop load against a cache, with latency
+ * histograms and per-thread fairness.
+ */
+
+#pragma once
+
+#include "cache-stats.h"
+#include "util.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct LoadOptions
+* Threads, pacing and the operations to run.
+*/
+struct LoadOptions {
+	std::size_t threads = 1;
+	bool pin = true;				// Pin thread i to core i (Linux).
+	// Stop after duration, or after ops operations per thread if ops > 0.
+	std::chrono::milliseconds duration{5000};
+	std::uint64_t ops = 0;
+	// Operations per second over all threads; 0 runs closed-loop, each
+	// thread issuing its next operation as soon as the last returns.
+	double rate = 0;
+	// Thread i seeds with seed + i, and inserts every threads-th new key
+	// from the i-th.
+	util::WorkloadOptions workload;
+	std::size_t batch = 4096;		// Closed-loop: operations per refill.
+};
+
+/**
+* @struct ThreadLoad
+* What one thread did.
+*/
+struct ThreadLoad {
+	std::uint64_t ops = 0;
+	double seconds = 0;
+	HistogramSnapshot latency;
+};
+
+/**
+* @struct LoadReport
+* What all threads did together.
+*/
+struct LoadReport {
+	std::uint64_t ops = 0;
+	double seconds = 0;				// Wall time, release to last stop.
+	double ops_per_sec = 0;
+	// Jain's index of per-thread throughput: 1 if every thread got the
+	// same share, 1/threads if one thread got it all.
+	double fairness = 1;
+	HistogramSnapshot latency;		// Merged over threads.
+	std::vector<ThreadLoad> threads;
+
+	/**
+	 * Prints the report as text, or as one JSON object.
+	 */
+	void print(std::ostream& out) const;
+	void json(std::ostream& out) const;
+};
+
+/**
+* @class LoadDriver
+* Runs a workload from several threads against an executor that applies
+* one operation to the cache under test. Operations are generated outside
+* the timed region: closed-loop in batches between calls, open-loop all of
+* a thread's schedule before its clock starts (up to MAX_SCHEDULE
+* operations, replayed from the start if the run needs more). Threads wait
+* at a barrier until every one has built its generator and schedule, and
+* all clocks, the report's included, start at its release.
+*
+* Closed-loop, latency is each call's own duration. Open-loop, operation i
+* of a thread is due at start + i / rate, and latency runs from when it was
+* due, not from when it was sent: a stall then shows up in every operation
+* queued behind it, instead of hiding them (coordinated omission).
+*/
+class LoadDriver {
+public:
+	using Executor = std::function<void(const util::Op& op)>;
+
+	explicit LoadDriver(const LoadOptions& options);
+
+	/**
+	 * Runs the load and returns the report. The executor is called from
+	 * every thread at once.
+	 */
+	LoadReport run(const Executor& executor);
+private:
+	/**
+	 * @struct Barrier
+	 * Holds the threads until all have arrived, then records the release.
+	 */
+	struct Barrier {
+		std::mutex mutex;
+		std::condition_variable released;
+		std::size_t waiting = 0;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	/**
+	 * One thread's share of run().
+	 */
+	ThreadLoad drive(std::size_t index, const Executor& executor,
+		Barrier& barrier);
+
+	/**
+	 * Waits at barrier for every thread. Returns the release time.
+	 */
+	std::chrono::steady_clock::time_point arrive(Barrier& barrier) const;
+
+	// Most operations an open-loop thread generates ahead: 64 MiB of Ops.
+	static constexpr std::size_t MAX_SCHEDULE = std::size_t(1) << 22;
+
+	/**
+	 * Pins the calling thread to a core; does nothing off Linux.
+	 */
+	static void pin(std::size_t core);
+
+	LoadOptions _options;
+};
+}
@@ -0,0 +1,142 @@
+/**
+ * @file maintenance.h
+ * @class Maintenance
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Background upkeep for a cache, run in bounded time slices off the request
+ * path.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct MaintenanceOptions
+* Pacing for a Maintenance scheduler.
+*/
+struct MaintenanceOptions {
+	bool own_thread = true;		// FALSE: the caller drives run_once().
+	std::chrono::microseconds slice{500};		// Time budget per task per run.
+	std::chrono::microseconds min_interval{1000};	// Fastest pace.
+	std::chrono::microseconds max_interval{100000};	// Idle pace.
+	std::uint64_t writes_per_run = 1024;	// Target writes between runs.
+};
+
+/**
+* @class Maintenance
+* Runs a list of upkeep tasks, each given a deadline for its slice of work.
+* A task does what it can before the deadline and reports whether work is
+* left. The pause between runs follows the write rate, which is what
+* creates upkeep: it aims for writes_per_run writes between runs, between
+* min_interval and max_interval, and drops to min_interval while any task
+* has a backlog.
+*
+* With own_thread the scheduler runs itself. Otherwise the owner calls
+* run_once() from its own executor, waiting the returned delay in between.
+*/
+class Maintenance {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Does up to a slice of work.
+	 *
+	 * @param Clock::time_point deadline When to stop.
+	 * @return TRUE if work is left; FALSE if caught up.
+	 */
+	using Task = std::function<bool(Clock::time_point deadline)>;
+
+	/**
+	 * Constructor. Starts the thread if options.own_thread is set.
+	 */
+	explicit Maintenance(const MaintenanceOptions& options =
+		MaintenanceOptions());
+
+	/**
+	 * Destructor. Stops the thread; a task in progress finishes its slice.
+	 */
+	~Maintenance();
+
+	// Disallow copy and assignment.
+	Maintenance(const Maintenance& other) = delete;
+	Maintenance& operator=(const Maintenance& other) = delete;
+
+	/**
+	 * Adds a task.
+	 *
+	 * @param std::string name For diagnostics.
+	 * @param Task task The work.
+	 * @param std::chrono::milliseconds every Minimum time between runs of
+	 * this task; zero runs it every time.
+	 */
+	void add_task(const std::string& name, Task task,
+		std::chrono::milliseconds every = std::chrono::milliseconds(0));
+
+	/**
+	 * Counts a write, for pacing. O(1).
+	 */
+	void note_write();
+
+	/**
+	 * Runs every due task once.
+	 *
+	 * @return How long to wait before the next run.
+	 */
+	std::chrono::microseconds run_once();
+
+	/**
+	 * Returns the number of completed runs.
+	 */
+	std::uint64_t runs() const;
+
+	/**
+	 * Returns the pause chosen after the last run.
+	 */
+	std::chrono::microseconds interval() const;
+private:
+	struct Entry {
+		std::string name;
+		Task task;
+		std::chrono::milliseconds every;
+		Clock::time_point last;
+	};
+
+	/**
+	 * Scheduler loop.
+	 */
+	void run();
+
+	MaintenanceOptions _options;
+	std::atomic<std::uint64_t> _writes;
+	std::atomic<std::uint64_t> _runs;
+	std::atomic<std::int64_t> _interval_us;
+	// Guards _tasks and _last_run; a run holds it throughout.
+	std::mutex _run_mutex;
+	std::vector<Entry> _tasks;
+	Clock::time_point _last_run;
+	std::uint64_t _last_writes;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	bool _stop;
+	std::thread _thread;
+};
+}
@@ -0,0 +1,323 @@
+/**
+ * @file mapped-cache.h
+ * @class MappedCache
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * LRU cache whose whole arena lives in a memory-mapped file, for warm
+ * restarts, or in POSIX shared memory, for sharing between processes.
+ */
+
+#pragma once
+
+#include "mapped-region.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include <pthread.h>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class MappedCache
+* Chained hash table plus LRU queue, laid out in a file-backed mapping as a
+* header, a bucket array and a slot array. Every link is a slot index rather
+* than a pointer, so the arena means the same thing wherever it is mapped.
+*
+* Reopening a file that was closed cleanly and whose header checksum and
+* layout match serves the previous run's entries at once; nothing is read or
+* rebuilt. Any other file, including one left by a crash, is reformatted.
+*
+* In shared memory mode every process on the host that opens the same name
+* maps the same arena. Operations are serialized by a robust, process-shared
+* mutex in the header. If a process dies while it holds the mutex in the
+* middle of a change, the next process to lock it finds the table possibly
+* half-updated and empties it; a crash costs hit ratio, never consistency.
+*
+* Keys and values are stored as raw bytes, so both must be trivially
+* copyable, and K needs operator==. Mapped values must not hold pointers
+* when shared. All operations are thread- and process-safe.
+*/
+template <typename K, typename V>
+class MappedCache {
+	static_assert(std::is_trivially_copyable<K>::value,
+		"MappedCache keys must be trivially copyable");
+	static_assert(std::is_trivially_copyable<V>::value,
+		"MappedCache values must be trivially copyable");
+public:
+	/**
+	 * @enum Backing
+	 * Where the arena lives.
+	 */
+	enum class Backing {
+		FILE,			// A file, reused across restarts.
+		SHARED_MEMORY	// A POSIX shared memory object, shared by processes.
+	};
+
+	/**
+	 * Maps the arena. A FILE arena restores its entries if the file holds a
+	 * cleanly closed cache of the same capacity and layout. A SHARED_MEMORY
+	 * arena attaches to the object if another process has already created it;
+	 * it throws std::runtime_error if that object's layout doesn't match.
+	 *
+	 * @param std::string path The cache file, or the shared memory object
+	 * name (e.g. "/cache").
+	 * @param std::size_t capacity The maximum number of entries.
+	 * @param Backing backing Where the arena lives.
+	 */
+	MappedCache(const std::string& path, std::size_t capacity,
+		Backing backing = Backing::FILE);
+
+	/**
+	 * Destructor. Closes a cache file cleanly so the next run can reuse it.
+	 * A shared memory arena is only unmapped; it lives on until unlinked.
+	 */
+	~MappedCache();
+
+	// Disallow copy and assignment.
+	MappedCache(const MappedCache& other) = delete;
+	MappedCache& operator=(const MappedCache& other) = delete;
+
+	/**
+	 * Returns the file size needed for capacity entries.
+	 *
+	 * @param std::size_t capacity The maximum number of entries.
+	 */
+	static std::size_t region_size(std::size_t capacity);
+
+	/**
+	 * Removes a shared memory arena once its last process unmaps it.
+	 *
+	 * @param std::string name The shared memory object name.
+	 */
+	static void unlink_shared(const std::string& name);
+
+	/**
+	 * Copies the value associated with the key into value, and moves the key
+	 * to the front of the LRU queue.
+	 *
+	 * @param K key The key to lookup.
+	 * @param V value Receives the value.
+	 *
+	 * @return TRUE if the key was found; FALSE if not.
+	 */
+	bool get(const K& key, V& value);
+
+	/**
+	 * Inserts or updates the key-value pair, evicting the least recently used
+	 * entry if the cache is full.
+	 *
+	 * @param K key The key to insert/update.
+	 * @param V value The value to associate with the key.
+	 */
+	void put(const K& key, const V& value);
+
+	/**
+	 * Removes the key.
+	 *
+	 * @param K key The key to remove.
+	 *
+	 * @return TRUE if the key was removed; FALSE if not found.
+	 */
+	bool remove(const K& key);
+
+	/**
+	 * Checks whether the cache contains the key, without touching LRU order.
+	 */
+	bool contains(const K& key);
+
+	/**
+	* Returns the number of entries.
+	*/
+	std::size_t size();
+
+	/**
+	* Returns the maximum number of entries.
+	*/
+	std::size_t capacity() const { return _capacity; }
+
+	/**
+	 * Returns TRUE if the entries were restored from a previous run, or
+	 * attached to from another process.
+	 */
+	bool restored() const { return _restored; }
+
+	/**
+	 * Returns the number of times a process died mid-change and the table
+	 * was emptied to recover.
+	 */
+	std::uint64_t recoveries();
+
+	/**
+	 * Writes the arena back to the file without closing the cache.
+	 */
+	void sync();
+private:
+	/**
+	 * @struct Header
+	 * The first bytes of the file. Links are slot index + 1; 0 is null, so a
+	 * zero-filled file is an empty table.
+	 */
+	struct Header {
+		std::uint64_t magic;
+		std::uint32_t version;
+		std::uint32_t clean;		// 1 only while the file is closed.
+		std::uint64_t key_size;
+		std::uint64_t value_size;
+		std::uint64_t capacity;
+		std::uint64_t buckets;
+		std::uint64_t count;
+		std::uint32_t head;			// Most recently used.
+		std::uint32_t tail;			// Least recently used.
+		std::uint32_t free;			// Free list, chained through Slot::chain.
+		std::uint32_t used;			// Slots handed out at least once.
+		std::uint64_t recoveries;
+		std::uint64_t checksum;		// Of every field above; valid if clean.
+		// Below the checksum: live state, meaningless in a closed file.
+		std::uint32_t ready;		// Set once a shared arena is formatted.
+		std::uint32_t writing;		// Set while the table is mid-change.
+		pthread_mutex_t mutex;		// Robust and process-shared.
+	};
+
+	/**
+	 * @class Guard
+	 * Holds the arena mutex for a scope, recovering the table if the last
+	 * holder died.
+	 */
+	class Guard {
+	public:
+		explicit Guard(MappedCache& cache);
+		~Guard();
+	private:
+		MappedCache& _cache;
+	};
+
+	/**
+	 * @struct Slot
+	 * One entry, linked into its bucket chain and the LRU queue.
+	 */
+	struct Slot {
+		K key;
+		V value;
+		std::uint32_t chain;
+		std::uint32_t prev;
+		std::uint32_t next;
+	};
+
+	static constexpr std::uint64_t MAGIC = 0x3150414d4d435343;	// "CSCMMAP1"
+	static constexpr std::uint32_t VERSION = 2;
+	static constexpr int READY_WAIT_MS = 5000;
+
+	/**
+	 * Returns capacity, or throws std::invalid_argument if it can't be
+	 * addressed by a link.
+	 */
+	static std::size_t checked_capacity(std::size_t capacity);
+
+	/**
+	 * Returns the number of buckets for capacity entries.
+	 */
+	static std::size_t bucket_count(std::size_t capacity);
+
+	/**
+	 * Returns the byte offset of the bucket array, then the slot array.
+	 */
+	static std::size_t buckets_offset();
+	static std::size_t slots_offset(std::size_t capacity);
+
+	/**
+	 * FNV-1a over n bytes. Stable across runs, unlike std::hash.
+	 */
+	static std::uint64_t fnv1a(const void* data, std::size_t n);
+
+	/**
+	 * Maps the region for path and backing.
+	 */
+	static MappedRegion open_region(const std::string& path,
+		std::size_t capacity, Backing backing);
+
+	/**
+	 * Checks an existing header against this cache's layout.
+	 */
+	bool compatible() const;
+
+	/**
+	 * Checks a restored header's layout, clean flag, checksum and links.
+	 */
+	bool valid() const;
+
+	/**
+	 * Resets the arena to an empty table, header included.
+	 */
+	void format();
+
+	/**
+	 * Initializes the robust, process-shared mutex in the header.
+	 */
+	void init_mutex();
+
+	/**
+	 * Waits for the creating process to format a shared arena.
+	 */
+	void wait_ready() const;
+
+	/**
+	 * Empties the table, keeping the header and the mutex.
+	 */
+	void reset();
+
+	/**
+	 * Bracket every change to the table, so a crash inside one is detected.
+	 */
+	void begin_write();
+	void end_write();
+
+	/**
+	 * Returns the bucket link for the key.
+	 */
+	std::uint32_t& bucket(const K& key);
+
+	/**
+	 * Returns the chain link pointing at the key's slot, or nullptr if the
+	 * key isn't cached. Unlinking goes through the returned link.
+	 */
+	std::uint32_t* find(const K& key);
+
+	/**
+	 * Returns the slot for a non-null link.
+	 */
+	Slot& slot(std::uint32_t link) { return _slots[link - 1]; }
+
+	void lru_unlink(std::uint32_t link);
+	void lru_push_front(std::uint32_t link);
+
+	/**
+	 * Removes the slot that *at links to from its chain and the queue, and
+	 * frees it.
+	 */
+	void erase(std::uint32_t* at);
+
+	/**
+	 * Removes the least recently used entry.
+	 */
+	void evict();
+
+	std::size_t _capacity;
+	MappedRegion _region;
+	Header* _header;
+	std::uint32_t* _buckets;
+	Slot* _slots;
+	bool _restored;
+	bool _shared;
+};
+}
+#include "mapped-cache.tpp"
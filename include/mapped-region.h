@@ -0,0 +1,130 @@
+/**
+ * @file mapped-region.h
+ * @class MappedRegion
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * RAII wrapper around a shared mmap(2) region, backed by a file or by a POSIX
+ * shared memory object.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class MappedRegion
+* A MAP_SHARED mapping of a whole file or shared memory object. Writes go to
+* the page cache and reach the file without any explicit I/O; sync() forces
+* them to disk.
+*/
+class MappedRegion {
+public:
+	/**
+	 * Maps the file at path, creating it or growing it to size bytes first.
+	 * Throws std::system_error on failure.
+	 *
+	 * @param std::string path The file to map.
+	 * @param std::size_t size The size of the mapping in bytes.
+	 */
+	static MappedRegion open_file(const std::string& path, std::size_t size);
+
+	/**
+	 * Maps the existing file at path read-only, for reading it front to
+	 * back. An empty file maps to a null region. Throws std::system_error
+	 * on failure.
+	 *
+	 * @param std::string path The file to map.
+	 */
+	static MappedRegion open_read(const std::string& path);
+
+	/**
+	 * Maps the POSIX shared memory object name (e.g. "/cache"), creating it
+	 * with size bytes if it doesn't exist. If another process created it,
+	 * waits for that process to size it. created() tells the two apart.
+	 * Throws std::system_error on failure, std::invalid_argument if the
+	 * object exists with a different size.
+	 *
+	 * @param std::string name The shared memory object.
+	 * @param std::size_t size The size of the mapping in bytes.
+	 */
+	static MappedRegion open_shm(const std::string& name, std::size_t size);
+
+	/**
+	 * Removes the shared memory object name. Processes that have it mapped
+	 * keep their mappings. Does nothing if it doesn't exist.
+	 *
+	 * @param std::string name The shared memory object.
+	 */
+	static void unlink_shm(const std::string& name);
+
+	/**
+	 * Destructor. Unmaps the region.
+	 */
+	~MappedRegion();
+
+	/*
+	 * Move constructor.
+	 */
+	MappedRegion(MappedRegion&& other) noexcept;
+
+	/**
+	 * Move assignment operator.
+	 */
+	MappedRegion& operator=(MappedRegion&& other) noexcept;
+
+	// Disallow copy and assignment.
+	MappedRegion(const MappedRegion& other) = delete;
+	MappedRegion& operator=(const MappedRegion& other) = delete;
+
+	/**
+	 * Returns the start of the mapping.
+	 */
+	void* data() const { return _data; }
+
+	/**
+	 * Returns the size of the mapping in bytes.
+	 */
+	std::size_t size() const { return _size; }
+
+	/**
+	 * Returns TRUE if the backing file or object was created or resized by
+	 * this mapping, so its contents are zeros rather than earlier data.
+	 */
+	bool created() const { return _created; }
+
+	/**
+	 * Writes dirty pages back to the file and waits for them. Throws
+	 * std::system_error on failure.
+	 */
+	void sync();
+
+	/**
+	 * Like sync(), for the first bytes bytes of the region only.
+	 */
+	void sync(std::size_t bytes);
+private:
+	/**
+	 * Takes ownership of an existing mapping.
+	 */
+	MappedRegion(void* data, std::size_t size, bool created);
+
+	/**
+	 * Unmaps the region, if any.
+	 */
+	void unmap();
+
+	void* _data;
+	std::size_t _size;
+	bool _created;
+};
+}
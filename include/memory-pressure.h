@@ -0,0 +1,99 @@
+/**
+ * @file memory-pressure.h
+ * @class MemoryPressure
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Feedback controller that sizes a cache to the memory its process or
+ * cgroup has left.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct MemoryPressureOptions
+* Where to read memory use from, and how hard to steer.
+*/
+struct MemoryPressureOptions {
+	// cgroup v2 files; the paths can point at fakes for tests.
+	std::string current_path = "/sys/fs/cgroup/memory.current";
+	std::string max_path = "/sys/fs/cgroup/memory.max";
+	// Instead of the cgroup, compare this process's RSS to rss_limit.
+	bool use_rss = false;
+	std::string statm_path = "/proc/self/statm";
+	std::uint64_t rss_limit = 0;
+
+	double high = 0.85;		// Shrink above this share of the limit.
+	double critical = 0.95;	// Shrink twice as fast above this.
+	double low = 0.70;		// Grow back below this.
+	double step = 0.05;		// Share of the full capacity per adjustment.
+	std::size_t min_capacity = 1024;	// Never shrink below this.
+	std::chrono::milliseconds interval{1000};	// Time between polls.
+};
+
+/**
+* @class MemoryPressure
+* Reads memory use against its limit and turns it into a cache capacity:
+* above high the capacity shrinks by step of the full capacity per poll,
+* twice that above critical, and below low it grows back by half a step, up
+* to the full capacity. Between low and high it holds, so the capacity
+* doesn't oscillate around one threshold. Growing slower than shrinking
+* keeps a neighbour's spike from being answered by an immediate regrowth.
+*/
+class MemoryPressure {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param std::size_t full_capacity The capacity with no pressure.
+	 */
+	MemoryPressure(const MemoryPressureOptions& options,
+		std::size_t full_capacity);
+
+	/**
+	 * Returns memory use as a share of the limit, or a negative number if
+	 * the files can't be read or there is no limit.
+	 */
+	double usage() const;
+
+	/**
+	 * Polls usage() and returns the capacity to move to from capacity.
+	 */
+	std::size_t adjust(std::size_t capacity) const;
+
+	/**
+	 * Returns the capacity to move to from capacity at a usage() already
+	 * read, so the caller can read it without holding its own locks.
+	 */
+	std::size_t adjust(std::size_t capacity, double usage) const;
+
+	/**
+	 * Returns the options.
+	 */
+	const MemoryPressureOptions& options() const;
+private:
+	/**
+	 * Reads the first unsigned number in a file.
+	 *
+	 * @return TRUE if read; FALSE if not (e.g. "max").
+	 */
+	static bool read_number(const std::string& path, std::uint64_t& value,
+		std::size_t field = 0);
+
+	MemoryPressureOptions _options;
+	std::size_t _full;
+};
+}
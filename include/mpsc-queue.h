@@ -0,0 +1,86 @@
+/**
+ * @file mpsc-queue.h
+ * @class MpscQueue
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Bounded lock-free queue for many producers and one consumer.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class MpscQueue
+* A fixed ring of slots, each with a sequence number telling whether it is
+* free for the producer of a given lap or full for the consumer (Vyukov's
+* bounded queue). Producers claim a slot with one compare-and-swap on the
+* tail and never wait: when the ring is full, try_push() fails and the
+* caller decides what to do with the element. The single consumer takes
+* elements in order with no atomic read-modify-write at all.
+*/
+template <typename T>
+class MpscQueue {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param std::size_t capacity Rounded up to a power of two.
+	 */
+	explicit MpscQueue(std::size_t capacity);
+
+	// Disallow copy and assignment.
+	MpscQueue(const MpscQueue& other) = delete;
+	MpscQueue& operator=(const MpscQueue& other) = delete;
+
+	/**
+	 * Appends the element, from any thread.
+	 *
+	 * @return TRUE if queued; FALSE if the queue is full.
+	 */
+	bool try_push(T&& element);
+
+	/**
+	 * Moves up to max elements, oldest first, to the end of out. Consumer
+	 * thread only.
+	 *
+	 * @return The number of elements taken.
+	 */
+	std::size_t pop_batch(std::vector<T>& out, std::size_t max);
+
+	/**
+	 * Checks whether the queue looks empty. Exact only on the consumer.
+	 */
+	bool empty() const;
+
+	/**
+	 * Returns the number of slots.
+	 */
+	std::size_t capacity() const;
+private:
+	struct Slot {
+		std::atomic<std::uint64_t> sequence;
+		T element;
+	};
+
+	std::unique_ptr<Slot[]> _slots;
+	std::size_t _mask;
+	// Producers and the consumer work on separate lines.
+	alignas(64) std::atomic<std::uint64_t> _tail;
+	alignas(64) std::uint64_t _head;
+};
+}
+#include "mpsc-queue.tpp"
@@ -0,0 +1,99 @@
+/**
+ * @file near-cache.h
+ * @class NearCache
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * A small private copy of shared cache entries, for one thread.
+ */
+
+#pragma once
+
+#include "version-table.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class NearCache
+* A two-way set-associative table of entry copies, each tagged with the
+* version of its stripe in the owner's VersionTable when it was copied. A lookup is only a
+* hit if that version is still current, so the owner invalidates copies on
+* every thread by bumping a counter, without knowing where the copies are.
+* A copy can also carry a deadline after which it is not served. Each set
+* replaces its least recently used way, so two keys that map to the same
+* set don't evict each other in turn.
+*
+* Not thread-safe: each thread keeps its own.
+*/
+template <typename K, typename V>
+class NearCache {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Constructor.
+	 *
+	 * @param std::size_t slots Rounded up to a power of two, at least two.
+	 */
+	explicit NearCache(std::size_t slots);
+
+	/**
+	 * Looks up a current copy of the key.
+	 *
+	 * @param hash The key's hash, as given to the VersionTable.
+	 * @return A pointer to the copy, valid until the next put(); nullptr if
+	 * there is no current copy.
+	 */
+	V* get(const K& key, std::size_t hash, const VersionTable& versions);
+
+	/**
+	 * Stores a copy of the entry, replacing the key's older copy or the
+	 * least recently used copy in its set.
+	 *
+	 * @param std::uint64_t version The stripe's version, read with the
+	 * entry's lock held.
+	 * @param Clock::time_point deadline When the copy stops being served.
+	 */
+	void put(const K& key, std::size_t hash, const V& value,
+		std::uint64_t version,
+		Clock::time_point deadline = Clock::time_point::max());
+
+	/**
+	 * Drops every copy.
+	 */
+	void clear();
+private:
+	struct Slot {
+		bool used = false;
+		K key;
+		V value;
+		std::uint64_t version = 0;
+		Clock::time_point deadline;
+	};
+
+	struct Set {
+		Slot ways[2];
+		unsigned char victim = 0;	// The way to replace next.
+	};
+
+	/**
+	 * Returns the set for a hash.
+	 */
+	std::size_t index(std::size_t hash) const;
+
+	std::vector<Set> _sets;
+	std::size_t _mask;
+};
+}
+#include "near-cache.tpp"
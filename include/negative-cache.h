@@ -0,0 +1,139 @@
+/**
+ * @file negative-cache.h
+ * @class NegativeCache
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * A filter of keys known to be absent from the backend, so repeated lookups
+ * of them can be answered without touching the cache or the backend.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct NegativeCacheOptions
+* Sizing for a NegativeCache.
+*/
+struct NegativeCacheOptions {
+	std::size_t expected_keys = 1 << 20;	// Adds before the filter resets.
+	double false_positive_rate = 0.01;		// Target at expected_keys.
+	std::size_t max_bytes = 16 << 20;		// Hard cap on the counter array.
+};
+
+/**
+* @class NegativeCache
+* A blocked counting Bloom filter. Each key hashes to one 64-byte block of
+* 128 four-bit counters and sets its probes within that block, so a query
+* touches a single cache line. Counters are updated with atomic
+* compare-and-swap, so queries take no lock.
+*
+* A positive answer means "recorded absent", and is wrong with about the
+* configured false positive rate. forget() is exact: after it returns, the
+* key tests negative. It decrements the key's counters and, if a collision
+* still leaves it positive, clears the whole block; that costs the other
+* keys in the block their entries, which only means extra backend lookups.
+* After expected_keys adds the filter starts over, so stale entries don't
+* pile up past the target false positive rate.
+*/
+template <typename K, typename Hash = std::hash<K>>
+class NegativeCache {
+public:
+	/**
+	 * Constructor. Sizes the filter for options.expected_keys at
+	 * options.false_positive_rate, capped at options.max_bytes.
+	 */
+	explicit NegativeCache(
+		const NegativeCacheOptions& options = NegativeCacheOptions());
+
+	// Disallow copy and assignment.
+	NegativeCache(const NegativeCache& other) = delete;
+	NegativeCache& operator=(const NegativeCache& other) = delete;
+
+	/**
+	 * Checks whether the key was recorded absent.
+	 *
+	 * @return TRUE if probably absent; FALSE if unknown.
+	 */
+	bool absent(const K& key) const;
+
+	/**
+	 * Records the key as absent.
+	 */
+	void add(const K& key);
+
+	/**
+	 * Removes the key's absent record, e.g. because it was just inserted.
+	 */
+	void forget(const K& key);
+
+	/**
+	 * Drops every record.
+	 */
+	void clear();
+
+	/**
+	 * Returns the size of the counter array in bytes.
+	 */
+	std::size_t bytes() const;
+
+	/**
+	 * Returns the number of counters each key sets.
+	 */
+	unsigned probes() const;
+
+	static constexpr std::size_t BLOCK_BYTES = 64;
+	static constexpr std::size_t BLOCK_COUNTERS = 128;
+private:
+	static constexpr std::size_t BLOCK_WORDS = BLOCK_BYTES / 8;
+	static constexpr unsigned MAX_PROBES = 16;
+	static constexpr std::uint64_t MAX_COUNT = 15;
+
+	struct alignas(BLOCK_BYTES) Block {
+		std::atomic<std::uint64_t> words[BLOCK_WORDS];
+	};
+
+	/**
+	 * Mixes the user hash so that weak hashes (identity for integers)
+	 * still spread over blocks and probes.
+	 */
+	static std::uint64_t mix(std::uint64_t h);
+
+	/**
+	 * Returns the key's block and fills slots with its counter indexes.
+	 */
+	Block& locate(const K& key, unsigned* slots) const;
+
+	/**
+	 * Adds delta (+1 or -1) to one four-bit counter; saturated counters
+	 * stay put.
+	 */
+	static void bump(Block& block, unsigned slot, int delta);
+
+	/**
+	 * Reads one four-bit counter.
+	 */
+	static std::uint64_t count(const Block& block, unsigned slot);
+
+	std::unique_ptr<Block[]> _blocks;
+	std::size_t _nblocks;
+	unsigned _probes;
+	std::size_t _reset_after;
+	std::atomic<std::size_t> _adds;
+	Hash _hash;
+};
+}
+#include "negative-cache.tpp"
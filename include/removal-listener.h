@@ -0,0 +1,140 @@
+/**
+ * @file removal-listener.h
+ * @class RemovalDispatcher
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Notifications of entries leaving a CacheManager, delivered to listeners
+ * on a background thread.
+ */
+
+#pragma once
+
+#include "mpsc-queue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @enum RemovalCause
+* Why an entry left the cache.
+*/
+enum class RemovalCause {
+	SIZE,		// Evicted to make room.
+	EXPIRED,	// Its TTL ran out.
+	REPLACED,	// A new value was stored over it.
+	EXPLICIT	// Removed by remove(), erase_if() or compute().
+};
+
+/**
+* @struct RemovalOptions
+* Tuning for a RemovalDispatcher.
+*/
+struct RemovalOptions {
+	std::size_t queue_capacity = 1 << 16;	// Pending notifications.
+	std::size_t batch_size = 256;			// Delivered per wakeup.
+};
+
+/**
+* @struct Removal
+* One notification: the entry as it was when it left.
+*/
+template <typename K, typename V>
+struct Removal {
+	K key;
+	V value;
+	RemovalCause cause;
+};
+
+/**
+* @class RemovalDispatcher
+* Queues removal notifications on an MpscQueue and delivers them in batches
+* to every listener from one background thread, so the thread removing the
+* entry never runs listener code. notify() never blocks: if the queue is
+* full the notification is dropped and counted. Listeners see each thread's
+* notifications in order.
+*/
+template <typename K, typename V>
+class RemovalDispatcher {
+public:
+	using Listener = std::function<void(const K& key, const V& value,
+		RemovalCause cause)>;
+
+	/**
+	 * Constructor. Starts the dispatcher thread.
+	 */
+	explicit RemovalDispatcher(
+		const RemovalOptions& options = RemovalOptions());
+
+	/**
+	 * Destructor. Delivers what is queued and stops the thread.
+	 */
+	~RemovalDispatcher();
+
+	// Disallow copy and assignment.
+	RemovalDispatcher(const RemovalDispatcher& other) = delete;
+	RemovalDispatcher& operator=(const RemovalDispatcher& other) = delete;
+
+	/**
+	 * Registers a listener. An exception thrown by a listener is swallowed.
+	 */
+	void add_listener(Listener listener);
+
+	/**
+	 * Queues a notification, from any thread.
+	 *
+	 * @return TRUE if queued; FALSE if dropped.
+	 */
+	bool notify(const K& key, const V& value, RemovalCause cause);
+
+	/**
+	 * Waits until every notification queued before the call is delivered.
+	 */
+	void drain();
+
+	/**
+	 * Returns the number of notifications dropped on a full queue.
+	 */
+	std::uint64_t dropped() const;
+
+	/**
+	 * Returns the number of notifications delivered.
+	 */
+	std::uint64_t delivered() const;
+private:
+	/**
+	 * Dispatcher loop.
+	 */
+	void run();
+
+	RemovalOptions _options;
+	MpscQueue<Removal<K, V>> _queue;
+	std::atomic<std::uint64_t> _queued;
+	std::atomic<std::uint64_t> _delivered;
+	std::atomic<std::uint64_t> _dropped;
+	// Producers only take _mutex to wake an idle dispatcher.
+	std::atomic<bool> _idle;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::condition_variable _drained;
+	std::shared_ptr<const std::vector<Listener>> _listeners;
+	bool _stop;
+	std::thread _thread;
+};
+}
+#include "removal-listener.tpp"
@@ -0,0 +1,145 @@
+/**
+ * @file shards.h
+ * @class Shards
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Online miss-ratio-curve estimation by spatially hashed sampling (SHARDS,
+ * Waldspurger et al., FAST '15).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct MrcOptions
+* Sampling and resolution for a Shards estimator.
+*/
+struct MrcOptions {
+	double sample_rate = 0.001;			// Starting share of keys tracked.
+	std::size_t max_keys = 8192;		// Tracked keys; the rate drops to fit.
+	std::size_t max_cache_size = 1 << 20;	// Largest size on the curve.
+	std::size_t buckets = 256;			// Curve points up to max_cache_size.
+};
+
+/**
+* @class Shards
+* Estimates the LRU miss ratio at every cache size from one stream of
+* accesses. A key is tracked only if its hash falls under a threshold, so
+* every access to it is seen and reuse distances among tracked keys scale
+* by the sampling rate to the whole stream. Each tracked access finds its
+* reuse distance, the number of distinct tracked keys touched since the
+* key's previous access, with a Fenwick tree over access times, and adds
+* it to a histogram; an LRU cache of size c hits exactly the accesses with
+* distance below c.
+*
+* The tracked set is bounded: past max_keys, the key with the largest hash
+* is dropped and the threshold lowered to it, and the histogram is rescaled
+* to the new rate (SHARDS-adj). Keys are tracked by a 64-bit hash rather
+* than stored, so the cost is about 30 bytes per tracked key whatever K is.
+*
+* access() rejects an untracked key with a hash and a compare, without a
+* lock.
+*/
+template <typename K, typename Hash = std::hash<K>>
+class Shards {
+public:
+	/**
+	 * Constructor.
+	 */
+	explicit Shards(const MrcOptions& options = MrcOptions());
+
+	// Disallow copy and assignment.
+	Shards(const Shards& other) = delete;
+	Shards& operator=(const Shards& other) = delete;
+
+	/**
+	 * Records an access to the key.
+	 */
+	void access(const K& key);
+
+	/**
+	 * Returns the estimated miss ratio of an LRU cache with the given
+	 * number of entries.
+	 */
+	double miss_ratio(std::size_t cache_size);
+
+	/**
+	 * Returns (cache size, estimated miss ratio) at each bucket boundary up
+	 * to max_cache_size.
+	 */
+	std::vector<std::pair<std::size_t, double>> curve();
+
+	/**
+	 * Returns the current sampling rate.
+	 */
+	double rate() const;
+
+	/**
+	 * Returns the number of tracked keys.
+	 */
+	std::size_t tracked();
+private:
+	/**
+	 * Mixes the user hash into 64 well-spread bits.
+	 */
+	static std::uint64_t mix(std::uint64_t h);
+
+	/**
+	 * Fenwick tree over access times. Called with _mutex held.
+	 */
+	void tree_add(std::size_t i, int delta);
+	std::int64_t tree_sum(std::size_t i) const;
+
+	/**
+	 * Renumbers access times 1..n once the tree is full. Called with
+	 * _mutex held.
+	 */
+	void compact();
+
+	/**
+	 * Drops the tracked key with the largest hash and lowers the threshold
+	 * to it. Called with _mutex held.
+	 */
+	void shed();
+
+	/**
+	 * Miss ratio from the histogram. Called with _mutex held.
+	 */
+	double miss_ratio_locked(std::size_t cache_size) const;
+
+	static constexpr std::uint64_t MODULUS = 1ull << 24;
+
+	MrcOptions _options;
+	Hash _hash;
+	std::atomic<std::uint64_t> _threshold;
+	std::mutex _mutex;
+	// Tracked key hash -> time of its last access.
+	std::unordered_map<std::uint64_t, std::uint32_t> _last;
+	// Max-heap of (sample value, key hash), for shedding.
+	std::vector<std::pair<std::uint32_t, std::uint64_t>> _by_sample;
+	std::vector<std::int64_t> _tree;
+	std::uint32_t _now;
+	std::size_t _width;
+	std::vector<double> _histogram;
+	double _beyond;		// Reuse distances past max_cache_size.
+	double _cold;		// First accesses.
+};
+}
+#include "shards.tpp"
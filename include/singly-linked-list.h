@@ -12,7 +12,8 @@
 #pragma once
 
 #include <cstddef>
-#include <iostream>
+#include <iterator>
+#include <ostream>
 
 /**
 * @namespace csc
@@ -30,30 +31,45 @@ public:
 	SLLNode(const T& element) : _element(element), _next(nullptr) {}
 	SLLNode(const T& element, SLLNode* next) : _element(element), _next(next) {}
 
-	T get_element() const { return _element; }
+	T& get_element() { return _element; }
+	const T& get_element() const { return _element; }
 	SLLNode* get_next() const { return _next; }
 
 	void set_element(const T& element) { _element = element; }
-	void set_next(Node* next) { _next = next; }
+	void set_next(SLLNode* next) { _next = next; }
 private:
 	T _element;
 	SLLNode* _next;
 };
 
+/**
+* @class SLLIterator
+* Forward iterator over the elements of a SinglyLinkedList, for range-based
+* for. end() is the iterator past the last node, at nullptr.
+*/
 template <typename T>
-class SLLIterator : public csc::Iterator<T> {
+class SLLIterator {
 public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	explicit SLLIterator(SLLNode<T> *node) : _node(node) {}
+
 	SLLIterator& operator++();
 	SLLIterator operator++(int);
 	T& operator*() const;
-	void add(const T& element);
-	void delete();
-protected:
-	/**
-	* new and delete are protected so heap allocation is disallowed. Must be 
-	* allocated on the stack, for RAII.
-	*/
-	explicit SLLIterator(STTNode<T> node) : _node(node) {}
+	T* operator->() const { return &**this; }
+	bool operator==(const SLLIterator& other) const
+	{
+		return _node == other._node;
+	}
+	bool operator!=(const SLLIterator& other) const
+	{
+		return _node != other._node;
+	}
 private:
 	SLLNode<T> *_node;
 };
@@ -95,32 +111,36 @@ public:
 	 */
 	SinglyLinkedList<T>& operator=(SinglyLinkedList<T>&& rhs) noexcept;
 
-	friend class SLLIterator<T>;
-
 	/**
-	 * Overloaded ostream operator, '<<'.
+	 * Overloaded ostream operator, '<<'. Writes the elements, comma 
+	 * separated, front first.
 	 */
-	friend ostream& operator<<(ostream& out, const SinglyLinkedList& sll) const;
-
- 	/**
-	 * Overloaded istream operator, '>>'.
-	 */
-	friend istream& operator>>(istream& in, SinglyLinkedList& sll) const;
+	friend std::ostream& operator<<(std::ostream& out,
+		const SinglyLinkedList& sll)
+	{
+		for (const SLLNode<T> *curr = sll._head; curr != nullptr; 
+			curr = curr->get_next()) {
+			out << curr->get_element();
+			if (curr->get_next() != nullptr) {
+				out << ", ";
+			}
+		}
+		return out;
+	}
 
 	/**
 	 * Returns the first element of SinglyLinkedList.
 	 *
-	 * @return T element The first element.
+	 * @return T* element The first element, or nullptr if empty.
 	 */
 	T* front() const;
 
 	/**
-	 * Returns the first element of SinglyLinkedList and deletes it from the 
-	 * list.
+	 * Deletes the first element of SinglyLinkedList.
 	 *
-	 * @return T element The first element.
+	 * @return TRUE if deleted; FALSE if the list was empty.
 	 */
-	T* pop_front();
+	bool pop_front();
 
 	/**
 	 * Adds a new element at the beginning of SinglyLinkedList.
@@ -150,15 +170,14 @@ public:
 	bool contains(const T& element) const;
 
 	/**
-	 * Finds an element and returns an Iterator to it, or nullptr if the element 
+	 * Finds an element and returns a pointer to it, or nullptr if the element 
 	 * was not found.
 	 *
 	 * @param T element The element to find.
 	 *
-	 * @return STTIterator<T> iterator An iterator pointing to the element, or 
-	 * nullptr if not found.
+	 * @return T* The element in the list, or nullptr if not found.
 	 */
-	SLLIterator<T> find(const T& element);
+	T* find(const T& element) const;
 
 	/**
 	* Returns the size of SinglyLinkedList.
@@ -174,6 +193,11 @@ public:
 	*/
 	bool empty() const;
 
+	/**
+	* Clears all SinglyLinkedList's Nodes and deallocates their memory.
+	*/
+	void clear();
+
 	/** 
 	 * Returns an Iterator pointing to the beginning (first element) of 
 	 * SinglyLinkedList.
@@ -190,15 +214,10 @@ public:
 	SLLIterator<T> end() const;
 private:
 	/**
-	* Searches for an element and returns the Node before it. The element's node
-	* can be accessed by get_next().
+	* Searches for an element and returns the Node before it, or nullptr if the
+	* element is at the head or not found; found is set to whether it was.
 	*/
-	SLLNode<T>* search(const T& element);
-
-	/**
-	* Clears all SinglyLinkedList's Nodes and deallocates their memory.
-	*/
-	void clear();
+	SLLNode<T>* search(const T& element, bool& found) const;
 
 	SLLNode<T>* _head;
 	std::size_t _size;
@@ -0,0 +1,271 @@
+/**
+ * @file spill-tier.h
+ * @class SpillTier
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Second cache tier on local disk, for entries evicted from memory.
+ */
+
+#pragma once
+
+#include "binary-io.h"
+#include "thread-pool.h"
+
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct SpillOptions
+* Tuning for a SpillTier.
+*/
+struct SpillOptions {
+	std::string directory;					// Parent of the segment directory.
+	std::size_t segment_bytes = 64 << 20;	// Size at which a segment is sealed.
+	std::size_t buffer_bytes = 1 << 20;		// Write batch; a multiple of BLOCK.
+	std::uint64_t max_bytes = 16ull << 30;	// Disk budget; oldest segment goes.
+	double reclaim_below = 0.5;				// Live fraction that gets compacted.
+	std::size_t io_threads = 4;				// Threads serving get_async().
+};
+
+/**
+* @class SpillTier
+* A log-structured store of key-value pairs. Puts are appended to an aligned
+* in-memory buffer that is written out in BLOCK-aligned batches to the active
+* segment file; full segments are sealed and a new one opened. An in-memory
+* index maps each key to its latest record. Overwritten and erased records
+* are dead space: reclaim() copies the live records out of mostly-dead
+* segments and deletes them, and the oldest segment is dropped whenever the
+* disk budget is exceeded.
+*
+* Reads are pread(2) calls outside the tier's lock, either on the caller's
+* thread or, through get_async(), on a small I/O thread pool. Keys and values
+* are encoded by csc::Codec. The tier does not survive a restart: its
+* segments live in a private subdirectory that is deleted on destruction, so
+* tiers can share SpillOptions::directory.
+*/
+template <typename K, typename V>
+class SpillTier {
+public:
+	/**
+	 * Constructor. Creates a uniquely named subdirectory of
+	 * SpillOptions::directory, which must exist, for the segments. Throws
+	 * std::system_error on failure.
+	 */
+	explicit SpillTier(const SpillOptions& options);
+
+	/**
+	 * Destructor. Closes the tier, then deletes the segment files and their
+	 * directory.
+	 */
+	~SpillTier();
+
+	// Disallow copy and assignment.
+	SpillTier(const SpillTier& other) = delete;
+	SpillTier& operator=(const SpillTier& other) = delete;
+
+	/**
+	 * Appends the key-value pair, replacing any earlier record of the key.
+	 */
+	void put(const K& key, const V& value);
+
+	/**
+	 * Reads the value associated with the key.
+	 *
+	 * @return TRUE if found; FALSE if not.
+	 */
+	bool get(const K& key, V& value);
+
+	/**
+	 * Reads the value associated with the key and erases it, for promotion
+	 * back into memory.
+	 *
+	 * @return TRUE if found; FALSE if not.
+	 */
+	bool take(const K& key, V& value);
+
+	/**
+	 * Reads the value associated with the key on the I/O pool.
+	 *
+	 * @return A future holding the value, or std::nullopt if not found.
+	 */
+	std::future<std::optional<V>> get_async(const K& key);
+
+	/**
+	 * Reads the value associated with the key on the I/O pool, then calls
+	 * then(value) on the I/O thread before the future is made ready.
+	 *
+	 * @param Then then Callable as then(std::optional<V>& value).
+	 * @return A future holding the value, or std::nullopt if not found.
+	 */
+	template <typename Then>
+	std::future<std::optional<V>> get_async(const K& key, Then then);
+
+	/**
+	 * Stops get_async(): reads not yet started resolve to std::nullopt
+	 * without calling then, and the call waits for those already running.
+	 * Call it before anything a then callback uses is destroyed.
+	 */
+	void close();
+
+	/**
+	 * Erases the key.
+	 *
+	 * @return TRUE if the key was erased; FALSE if not found.
+	 */
+	bool erase(const K& key);
+
+	/**
+	 * Erases every key whose value pred returns TRUE for. Each record is
+	 * read back without the tier's lock, so this costs a read per key.
+	 *
+	 * @param Pred pred Callable as pred(const K& key, const V& value).
+	 * @return The number of keys erased.
+	 */
+	template <typename Pred>
+	std::size_t erase_if(Pred pred);
+
+	/**
+	 * Checks whether the tier holds the key.
+	 */
+	bool contains(const K& key);
+
+	/**
+	 * Writes out the buffered records.
+	 */
+	void flush();
+
+	/**
+	 * Compacts every sealed segment whose live fraction is below
+	 * SpillOptions::reclaim_below. Meant to run off the hot path.
+	 *
+	 * @return The number of segments reclaimed.
+	 */
+	std::size_t reclaim();
+
+	/**
+	 * Returns the number of keys held.
+	 */
+	std::size_t size();
+
+	/**
+	 * Returns the bytes on disk and in the write buffer.
+	 */
+	std::uint64_t disk_bytes();
+
+	/** Alignment of every write. */
+	static constexpr std::size_t BLOCK = 4096;
+private:
+	/**
+	 * @struct Segment
+	 * One log file. Readers hold a shared_ptr, so a segment that is dropped
+	 * mid-read keeps its descriptor until the read finishes.
+	 */
+	struct Segment {
+		std::uint64_t id;
+		std::string path;
+		int fd;
+		std::uint64_t written;		// Bytes on disk, padding included.
+		std::uint64_t live;			// Bytes of records still indexed.
+		std::vector<K> keys;		// Keys appended, possibly since moved.
+		~Segment();
+	};
+
+	/**
+	 * @struct Location
+	 * Where a key's latest record is.
+	 */
+	struct Location {
+		std::shared_ptr<Segment> segment;
+		std::uint64_t offset;
+		std::uint32_t length;
+	};
+
+	struct FreeDeleter {
+		void operator()(char* p) const;
+	};
+
+	/**
+	 * Encodes or decodes one record.
+	 */
+	static std::string encode(const K& key, const V& value);
+	static bool decode(const std::string& record, const K& key, V& value);
+
+	/**
+	 * Appends a record to the buffer and indexes it. Called with the lock.
+	 */
+	void append(const K& key, const std::string& record);
+
+	/**
+	 * Drops the key's index entry, marking its record dead. Called with the
+	 * lock.
+	 */
+	void unindex(typename std::unordered_map<K, Location>::iterator it);
+
+	/**
+	 * Writes the buffer to the active segment, padded to BLOCK. Called with
+	 * the lock.
+	 */
+	void flush_buffer();
+
+	/**
+	 * Seals the active segment and opens the next one. Called with the lock.
+	 */
+	void roll();
+
+	/**
+	 * Deletes a segment, unindexing its live records. Called with the lock.
+	 */
+	void drop(std::uint64_t id);
+
+	/**
+	 * Reads the record at loc. Called with the lock held in lock, which is
+	 * released for the disk read unless the record is still buffered.
+	 */
+	bool read(const Location& loc, std::unique_lock<std::mutex>& lock,
+		std::string& record);
+
+	/**
+	 * pread(2) or pwrite(2) all n bytes; throws std::system_error on failure.
+	 */
+	static void pread_all(int fd, char* data, std::size_t n,
+		std::uint64_t offset);
+	static void pwrite_all(int fd, const char* data, std::size_t n,
+		std::uint64_t offset);
+
+	SpillOptions _options;
+	std::string _directory;			// This tier's own segment directory.
+	std::mutex _mutex;
+	std::unordered_map<K, Location> _index;
+	std::map<std::uint64_t, std::shared_ptr<Segment>> _segments;
+	std::shared_ptr<Segment> _active;
+	std::unique_ptr<char, FreeDeleter> _buffer;
+	std::size_t _buffered;
+	std::uint64_t _next_id;
+	std::uint64_t _disk_bytes;
+	// get_async() reads submitted and not yet finished, and whether close()
+	// has been called; both guarded by _mutex.
+	std::size_t _reading;
+	bool _closed;
+	std::condition_variable _drained;
+	ThreadPool _io;
+};
+}
+#include "spill-tier.tpp"
@@ -11,13 +11,6 @@
 
 #pragma once
 
-namespace csc {
-	template <typename T>
-	class Node;
-	template <typename T>
-	class LinkedList;
-}
-
 namespace test {
 
 /**
@@ -55,4 +48,99 @@ void linked_list();
 */
 void hash_map();
 
+/**
+* Unit tests for ThreadPool.
+*/
+void thread_pool();
+
+/**
+* Unit tests for BinaryWriter, BinaryReader and the dump format.
+*/
+void binary_io();
+
+/**
+* Unit tests for MappedCache.
+*/
+void mapped_cache();
+
+/**
+* Unit tests for MappedCache in shared memory, across forked processes.
+*/
+void shared_cache();
+
+/**
+* Unit tests for SpillTier.
+*/
+void spill_tier();
+
+/**
+* Unit tests for WriteBack and FileStore.
+*/
+void write_back();
+
+/**
+* Unit tests for NegativeCache.
+*/
+void negative_cache();
+
+/**
+* Unit tests for HotKeys, VersionTable and NearCache.
+*/
+void hot_keys();
+
+/**
+* Unit tests for MpscQueue and RemovalDispatcher.
+*/
+void removal_listener();
+
+/**
+* Unit tests for Maintenance.
+*/
+void maintenance();
+
+/**
+* Unit tests for MemoryPressure.
+*/
+void memory_pressure();
+
+/**
+* Unit tests for Shards.
+*/
+void shards();
+
+/**
+* Unit tests for CacheStats.
+*/
+void cache_stats();
+
+/**
+* Unit tests for Tracer.
+*/
+void trace();
+
+/**
+* Unit tests for the workload generators in util.
+*/
+void workload();
+
+/**
+* Unit tests for AccessTrace and the simulator policies.
+*/
+void cache_sim();
+
+/**
+* Unit tests for AllocCounter and TrackingAllocator.
+*/
+void alloc_counter();
+
+/**
+* Unit tests for BPlusTree.
+*/
+void bplus_tree();
+
+/**
+* Unit tests for CacheManager.
+*/
+void cache_manager();
+
 }
@@ -0,0 +1,96 @@
+/**
+ * @file thread-pool.h
+ * @class ThreadPool
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Fixed-size worker pool, used to run bulk operations over HashMap and
+ * CacheManager in parallel.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class ThreadPool
+* A fixed number of worker threads pulling tasks from a shared queue.
+*/
+class ThreadPool {
+public:
+	/**
+	 * Constructor. Starts the worker threads.
+	 *
+	 * @param std::size_t workers The number of worker threads. Zero selects
+	 * the hardware concurrency.
+	 */
+	explicit ThreadPool(std::size_t workers = 0);
+
+	/**
+	 * Destructor. Finishes the queued tasks and joins the workers.
+	 */
+	~ThreadPool();
+
+	// Disallow copy and assignment.
+	ThreadPool(const ThreadPool& other) = delete;
+	ThreadPool& operator=(const ThreadPool& other) = delete;
+
+	/**
+	 * Returns the process-wide pool, started on first use.
+	 */
+	static ThreadPool& shared();
+
+	/**
+	 * Queues a task to run on one of the workers.
+	 *
+	 * @param std::function<void()> task The task to run.
+	 */
+	void submit(std::function<void()> task);
+
+	/**
+	 * Splits [0, n) into ranges of at most grain elements and calls
+	 * fn(begin, end) for each range. Workers pull ranges until none are left,
+	 * so uneven ranges balance themselves. The calling thread takes part and
+	 * does not return until every range is done. The first exception thrown
+	 * by fn is rethrown to the caller.
+	 *
+	 * @param std::size_t n The number of elements.
+	 * @param std::size_t grain The maximum number of elements per range.
+	 * @param fn The callable to run on each range.
+	 */
+	void parallel_for(std::size_t n, std::size_t grain,
+		const std::function<void(std::size_t, std::size_t)>& fn);
+
+	/**
+	* Returns the number of worker threads.
+	*
+	* @return std::size_t The number of workers.
+	*/
+	std::size_t size() const;
+private:
+	/**
+	 * Worker loop: runs tasks until the pool is stopped and drained.
+	 */
+	void run();
+
+	std::vector<std::thread> _workers;
+	std::queue<std::function<void()>> _tasks;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	bool _stop;
+};
+}
@@ -0,0 +1,241 @@
+/**
+ * @file trace.h
+ * @class Tracer, TraceScope
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Hot-path tracepoints timed by the TSC into per-thread rings, dumped to a
+ * binary file that tools/trace2json.py turns into Chrome trace JSON.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+/**
+* Tracepoints compile to nothing unless CSC_TRACE is defined (cmake
+* -DCSC_TRACE=ON). CSC_TRACE_SCOPE times the rest of the enclosing block;
+* CSC_TRACE_BEGIN/END time a span within one, by name.
+*/
+#ifdef CSC_TRACE
+#define CSC_TRACE_CAT_(a, b) a##b
+#define CSC_TRACE_CAT(a, b) CSC_TRACE_CAT_(a, b)
+#define CSC_TRACE_SCOPE(phase) \
+	csc::TraceScope CSC_TRACE_CAT(csc_trace_, __LINE__)(csc::TracePhase::phase)
+#define CSC_TRACE_BEGIN(name, phase) \
+	csc::TraceScope csc_trace_##name(csc::TracePhase::phase)
+#define CSC_TRACE_END(name) csc_trace_##name.end()
+#else
+#define CSC_TRACE_SCOPE(phase) ((void)0)
+#define CSC_TRACE_BEGIN(name, phase) ((void)0)
+#define CSC_TRACE_END(name) ((void)0)
+#endif
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @enum TracePhase
+* What a trace record timed.
+*/
+enum class TracePhase : std::uint16_t {
+	CACHE_GET,		// CacheManager::get(), whole.
+	CACHE_INSERT,	// CacheManager::insert(), whole.
+	LOCK_WAIT,		// Waiting for the CacheManager lock.
+	HASH,			// Hashing a key to its bucket.
+	BUCKET_SCAN,	// Searching a HashMap bucket.
+	LRU_RELINK,		// Moving a key to the front of the LRU list.
+	EVICT,			// Evicting the least recently used entry.
+	LOAD			// The loader, on a miss.
+};
+
+/**
+* @struct TraceRecord
+* One timed span, in TSC ticks.
+*/
+struct TraceRecord {
+	std::uint64_t start;
+	std::uint64_t ticks;
+	std::uint32_t thread;
+	TracePhase phase;
+	std::uint16_t reserved;
+};
+
+/**
+* @struct TraceDump
+* A dump read back by Tracer::read().
+*/
+struct TraceDump {
+	double ticks_per_ns;
+	std::vector<TraceRecord> records;
+};
+
+/**
+ * Returns the timestamp counter: rdtsc on x86, else steady_clock in ns.
+ */
+inline std::uint64_t tsc()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return static_cast<std::uint64_t>(
+		std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+* @class TraceRing
+* A fixed ring of records with one writer, its thread. A full ring
+* overwrites its oldest records, so it always holds the most recent ones.
+*/
+class TraceRing {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param std::size_t capacity The records kept.
+	 */
+	TraceRing(std::size_t capacity, std::uint32_t thread);
+
+	/**
+	 * Appends a record. Called only by the owning thread.
+	 */
+	void push(std::uint64_t start, std::uint64_t end, TracePhase phase);
+
+	/**
+	 * Appends the held records, oldest first, to out. Records the writer
+	 * overwrote during the copy are left out.
+	 */
+	void copy(std::vector<TraceRecord>& out) const;
+
+	/**
+	 * Drops every record.
+	 */
+	void clear();
+private:
+	std::unique_ptr<TraceRecord[]> _records;
+	std::size_t _mask;
+	std::uint64_t _capacity;
+	std::uint32_t _thread;
+	std::atomic<std::uint64_t> _head;
+	std::atomic<std::uint64_t> _tail;
+};
+
+/**
+* @class Tracer
+* Owns the per-thread rings. A thread's first tracepoint registers its ring
+* under a lock; every later one writes its own ring without any. Rings
+* outlive their threads, so a dump still has what exited threads traced.
+*/
+class Tracer {
+public:
+	/**
+	 * Returns the process-wide tracer.
+	 */
+	static Tracer& shared();
+
+	/**
+	 * Records a span on the calling thread's ring.
+	 */
+	void record(std::uint64_t start, std::uint64_t end, TracePhase phase);
+
+	/**
+	 * Sets the records per ring, for rings created after the call.
+	 */
+	void set_ring_capacity(std::size_t capacity);
+
+	/**
+	 * Measures TSC ticks per nanosecond against steady_clock over about
+	 * 10 ms, once; later calls return the first result.
+	 */
+	double calibrate();
+
+	/**
+	 * Writes every ring, oldest record first per thread, as a binary dump.
+	 *
+	 * @return The number of records written.
+	 */
+	std::size_t dump(std::ostream& out);
+	std::size_t dump(const std::string& path);
+
+	/**
+	 * Reads a dump back. Throws std::runtime_error if it isn't one.
+	 */
+	static TraceDump read(std::istream& in);
+
+	/**
+	 * Drops every record.
+	 */
+	void clear();
+
+	static constexpr std::size_t DEFAULT_RING_CAPACITY = 1 << 16;
+private:
+	Tracer();
+
+	/**
+	 * Returns the calling thread's ring, creating it on first use.
+	 */
+	TraceRing& ring();
+
+	std::mutex _mutex;
+	std::vector<std::shared_ptr<TraceRing>> _rings;
+	std::size_t _capacity;
+	std::once_flag _calibrated;
+	double _ticks_per_ns;
+};
+
+/**
+* @class TraceScope
+* Records the span from its construction to end() or its destruction,
+* whichever comes first.
+*/
+class TraceScope {
+public:
+	explicit TraceScope(TracePhase phase) :
+		_phase(phase),
+		_start(tsc()),
+		_done(false)
+	{
+		// do nothing
+	}
+
+	~TraceScope()
+	{
+		end();
+	}
+
+	TraceScope(const TraceScope& other) = delete;
+	TraceScope& operator=(const TraceScope& other) = delete;
+
+	void end()
+	{
+		if (!_done) {
+			_done = true;
+			Tracer::shared().record(_start, tsc(), _phase);
+		}
+	}
+private:
+	TracePhase _phase;
+	std::uint64_t _start;
+	bool _done;
+};
+}
@@ -6,11 +6,15 @@
  * @version 1.0
  * @since 2024-08-30
  *
- * Namespace for utility functions.
+ * Namespace for utility functions, and the workload generators the
+ * benchmarks and load drivers draw keys from.
  */
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace util {
@@ -19,8 +23,242 @@ namespace util {
  * Function to generate 'n' random numbers within a specified range.
  *
  * CREDIT: OpenAI's ChatGPT
- * PROMPT: in cpp give me a random number generator that generates n numbers 
+ * PROMPT: in cpp give me a random number generator that generates n numbers
+ *
+ * @param seed The same seed gives the same numbers.
  */
-std::vector<int> generate_random(int n, int min, int max);
+std::vector<int> generate_random(int n, int min, int max,
+	std::uint64_t seed = 1);
+
+/**
+* @class SplitMix64
+* Vigna's splitmix64: one add and a mix per number. Weak as a generator on
+* its own, but any seed, even 0, gives well-spread output, so it is used to
+* seed Xoshiro256.
+*/
+class SplitMix64 {
+public:
+	explicit SplitMix64(std::uint64_t seed) : _state(seed) {}
+
+	std::uint64_t next();
+private:
+	std::uint64_t _state;
+};
+
+/**
+* @class Xoshiro256
+* xoshiro256** (Blackman and Vigna): 256 bits of state, a few shifts and
+* rotates per number, and good statistical quality. Meets the standard
+* UniformRandomBitGenerator requirements, so it also works with <random>.
+*/
+class Xoshiro256 {
+public:
+	using result_type = std::uint64_t;
+
+	explicit Xoshiro256(std::uint64_t seed = 1);
+
+	std::uint64_t next();
+
+	/**
+	 * Returns a double uniform in [0, 1).
+	 */
+	double uniform();
+
+	/**
+	 * Returns an integer uniform in [0, n), by Lemire's multiply-shift,
+	 * with no division in the common case.
+	 */
+	std::uint64_t below(std::uint64_t n);
+
+	std::uint64_t operator()() { return next(); }
+	static constexpr std::uint64_t min() { return 0; }
+	static constexpr std::uint64_t max()
+	{
+		return std::numeric_limits<std::uint64_t>::max();
+	}
+private:
+	std::uint64_t _s[4];
+};
+
+/**
+* @enum Distribution
+* How keys are drawn from 0..items-1.
+*/
+enum class Distribution {
+	UNIFORM,			// Every key equally likely.
+	ZIPFIAN,			// Key k has weight 1/(k+1)^theta: low keys are hot.
+	SCRAMBLED_ZIPFIAN,	// Zipfian ranks permuted over the key space.
+	HOTSPOT,			// hot_ops of draws go to the first hot_fraction keys.
+	LATEST,				// Zipfian from the newest key down.
+	SEQUENTIAL			// 0, 1, ..., items-1, 0, ...
+};
+
+/**
+* @struct KeyOptions
+* A key distribution and its parameters.
+*/
+struct KeyOptions {
+	Distribution distribution = Distribution::ZIPFIAN;
+	std::uint64_t items = 1000000;		// The key space.
+	double theta = 0.99;				// Zipfian skew, in (0, 1).
+	double hot_fraction = 0.2;			// HOTSPOT: share of keys that are hot.
+	double hot_ops = 0.8;				// HOTSPOT: share of draws that hit them.
+	std::uint64_t seed = 1;
+};
+
+/**
+* @class Zipfian
+* Zipfian ranks in 0..items-1 by Gray et al.'s method, as in YCSB: O(items)
+* once to sum the weights, then O(1) per draw. The item count can grow; the
+* sum is extended, not recomputed.
+*/
+class Zipfian {
+public:
+	Zipfian(std::uint64_t items, double theta);
+
+	std::uint64_t next(Xoshiro256& rng);
+
+	/**
+	 * Extends the range to 0..items-1.
+	 */
+	void grow(std::uint64_t items);
+
+	std::uint64_t items() const { return _items; }
+private:
+	double eta() const;
+
+	std::uint64_t _items;
+	double _theta;
+	double _alpha;
+	double _zeta2;
+	double _zetan;
+	double _eta;
+};
+
+/**
+* @class KeyGenerator
+* Draws keys by a Distribution. fill() writes many at a time into a buffer
+* the caller allocates once, so drawing stays off a benchmark's clock.
+*/
+class KeyGenerator {
+public:
+	explicit KeyGenerator(const KeyOptions& options);
+
+	std::uint64_t next();
+
+	/**
+	 * Writes n keys to out.
+	 */
+	void fill(std::uint64_t *out, std::size_t n);
+
+	/**
+	 * Grows the key space, for workloads that insert; LATEST then favors
+	 * the new keys.
+	 */
+	void grow(std::uint64_t items);
+
+	std::uint64_t items() const { return _options.items; }
+private:
+	KeyOptions _options;
+	Xoshiro256 _rng;
+	Zipfian _zipf;
+	std::uint64_t _hot;
+	std::uint64_t _sequence;
+};
+
+/**
+* @struct ValueSizeOptions
+* Value sizes in bytes: UNIFORM over [min, max], ZIPFIAN favoring min, or
+* min always if min == max.
+*/
+struct ValueSizeOptions {
+	std::uint32_t min = 100;
+	std::uint32_t max = 100;
+	Distribution distribution = Distribution::UNIFORM;
+};
+
+/**
+* @enum OpType
+* A YCSB operation.
+*/
+enum class OpType : std::uint8_t {
+	READ,
+	UPDATE,
+	INSERT,
+	SCAN,
+	READ_MODIFY_WRITE
+};
+
+/**
+* @struct Op
+* One operation of a workload. length is the value size, or for a SCAN the
+* number of keys.
+*/
+struct Op {
+	std::uint64_t key;
+	std::uint32_t length;
+	OpType type;
+};
+
+/**
+* @struct WorkloadOptions
+* An operation mix over a key distribution. Proportions are normalized.
+*/
+struct WorkloadOptions {
+	double read = 1.0;
+	double update = 0.0;
+	double insert = 0.0;
+	double scan = 0.0;
+	double read_modify_write = 0.0;
+	KeyOptions keys;
+	ValueSizeOptions values;
+	std::uint32_t max_scan_length = 100;	// Scans are uniform in 1..this.
+	// The first INSERT adds key items + insert_offset, each next one
+	// insert_stride past it, so generators on several threads can insert
+	// disjoint keys.
+	std::uint64_t insert_offset = 0;
+	std::uint64_t insert_stride = 1;
+};
+
+/**
+ * Returns the mix of YCSB core workload A to F over items keys:
+ *   A  50% read, 50% update, zipfian
+ *   B  95% read, 5% update, zipfian
+ *   C  100% read, zipfian
+ *   D  95% read, 5% insert, latest
+ *   E  95% scan, 5% insert, zipfian
+ *   F  50% read, 50% read-modify-write, zipfian
+ * Throws std::invalid_argument for any other letter.
+ */
+WorkloadOptions ycsb(char workload, std::uint64_t items,
+	std::uint64_t seed = 1);
+
+/**
+* @class Workload
+* Generates Ops by a WorkloadOptions. An INSERT adds the next key past the
+* key space and grows the space to it, so later draws can reach it.
+*/
+class Workload {
+public:
+	explicit Workload(const WorkloadOptions& options);
+
+	Op next();
+
+	/**
+	 * Writes n operations to out.
+	 */
+	void fill(Op *out, std::size_t n);
+
+	std::uint64_t items() const { return _keys.items(); }
+private:
+	std::uint32_t value_size();
 
+	WorkloadOptions _options;
+	KeyGenerator _keys;
+	std::uint64_t _next_insert;
+	Xoshiro256 _rng;
+	Zipfian _sizes;
+	// Cumulative thresholds for read, update, insert, scan.
+	double _cut[4];
+};
 }
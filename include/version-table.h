@@ -0,0 +1,69 @@
+/**
+ * @file version-table.h
+ * @class VersionTable
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Striped version counters that let copies of cache entries held outside
+ * the cache check that they are still current.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @class VersionTable
+* One version counter per stripe of the key space. The owner bumps a key's
+* stripe whenever the key's entry changes or leaves, with the entry's lock
+* held. A copy taken under that lock together with the stripe's version is
+* current for as long as the version is unchanged, which a reader checks
+* with a single atomic load. A bump to another key of the stripe also
+* invalidates the copy; that only costs a refill.
+*/
+class VersionTable {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param std::size_t stripes Rounded up to a power of two.
+	 */
+	explicit VersionTable(std::size_t stripes = DEFAULT_STRIPES);
+
+	/**
+	 * Returns the stripe of a key with the given hash.
+	 */
+	std::size_t stripe(std::size_t hash) const;
+
+	/**
+	 * Returns the stripe's current version.
+	 */
+	std::uint64_t current(std::size_t stripe) const;
+
+	/**
+	 * Invalidates every copy taken from the stripe.
+	 */
+	void bump(std::size_t stripe);
+
+	/**
+	 * Invalidates every copy.
+	 */
+	void bump_all();
+
+	static constexpr std::size_t DEFAULT_STRIPES = 4096;
+private:
+	std::unique_ptr<std::atomic<std::uint64_t>[]> _versions;
+	std::size_t _mask;
+};
+}
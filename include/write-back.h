@@ -0,0 +1,141 @@
+/**
+ * @file write-back.h
+ * @class WriteBack
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Dirty-entry tracking and batched background flushing for a write-back
+ * CacheManager.
+ */
+
+#pragma once
+
+#include "backing-store.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+* @namespace csc
+* Namespace for CacheManager-specific packages.
+*/
+namespace csc {
+
+/**
+* @struct WriteBackOptions
+* Tuning for a WriteBack.
+*/
+struct WriteBackOptions {
+	std::size_t batch_size = 256;	// Flush early once this many are dirty.
+	std::chrono::milliseconds interval{100};	// Flush at least this often.
+};
+
+/**
+* @class WriteBack
+* Holds the latest unflushed value of each dirty key. A put to a key that is
+* already dirty replaces its pending value, so the store only sees the last
+* write of each interval. A background thread pushes the dirty set to the
+* store in batches; flush(key) writes one key through synchronously, which a
+* cache must do before it evicts a dirty entry.
+*
+* Writes to the store are serialized, so a synchronous flush can never be
+* overtaken by an older value from a batch already in flight. The flusher
+* serializes per batch, not per drain, so a synchronous flush waits for at
+* most the batch in flight. A batch that fails is put back, behind any newer
+* value, and retried.
+*/
+template <typename K, typename V>
+class WriteBack {
+public:
+	/**
+	 * Constructor. Starts the flusher thread.
+	 *
+	 * @param BackingStore store The store to flush to; must outlive WriteBack.
+	 * @param WriteBackOptions options Batch size and interval.
+	 */
+	WriteBack(BackingStore<K, V>& store,
+		const WriteBackOptions& options = WriteBackOptions());
+
+	/**
+	 * Destructor. Flushes every dirty key and stops the flusher.
+	 */
+	~WriteBack();
+
+	// Disallow copy and assignment.
+	WriteBack(const WriteBack& other) = delete;
+	WriteBack& operator=(const WriteBack& other) = delete;
+
+	/**
+	 * Records value as the key's pending write.
+	 */
+	void mark_dirty(const K& key, const V& value);
+
+	/**
+	 * Checks whether the key has a pending write.
+	 */
+	bool dirty(const K& key);
+
+	/**
+	 * Writes the key's pending write, if any, to the store before returning.
+	 * Throws whatever the store throws; the write stays pending.
+	 */
+	void flush(const K& key);
+
+	/**
+	 * Writes every pending write to the store before returning.
+	 */
+	void flush_all();
+
+	/**
+	 * Returns the number of pending writes.
+	 */
+	std::size_t pending();
+
+	/**
+	 * Returns the number of puts absorbed by an already-pending write.
+	 */
+	std::uint64_t coalesced();
+
+	/**
+	 * Returns the number of failed store writes.
+	 */
+	std::uint64_t errors();
+private:
+	/**
+	 * Flusher loop.
+	 */
+	void run();
+
+	/**
+	 * Takes up to max pending writes and writes them. Called with
+	 * _write_mutex held; takes _mutex itself.
+	 *
+	 * @return The number of pairs written.
+	 */
+	std::size_t write_some(std::size_t max);
+
+	BackingStore<K, V>& _store;
+	WriteBackOptions _options;
+	// Lock order: _write_mutex, then _mutex.
+	std::mutex _write_mutex;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::unordered_map<K, V> _dirty;
+	std::uint64_t _coalesced;
+	std::uint64_t _errors;
+	std::atomic<std::size_t> _waiting;	// flush() calls after the write lock.
+	bool _stop;
+	std::thread _flusher;
+};
+}
+#include "write-back.tpp"
@@ -0,0 +1,165 @@
+/**
+ * @file alloc-counter.cpp
+ * @class AllocCounter
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * AllocCounter implementation, and the replacement global operator new and
+ * delete. Link this only into test and benchmark executables.
+ */
+
+#include "alloc-counter.h"
+
+#include <cstdlib>
+
+using namespace csc;
+
+namespace {
+// Plain data, so it needs no constructor and is safe to touch from the
+// first operator new of a thread.
+thread_local AllocStats counts;
+
+// As the standard operator new does on failure: call the new_handler,
+// which may free memory, then retry; throw if there is none.
+void out_of_memory()
+{
+	std::new_handler handler = std::get_new_handler();
+	if (handler == nullptr) {
+		throw std::bad_alloc();
+	}
+	handler();
+}
+
+void* allocate(std::size_t size)
+{
+	for (;;) {
+		// malloc(0) may return nullptr; new must not.
+		void *p = std::malloc(size == 0 ? 1 : size);
+		if (p != nullptr) {
+			AllocCounter::allocated(size);
+			return p;
+		}
+		out_of_memory();
+	}
+}
+
+void* allocate(std::size_t size, std::align_val_t align)
+{
+	std::size_t alignment = static_cast<std::size_t>(align);
+	if (alignment < sizeof(void*)) {
+		alignment = sizeof(void*);
+	}
+	for (;;) {
+		void *p = nullptr;
+		if (::posix_memalign(&p, alignment, size == 0 ? 1 : size) == 0) {
+			AllocCounter::allocated(size);
+			return p;
+		}
+		out_of_memory();
+	}
+}
+
+void release(void* p) noexcept
+{
+	if (p != nullptr) {
+		AllocCounter::deallocated();
+		std::free(p);
+	}
+}
+}
+
+AllocStats AllocCounter::thread()
+{
+	return counts;
+}
+
+void AllocCounter::allocated(std::size_t bytes) noexcept
+{
+	++counts.allocations;
+	counts.bytes += bytes;
+}
+
+void AllocCounter::deallocated() noexcept
+{
+	++counts.deallocations;
+}
+
+void* operator new(std::size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return allocate(size);
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return allocate(size);
+	} catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+	return allocate(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+	return allocate(size, align);
+}
+
+void operator delete(void* p) noexcept
+{
+	release(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	release(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	release(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	release(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	release(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+	release(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+	release(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+	release(p);
+}
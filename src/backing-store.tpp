@@ -0,0 +1,90 @@
+/**
+ * @file backing-store.tpp
+ * @class FileStore
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * FileStore implementation.
+ */
+
+#include "backing-store.h"
+
+#include <ios>
+#include <stdexcept>
+
+using namespace csc;
+
+template <typename K, typename V>
+FileStore<K, V>::FileStore(const std::string& path) : _batches(0), _writes(0)
+{
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (in) {
+			BinaryReader reader(in);
+			// Replay until the log runs out; a torn last record is dropped.
+			try {
+				for (;;) {
+					K key = Codec<K>::read(reader);
+					_values[key] = Codec<V>::read(reader);
+				}
+			} catch (const std::runtime_error&) {
+				// End of log.
+			}
+		}
+	}
+	_log.open(path, std::ios::binary | std::ios::app);
+	if (!_log) {
+		throw std::ios_base::failure("Cannot open " + path);
+	}
+}
+
+template <typename K, typename V>
+void FileStore<K, V>::write_batch(const std::vector<std::pair<K, V>>& batch)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	{
+		BinaryWriter writer(_log);
+		for (const auto& kv : batch) {
+			Codec<K>::write(writer, kv.first);
+			Codec<V>::write(writer, kv.second);
+		}
+		writer.flush();
+	}
+	_log.flush();
+	if (!_log) {
+		throw std::ios_base::failure("FileStore write failed");
+	}
+	for (const auto& kv : batch) {
+		_values[kv.first] = kv.second;
+	}
+	++_batches;
+	_writes += batch.size();
+}
+
+template <typename K, typename V>
+bool FileStore<K, V>::read(const K& key, V& value)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _values.find(key);
+	if (it == _values.end()) {
+		return false;
+	}
+	value = it->second;
+	return true;
+}
+
+template <typename K, typename V>
+std::uint64_t FileStore<K, V>::batches()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _batches;
+}
+
+template <typename K, typename V>
+std::uint64_t FileStore<K, V>::writes()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _writes;
+}
@@ -0,0 +1,514 @@
+/**
+ * @file bench-main.cpp
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Entry point of cache-bench: the containers and CacheManager against
+ * their standard library counterparts.
+ *
+ * Usage: cache-bench [--filter=<substring>] [--reps=<n>] [--warmup=<n>]
+ *                    [--json] [--out=<file>]
+ */
+
+#include "bench.h"
+#include "singly-linked-list.h"
+#include "doubly-linked-list.h"
+#include "hash-map.h"
+#include "bst.h"
+#include "bplus-tree.h"
+#include "thread-pool.h"
+#include "cache-manager.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace csc;
+
+namespace {
+// Lists are scanned linearly, so they get the small size only.
+constexpr std::size_t LIST_SIZE = 1000;
+const std::vector<std::size_t> MAP_SIZES = {1000, 100000};
+// Point lookups go on to where the tree no longer fits in cache.
+const std::vector<std::size_t> TREE_SIZES = {1000, 100000, 10000000};
+// Entries per bucket.
+const std::vector<double> LOAD_FACTORS = {0.5, 1.0, 4.0};
+
+std::vector<int> shuffled(std::size_t n, std::uint64_t seed)
+{
+	std::vector<int> keys(n);
+	std::iota(keys.begin(), keys.end(), 0);
+	std::mt19937_64 rng(seed);
+	std::shuffle(keys.begin(), keys.end(), rng);
+	return keys;
+}
+
+std::string label(const std::string& what, std::size_t n)
+{
+	return what + "/n=" + std::to_string(n);
+}
+
+/**
+* CacheManager's constructor is protected; it is a singleton.
+*/
+class BenchCache : public CacheManager<int, int> {
+public:
+	explicit BenchCache(std::size_t capacity) : CacheManager(capacity) {}
+};
+
+/**
+* The textbook LRU cache, as the baseline for CacheManager.
+*/
+class StdLru {
+public:
+	explicit StdLru(std::size_t capacity) : _capacity(capacity) {}
+
+	int* get(int key)
+	{
+		auto it = _index.find(key);
+		if (it == _index.end()) {
+			return nullptr;
+		}
+		_order.splice(_order.begin(), _order, it->second);
+		return &it->second->second;
+	}
+
+	void insert(int key, int value)
+	{
+		auto it = _index.find(key);
+		if (it != _index.end()) {
+			it->second->second = value;
+			_order.splice(_order.begin(), _order, it->second);
+			return;
+		}
+		if (_index.size() >= _capacity) {
+			_index.erase(_order.back().first);
+			_order.pop_back();
+		}
+		_order.emplace_front(key, value);
+		_index[key] = _order.begin();
+	}
+private:
+	std::size_t _capacity;
+	std::list<std::pair<int, int>> _order;
+	std::unordered_map<int, std::list<std::pair<int, int>>::iterator> _index;
+};
+
+void singly_linked_list(Bench& bench)
+{
+	std::vector<int> keys = shuffled(LIST_SIZE, 1);
+	std::unique_ptr<SinglyLinkedList<int>> list;
+	auto fill = [&]() {
+		list = std::make_unique<SinglyLinkedList<int>>();
+		for (int k : keys) {
+			list->insert(k);
+		}
+	};
+
+	bench.run(label("singly-linked-list/insert", LIST_SIZE), LIST_SIZE,
+		[&]() { list = std::make_unique<SinglyLinkedList<int>>(); },
+		[&]() {
+			for (int k : keys) {
+				list->insert(k);
+			}
+		});
+	fill();
+	bench.run(label("singly-linked-list/contains", LIST_SIZE), LIST_SIZE,
+		[&]() {
+			for (int k : keys) {
+				do_not_optimize(list->contains(k));
+			}
+		});
+	bench.run(label("singly-linked-list/remove", LIST_SIZE), LIST_SIZE, fill,
+		[&]() {
+			for (int k : keys) {
+				do_not_optimize(list->remove(k));
+			}
+		});
+}
+
+void doubly_linked_list(Bench& bench)
+{
+	std::vector<int> keys = shuffled(LIST_SIZE, 2);
+	std::unique_ptr<DoublyLinkedList<int>> list;
+	auto fill = [&]() {
+		list = std::make_unique<DoublyLinkedList<int>>();
+		for (int k : keys) {
+			list->push_front(k);
+		}
+	};
+	std::list<int> baseline;
+	auto fill_baseline = [&]() {
+		baseline.assign(keys.begin(), keys.end());
+	};
+
+	bench.run(label("doubly-linked-list/push-front", LIST_SIZE), LIST_SIZE,
+		[&]() { list = std::make_unique<DoublyLinkedList<int>>(); },
+		[&]() {
+			for (int k : keys) {
+				list->push_front(k);
+			}
+		});
+	bench.run(label("std-list/push-front", LIST_SIZE), LIST_SIZE,
+		[&]() { baseline.clear(); },
+		[&]() {
+			for (int k : keys) {
+				baseline.push_front(k);
+			}
+		});
+	bench.run(label("doubly-linked-list/pop-back", LIST_SIZE), LIST_SIZE,
+		fill, [&]() {
+			for (std::size_t i = 0; i < LIST_SIZE; ++i) {
+				do_not_optimize(list->pop_back());
+			}
+		});
+	bench.run(label("std-list/pop-back", LIST_SIZE), LIST_SIZE,
+		fill_baseline, [&]() {
+			for (std::size_t i = 0; i < LIST_SIZE; ++i) {
+				baseline.pop_back();
+			}
+		});
+	bench.run(label("doubly-linked-list/remove", LIST_SIZE), LIST_SIZE, fill,
+		[&]() {
+			for (int k : keys) {
+				do_not_optimize(list->remove(k));
+			}
+		});
+	bench.run(label("std-list/remove", LIST_SIZE), LIST_SIZE, fill_baseline,
+		[&]() {
+			for (int k : keys) {
+				baseline.remove(k);
+			}
+		});
+}
+
+void hash_map(Bench& bench)
+{
+	for (std::size_t n : MAP_SIZES) {
+		std::vector<int> keys = shuffled(n, 3);
+		std::vector<int> lookups = shuffled(n, 4);
+		for (double load : LOAD_FACTORS) {
+			std::size_t buckets = std::max<std::size_t>(
+				static_cast<std::size_t>(static_cast<double>(n) / load), 1);
+			std::string suffix = "/lf=" + std::to_string(load).substr(0, 3);
+			std::unique_ptr<HashMap<int, int>> map;
+			auto fresh = [&]() {
+				map = std::make_unique<HashMap<int, int>>(buckets);
+			};
+			auto fill = [&]() {
+				fresh();
+				for (int k : keys) {
+					map->insert(k, k);
+				}
+			};
+			std::unordered_map<int, int> baseline;
+			auto fresh_baseline = [&]() {
+				baseline = std::unordered_map<int, int>();
+				baseline.max_load_factor(static_cast<float>(load));
+				baseline.rehash(buckets);
+			};
+			auto fill_baseline = [&]() {
+				fresh_baseline();
+				for (int k : keys) {
+					baseline.emplace(k, k);
+				}
+			};
+
+			bench.run(label("hash-map/insert", n) + suffix, n, fresh, [&]() {
+				for (int k : keys) {
+					map->insert(k, k);
+				}
+			});
+			bench.run(label("std-unordered-map/insert", n) + suffix, n,
+				fresh_baseline, [&]() {
+					for (int k : keys) {
+						baseline.emplace(k, k);
+					}
+				});
+			fill();
+			fill_baseline();
+			bench.run(label("hash-map/get", n) + suffix, n, [&]() {
+				for (int k : lookups) {
+					int *v = map->get(k);
+					do_not_optimize(v);
+				}
+			});
+			bench.run(label("std-unordered-map/get", n) + suffix, n, [&]() {
+				for (int k : lookups) {
+					do_not_optimize(baseline.find(k));
+				}
+			});
+			bench.run(label("hash-map/remove", n) + suffix, n, fill, [&]() {
+				for (int k : lookups) {
+					do_not_optimize(map->remove(k));
+				}
+			});
+			bench.run(label("std-unordered-map/remove", n) + suffix, n,
+				fill_baseline, [&]() {
+					for (int k : lookups) {
+						do_not_optimize(baseline.erase(k));
+					}
+				});
+		}
+	}
+}
+
+void bst(Bench& bench)
+{
+	for (std::size_t n : MAP_SIZES) {
+		std::vector<int> keys = shuffled(n, 5);
+		std::vector<int> lookups = shuffled(n, 6);
+		std::unique_ptr<BST> tree;
+		auto fill = [&]() {
+			tree = std::make_unique<BST>();
+			for (int k : keys) {
+				tree->insert(new Node(k));
+			}
+		};
+		std::set<int> baseline;
+		auto fill_baseline = [&]() {
+			baseline = std::set<int>(keys.begin(), keys.end());
+		};
+
+		bench.run(label("bst/insert", n), n,
+			[&]() { tree = std::make_unique<BST>(); },
+			[&]() {
+				for (int k : keys) {
+					tree->insert(new Node(k));
+				}
+			});
+		bench.run(label("std-set/insert", n), n, [&]() { baseline.clear(); },
+			[&]() {
+				for (int k : keys) {
+					baseline.insert(k);
+				}
+			});
+		fill();
+		fill_baseline();
+		bench.run(label("bst/search", n), n, [&]() {
+			for (int k : lookups) {
+				do_not_optimize(tree->search(k));
+			}
+		});
+		bench.run(label("std-set/search", n), n, [&]() {
+			for (int k : lookups) {
+				do_not_optimize(baseline.count(k));
+			}
+		});
+		bench.run(label("bst/remove", n), n, fill, [&]() {
+			for (int k : lookups) {
+				tree->remove(k);
+			}
+		});
+		bench.run(label("std-set/remove", n), n, fill_baseline, [&]() {
+			for (int k : lookups) {
+				baseline.erase(k);
+			}
+		});
+	}
+}
+
+void bplus_tree(Bench& bench)
+{
+	ThreadPool pool;
+	for (std::size_t n : TREE_SIZES) {
+		std::vector<int> keys = shuffled(n, 9);
+		std::vector<int> lookups = shuffled(n, 10);
+		std::unique_ptr<BPlusTree<int, int>> tree;
+		std::map<int, int> baseline;
+		if (n <= MAP_SIZES.back()) {
+			bench.run(label("bplus-tree/insert", n), n,
+				[&]() { tree = std::make_unique<BPlusTree<int, int>>(); },
+				[&]() {
+					for (int k : keys) {
+						tree->insert(k, k);
+					}
+				});
+			bench.run(label("std-map/insert", n), n,
+				[&]() { baseline.clear(); },
+				[&]() {
+					for (int k : keys) {
+						baseline.emplace(k, k);
+					}
+				});
+		}
+		// Sorted input: bulk loading against inserting it in order.
+		std::vector<std::pair<int, int>> sorted(n);
+		for (std::size_t i = 0; i < n; ++i) {
+			sorted[i] = {static_cast<int>(i), static_cast<int>(i)};
+		}
+		BulkLoadOptions options;
+		bench.run(label("bplus-tree/bulk-load", n), n,
+			[&]() { tree = std::make_unique<BPlusTree<int, int>>(); },
+			[&]() { tree->bulk_load(sorted.begin(), sorted.end(), options); });
+		options.pool = &pool;
+		bench.run(label("bplus-tree/bulk-load-parallel", n), n,
+			[&]() { tree = std::make_unique<BPlusTree<int, int>>(); },
+			[&]() { tree->bulk_load(sorted.begin(), sorted.end(), options); });
+		if (n <= MAP_SIZES.back()) {
+			bench.run(label("bplus-tree/insert-sorted", n), n,
+				[&]() { tree = std::make_unique<BPlusTree<int, int>>(); },
+				[&]() {
+					for (const auto& pair : sorted) {
+						tree->insert(pair.first, pair.second);
+					}
+				});
+		}
+
+		tree = std::make_unique<BPlusTree<int, int>>();
+		baseline.clear();
+		for (int k : keys) {
+			tree->insert(k, k);
+			baseline.emplace(k, k);
+		}
+		bench.run(label("bplus-tree/find", n), n, [&]() {
+			for (int k : lookups) {
+				do_not_optimize(tree->find(k));
+			}
+		});
+		bench.run(label("std-map/find", n), n, [&]() {
+			for (int k : lookups) {
+				do_not_optimize(baseline.find(k));
+			}
+		});
+		int from = static_cast<int>(n / 4);
+		int to = from + static_cast<int>(n / 2);
+		bench.run(label("bplus-tree/scan", n), n / 2, [&]() {
+			long sum = 0;
+			tree->scan(from, to, [&](int, int v) { sum += v; });
+			do_not_optimize(sum);
+		});
+		bench.run(label("std-map/scan", n), n / 2, [&]() {
+			long sum = 0;
+			auto end = baseline.lower_bound(to);
+			for (auto it = baseline.lower_bound(from); it != end; ++it) {
+				sum += it->second;
+			}
+			do_not_optimize(sum);
+		});
+	}
+}
+
+void cache_manager(Bench& bench)
+{
+	for (std::size_t n : MAP_SIZES) {
+		std::vector<int> keys = shuffled(n, 7);
+		std::vector<int> lookups = shuffled(n, 8);
+		// Keys n..2n-1 are never inserted.
+		std::vector<int> absent(lookups);
+		for (int& k : absent) {
+			k += static_cast<int>(n);
+		}
+		BenchCache cache(n);
+		StdLru baseline(n);
+		for (int k : keys) {
+			cache.insert(k, k);
+			baseline.insert(k, k);
+		}
+
+		bench.run(label("cache-manager/get-hit", n), n, [&]() {
+			for (int k : lookups) {
+				do_not_optimize(cache.get(k));
+			}
+		});
+		bench.run(label("std-lru/get-hit", n), n, [&]() {
+			for (int k : lookups) {
+				do_not_optimize(baseline.get(k));
+			}
+		});
+		bench.run(label("cache-manager/get-miss", n), n, [&]() {
+			for (int k : absent) {
+				do_not_optimize(cache.get(k));
+			}
+		});
+		bench.run(label("std-lru/get-miss", n), n, [&]() {
+			for (int k : absent) {
+				do_not_optimize(baseline.get(k));
+			}
+		});
+		bench.run(label("cache-manager/put-update", n), n, [&]() {
+			for (int k : lookups) {
+				cache.insert(k, k + 1);
+			}
+		});
+		bench.run(label("std-lru/put-update", n), n, [&]() {
+			for (int k : lookups) {
+				baseline.insert(k, k + 1);
+			}
+		});
+		// Every insert of a new key evicts one: the cache is full.
+		int next = static_cast<int>(2 * n);
+		bench.run(label("cache-manager/put-evict", n), n, [&]() {
+			for (std::size_t i = 0; i < n; ++i) {
+				cache.insert(next++, 0);
+			}
+		});
+		next = static_cast<int>(2 * n);
+		bench.run(label("std-lru/put-evict", n), n, [&]() {
+			for (std::size_t i = 0; i < n; ++i) {
+				baseline.insert(next++, 0);
+			}
+		});
+	}
+}
+}
+
+int main(int argc, char **argv)
+{
+	BenchOptions options;
+	bool json = false;
+	std::string out_path;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--json") {
+			json = true;
+		} else if (arg.rfind("--filter=", 0) == 0) {
+			options.filter = arg.substr(9);
+		} else if (arg.rfind("--reps=", 0) == 0) {
+			options.repetitions = std::strtoul(arg.c_str() + 7, nullptr, 10);
+		} else if (arg.rfind("--warmup=", 0) == 0) {
+			options.warmup = std::strtoul(arg.c_str() + 9, nullptr, 10);
+		} else if (arg.rfind("--out=", 0) == 0) {
+			out_path = arg.substr(6);
+			json = true;
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--filter=<substring>]" <<
+				" [--reps=<n>] [--warmup=<n>] [--json] [--out=<file>]\n";
+			return 2;
+		}
+	}
+
+	Bench bench(options);
+	singly_linked_list(bench);
+	doubly_linked_list(bench);
+	hash_map(bench);
+	bst(bench);
+	bplus_tree(bench);
+	cache_manager(bench);
+
+	if (!out_path.empty()) {
+		std::ofstream out(out_path);
+		if (!out) {
+			std::cerr << "Cannot open " << out_path << '\n';
+			return 1;
+		}
+		bench.json(out);
+	} else if (json) {
+		bench.json(std::cout);
+	} else {
+		bench.report(std::cout);
+	}
+	return 0;
+}
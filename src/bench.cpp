@@ -0,0 +1,154 @@
+/**
+ * @file bench.cpp
+ * @class Bench
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Bench implementation.
+ */
+
+#include "bench.h"
+#include "alloc-counter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+using namespace csc;
+
+namespace {
+// Nearest-rank percentile of sorted values.
+double percentile(const std::vector<double>& sorted, double p)
+{
+	std::size_t rank = static_cast<std::size_t>(
+		std::ceil(p * static_cast<double>(sorted.size())));
+	return sorted[std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1];
+}
+
+void json_string(std::ostream& out, const std::string& s)
+{
+	out << '"';
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			out << '\\';
+		}
+		out << c;
+	}
+	out << '"';
+}
+}
+
+Bench::Bench(const BenchOptions& options) :
+	_options(options)
+{
+	_options.repetitions = std::max<std::size_t>(_options.repetitions, 1);
+}
+
+void Bench::run(const std::string& name, std::size_t ops, const Body& body)
+{
+	run(name, ops, Body(), body);
+}
+
+void Bench::run(const std::string& name, std::size_t ops, const Body& setup,
+	const Body& body)
+{
+	if (!_options.filter.empty() &&
+		name.find(_options.filter) == std::string::npos) {
+		return;
+	}
+	ops = std::max<std::size_t>(ops, 1);
+	for (std::size_t i = 0; i < _options.warmup; ++i) {
+		if (setup) {
+			setup();
+		}
+		body();
+	}
+	std::vector<double> per_op;
+	per_op.reserve(_options.repetitions);
+	AllocStats allocs;
+	for (std::size_t i = 0; i < _options.repetitions; ++i) {
+		if (setup) {
+			setup();
+		}
+		AllocScope scope;
+		Clock::time_point start = Clock::now();
+		body();
+		double ns = std::chrono::duration<double, std::nano>(
+			Clock::now() - start).count();
+		AllocStats run = scope.stats();
+		allocs.allocations += run.allocations;
+		allocs.bytes += run.bytes;
+		per_op.push_back(ns / static_cast<double>(ops));
+	}
+	std::sort(per_op.begin(), per_op.end());
+
+	BenchResult result;
+	result.name = name;
+	result.ops = ops;
+	result.repetitions = per_op.size();
+	result.median_ns = percentile(per_op, 0.5);
+	result.min_ns = per_op.front();
+	result.max_ns = per_op.back();
+	result.ops_per_sec = result.median_ns > 0 ? 1e9 / result.median_ns : 0;
+	double total = static_cast<double>(ops * per_op.size());
+	result.allocs_per_op = static_cast<double>(allocs.allocations) / total;
+	result.bytes_per_op = static_cast<double>(allocs.bytes) / total;
+	_results.push_back(result);
+}
+
+const std::vector<BenchResult>& Bench::results() const
+{
+	return _results;
+}
+
+void Bench::report(std::ostream& out) const
+{
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	std::size_t width = 4;
+	for (const BenchResult& result : _results) {
+		width = std::max(width, result.name.size());
+	}
+	out << std::left << std::setw(static_cast<int>(width)) << "name" <<
+		std::right << std::setw(14) << "median ns/op" << std::setw(12) <<
+		"max ns/op" << std::setw(16) << "ops/s" << std::setw(12) <<
+		"allocs/op" << std::setw(12) << "bytes/op" << '\n';
+	out << std::fixed;
+	for (const BenchResult& result : _results) {
+		out << std::left << std::setw(static_cast<int>(width)) <<
+			result.name << std::right << std::setprecision(2) <<
+			std::setw(14) << result.median_ns << std::setw(12) <<
+			result.max_ns << std::setprecision(0) << std::setw(16) <<
+			result.ops_per_sec << std::setprecision(2) << std::setw(12) <<
+			result.allocs_per_op << std::setw(12) << result.bytes_per_op <<
+			'\n';
+	}
+	out.flags(flags);
+	out.precision(precision);
+}
+
+void Bench::json(std::ostream& out) const
+{
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::defaultfloat << std::setprecision(10);
+	out << "{\n  \"benchmarks\": [";
+	for (std::size_t i = 0; i < _results.size(); ++i) {
+		const BenchResult& result = _results[i];
+		out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+		json_string(out, result.name);
+		out << ", \"ops\": " << result.ops <<
+			", \"repetitions\": " << result.repetitions <<
+			", \"median_ns\": " << result.median_ns <<
+			", \"min_ns\": " << result.min_ns <<
+			", \"max_ns\": " << result.max_ns <<
+			", \"ops_per_sec\": " << result.ops_per_sec <<
+			", \"allocs_per_op\": " << result.allocs_per_op <<
+			", \"bytes_per_op\": " << result.bytes_per_op << "}";
+	}
+	out << "\n  ]\n}\n";
+	out.flags(flags);
+	out.precision(precision);
+}
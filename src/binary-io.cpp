@@ -0,0 +1,177 @@
+/**
+ * @file binary-io.cpp
+ * @class BinaryWriter, BinaryReader, Codec
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Buffered binary stream and dump format implementation.
+ */
+
+#include "binary-io.h"
+
+#include <algorithm>
+#include <ios>
+#include <limits>
+#include <stdexcept>
+#include <streambuf>
+
+using namespace csc;
+
+BinaryWriter::BinaryWriter(std::ostream& out, std::size_t buffer) :
+	_out(out), _buffer(std::max<std::size_t>(buffer, 64)), _used(0)
+{
+	// do nothing
+}
+
+BinaryWriter::~BinaryWriter()
+{
+	// Destructors must not throw; callers that care call flush() themselves.
+	try {
+		flush();
+	} catch (...) {
+		// do nothing
+	}
+}
+
+void BinaryWriter::write(const void* data, std::size_t n)
+{
+	const char *bytes = static_cast<const char*>(data);
+	// Large writes go straight to the stream instead of through the buffer.
+	if (n >= _buffer.size()) {
+		flush();
+		if (!_out.write(bytes, n)) {
+			throw std::ios_base::failure("Binary write failed");
+		}
+		return;
+	}
+	if (_used + n > _buffer.size()) {
+		flush();
+	}
+	std::memcpy(_buffer.data() + _used, bytes, n);
+	_used += n;
+}
+
+void BinaryWriter::flush()
+{
+	if (_used == 0) {
+		return;
+	}
+	if (!_out.write(_buffer.data(), _used)) {
+		throw std::ios_base::failure("Binary write failed");
+	}
+	_used = 0;
+}
+
+BinaryReader::BinaryReader(std::istream& in, std::size_t buffer) :
+	_in(in), _buffer(std::max<std::size_t>(buffer, 64)), _pos(0), _end(0)
+{
+	// do nothing
+}
+
+void BinaryReader::read(void* data, std::size_t n)
+{
+	char *bytes = static_cast<char*>(data);
+	while (n > 0) {
+		if (_pos == _end && !fill()) {
+			throw std::runtime_error("Unexpected end of binary stream");
+		}
+		std::size_t chunk = std::min(n, _end - _pos);
+		std::memcpy(bytes, _buffer.data() + _pos, chunk);
+		_pos += chunk;
+		bytes += chunk;
+		n -= chunk;
+	}
+}
+
+bool BinaryReader::fill()
+{
+	// One buffered block at most: those bytes stay in the stream buffer's get
+	// area, which is what lets finish() unget them.
+	std::streambuf *buf = _in.rdbuf();
+	_pos = 0;
+	_end = 0;
+	if (buf == nullptr ||
+		buf->sgetc() == std::char_traits<char>::eof()) {
+		return false;
+	}
+	std::streamsize avail = std::max<std::streamsize>(buf->in_avail(), 1);
+	std::size_t want = std::min(_buffer.size(),
+		static_cast<std::size_t>(avail));
+	_end = static_cast<std::size_t>(buf->sgetn(_buffer.data(), want));
+	return _end > 0;
+}
+
+void BinaryReader::finish()
+{
+	std::streambuf *buf = _in.rdbuf();
+	while (_end > _pos && buf != nullptr &&
+		buf->sungetc() != std::char_traits<char>::eof()) {
+		--_end;
+	}
+	_pos = _end = 0;
+}
+
+void Codec<std::string>::write(BinaryWriter& out, const std::string& value)
+{
+	if (value.size() > std::numeric_limits<std::uint32_t>::max()) {
+		throw std::length_error("String too long to dump");
+	}
+	out.put(static_cast<std::uint32_t>(value.size()));
+	out.write(value.data(), value.size());
+}
+
+std::string Codec<std::string>::read(BinaryReader& in)
+{
+	// The length is untrusted: grow as the bytes arrive, so a corrupt one
+	// fails at the end of the stream instead of allocating up front.
+	std::size_t size = in.get<std::uint32_t>();
+	std::string value;
+	while (value.size() < size) {
+		std::size_t done = value.size();
+		value.resize(done + std::min(size - done, STRING_CHUNK));
+		in.read(&value[done], value.size() - done);
+	}
+	return value;
+}
+
+void csc::write_dump_header(BinaryWriter& out, DumpKind kind,
+	std::uint64_t count)
+{
+	out.put(DUMP_MAGIC);
+	out.put(DUMP_VERSION);
+	out.put(kind);
+	out.put(count);
+}
+
+DumpHeader csc::read_dump_header(BinaryReader& in)
+{
+	DumpHeader header;
+	header.magic = in.get<std::uint32_t>();
+	if (header.magic != DUMP_MAGIC) {
+		throw std::runtime_error("Not a cache dump");
+	}
+	header.version = in.get<std::uint16_t>();
+	if (header.version != DUMP_VERSION) {
+		throw std::runtime_error("Unsupported cache dump version");
+	}
+	header.kind = in.get<DumpKind>();
+	header.count = in.get<std::uint64_t>();
+	return header;
+}
+
+void csc::write_dump_trailer(BinaryWriter& out, std::uint64_t count)
+{
+	out.put(DUMP_END);
+	out.put(count);
+}
+
+void csc::read_dump_trailer(BinaryReader& in, std::uint64_t count)
+{
+	if (in.get<std::uint32_t>() != DUMP_END ||
+		in.get<std::uint64_t>() != count) {
+		throw std::runtime_error("Cache dump is truncated or corrupt");
+	}
+	in.finish();
+}
@@ -0,0 +1,690 @@
+/**
+ * @file bplus-tree.tpp
+ * @class BPlusTree
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * BPlusTree implementation.
+ */
+
+#include "bplus-tree.h"
+
+#include <algorithm>
+#include <iterator>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+using namespace csc;
+
+namespace csc {
+namespace simd {
+
+/**
+ * Counts keys[0..n) below key, or with INCLUSIVE at or below it, for 32-
+ * and 64-bit integers. Every full vector is compared and its movemask
+ * popcounted, with no branch on the keys; the rest is scanned.
+ */
+template <bool INCLUSIVE, typename T>
+inline std::size_t rank(const T *keys, std::size_t n, T key)
+{
+	std::size_t i = 0;
+	std::size_t r = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+	using S = typename std::make_signed<T>::type;
+	// The compares are signed; flipping the sign bit orders unsigned keys
+	// the same way.
+	constexpr T flip = std::is_signed<T>::value ? T(0) :
+		static_cast<T>(std::uint64_t(1) << (sizeof(T) * 8 - 1));
+	const S probe = static_cast<S>(key ^ flip);
+#endif
+#if defined(__AVX2__)
+	if constexpr (sizeof(T) == 8) {
+		const __m256i k = _mm256_set1_epi64x(static_cast<long long>(probe));
+		const __m256i f = _mm256_set1_epi64x(static_cast<long long>(flip));
+		for (; i + 4 <= n; i += 4) {
+			__m256i v = _mm256_xor_si256(_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(keys + i)), f);
+			__m256i m = INCLUSIVE ? _mm256_cmpgt_epi64(v, k) :
+				_mm256_cmpgt_epi64(k, v);
+			int bits = __builtin_popcount(static_cast<unsigned>(
+				_mm256_movemask_pd(_mm256_castsi256_pd(m))));
+			r += INCLUSIVE ? 4 - bits : bits;
+		}
+	} else {
+		const __m256i k = _mm256_set1_epi32(static_cast<int>(probe));
+		const __m256i f = _mm256_set1_epi32(static_cast<int>(flip));
+		for (; i + 8 <= n; i += 8) {
+			__m256i v = _mm256_xor_si256(_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(keys + i)), f);
+			__m256i m = INCLUSIVE ? _mm256_cmpgt_epi32(v, k) :
+				_mm256_cmpgt_epi32(k, v);
+			int bits = __builtin_popcount(static_cast<unsigned>(
+				_mm256_movemask_ps(_mm256_castsi256_ps(m))));
+			r += INCLUSIVE ? 8 - bits : bits;
+		}
+	}
+#elif defined(__SSE2__)
+	if constexpr (sizeof(T) == 8) {
+#if !defined(__SSE4_2__)
+		// No 64-bit compare before SSE4.2: the scan below does it all.
+		(void)probe;
+#else
+		const __m128i k = _mm_set1_epi64x(static_cast<long long>(probe));
+		const __m128i f = _mm_set1_epi64x(static_cast<long long>(flip));
+		for (; i + 2 <= n; i += 2) {
+			__m128i v = _mm_xor_si128(_mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(keys + i)), f);
+			__m128i m = INCLUSIVE ? _mm_cmpgt_epi64(v, k) :
+				_mm_cmpgt_epi64(k, v);
+			int bits = __builtin_popcount(static_cast<unsigned>(
+				_mm_movemask_pd(_mm_castsi128_pd(m))));
+			r += INCLUSIVE ? 2 - bits : bits;
+		}
+#endif
+	} else {
+		const __m128i k = _mm_set1_epi32(static_cast<int>(probe));
+		const __m128i f = _mm_set1_epi32(static_cast<int>(flip));
+		for (; i + 4 <= n; i += 4) {
+			__m128i v = _mm_xor_si128(_mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(keys + i)), f);
+			__m128i m = INCLUSIVE ? _mm_cmpgt_epi32(v, k) :
+				_mm_cmpgt_epi32(k, v);
+			int bits = __builtin_popcount(static_cast<unsigned>(
+				_mm_movemask_ps(_mm_castsi128_ps(m))));
+			r += INCLUSIVE ? 4 - bits : bits;
+		}
+	}
+#endif
+	for (; i < n; ++i) {
+		r += INCLUSIVE ? !(key < keys[i]) : keys[i] < key;
+	}
+	return r;
+}
+}
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+BPlusTree<K, V, Compare, LINES>::BPlusTree() :
+	_root(nullptr),
+	_first(nullptr),
+	_size(0),
+	_height(0),
+	_leaves(0),
+	_inners(0)
+{
+	// do nothing
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+BPlusTree<K, V, Compare, LINES>::~BPlusTree()
+{
+	clear();
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+BPlusTree<K, V, Compare, LINES>::BPlusTree(BPlusTree&& other) noexcept :
+	_root(other._root),
+	_first(other._first),
+	_size(other._size),
+	_height(other._height),
+	_leaves(other._leaves),
+	_inners(other._inners),
+	_less(std::move(other._less))
+{
+	other._root = nullptr;
+	other._first = nullptr;
+	other._size = other._height = other._leaves = other._inners = 0;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+BPlusTree<K, V, Compare, LINES>& BPlusTree<K, V, Compare, LINES>::operator=(
+	BPlusTree&& other) noexcept
+{
+	if (this != &other) {
+		clear();
+		std::swap(_root, other._root);
+		std::swap(_first, other._first);
+		std::swap(_size, other._size);
+		std::swap(_height, other._height);
+		std::swap(_leaves, other._leaves);
+		std::swap(_inners, other._inners);
+		_less = std::move(other._less);
+	}
+	return *this;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+template <bool INCLUSIVE>
+std::size_t BPlusTree<K, V, Compare, LINES>::rank(const K *keys,
+	std::size_t n, const K& key) const
+{
+	if constexpr (std::is_integral<K>::value &&
+		(sizeof(K) == 4 || sizeof(K) == 8) &&
+		std::is_same<Compare, std::less<K>>::value) {
+		return simd::rank<INCLUSIVE>(keys, n, key);
+	} else if constexpr (INCLUSIVE) {
+		return static_cast<std::size_t>(
+			std::upper_bound(keys, keys + n, key, _less) - keys);
+	} else {
+		return static_cast<std::size_t>(
+			std::lower_bound(keys, keys + n, key, _less) - keys);
+	}
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+typename BPlusTree<K, V, Compare, LINES>::Leaf*
+BPlusTree<K, V, Compare, LINES>::leaf_for(const K& key) const
+{
+	void *node = _root;
+	for (std::size_t level = _height; level > 1; --level) {
+		const Inner *inner = static_cast<const Inner*>(node);
+		node = inner->children[rank<true>(inner->keys, inner->count, key)];
+	}
+	return static_cast<Leaf*>(node);
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+bool BPlusTree<K, V, Compare, LINES>::insert(const K& key, const V& value)
+{
+	if (_root == nullptr) {
+		Leaf *leaf = new Leaf;
+		leaf->keys[0] = key;
+		leaf->values[0] = value;
+		leaf->count = 1;
+		_root = _first = leaf;
+		_height = 1;
+		_leaves = 1;
+		_size = 1;
+		return true;
+	}
+
+	// The inner nodes on the way down and the child taken from each, for
+	// splits to climb back up.
+	Inner *path[64];
+	std::size_t slots[64];
+	std::size_t depth = 0;
+	void *node = _root;
+	for (std::size_t level = _height; level > 1; --level) {
+		Inner *inner = static_cast<Inner*>(node);
+		std::size_t slot = rank<true>(inner->keys, inner->count, key);
+		path[depth] = inner;
+		slots[depth] = slot;
+		++depth;
+		node = inner->children[slot];
+	}
+	Leaf *leaf = static_cast<Leaf*>(node);
+	std::size_t pos = rank<false>(leaf->keys, leaf->count, key);
+	if (pos < leaf->count && !_less(key, leaf->keys[pos])) {
+		leaf->values[pos] = value;
+		return false;
+	}
+	++_size;
+	if (leaf->count < NODE_KEYS) {
+		std::move_backward(leaf->keys + pos, leaf->keys + leaf->count,
+			leaf->keys + leaf->count + 1);
+		std::move_backward(leaf->values + pos, leaf->values + leaf->count,
+			leaf->values + leaf->count + 1);
+		leaf->keys[pos] = key;
+		leaf->values[pos] = value;
+		++leaf->count;
+		return true;
+	}
+
+	Leaf *split;
+	K separator;
+	split_leaf(leaf, pos, key, value, split, separator);
+	void *right = split;
+	while (depth > 0) {
+		--depth;
+		insert_inner(path[depth], slots[depth], right, separator);
+		if (right == nullptr) {
+			return true;
+		}
+	}
+	// The root split: the tree grows a level.
+	Inner *root = new Inner;
+	root->keys[0] = separator;
+	root->children[0] = _root;
+	root->children[1] = right;
+	root->count = 1;
+	_root = root;
+	++_height;
+	++_inners;
+	return true;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::split_leaf(Leaf *leaf, std::size_t pos,
+	const K& key, const V& value, Leaf*& right, K& separator)
+{
+	right = new Leaf;
+	++_leaves;
+	// NODE_KEYS + 1 pairs: the left keeps half, rounded down.
+	std::size_t half = (NODE_KEYS + 1) / 2;
+	if (pos < half) {
+		std::move(leaf->keys + half - 1, leaf->keys + NODE_KEYS, right->keys);
+		std::move(leaf->values + half - 1, leaf->values + NODE_KEYS,
+			right->values);
+		std::move_backward(leaf->keys + pos, leaf->keys + half - 1,
+			leaf->keys + half);
+		std::move_backward(leaf->values + pos, leaf->values + half - 1,
+			leaf->values + half);
+		leaf->keys[pos] = key;
+		leaf->values[pos] = value;
+	} else {
+		std::size_t at = pos - half;
+		std::move(leaf->keys + half, leaf->keys + pos, right->keys);
+		std::move(leaf->values + half, leaf->values + pos, right->values);
+		right->keys[at] = key;
+		right->values[at] = value;
+		std::move(leaf->keys + pos, leaf->keys + NODE_KEYS,
+			right->keys + at + 1);
+		std::move(leaf->values + pos, leaf->values + NODE_KEYS,
+			right->values + at + 1);
+	}
+	leaf->count = static_cast<std::uint32_t>(half);
+	right->count = static_cast<std::uint32_t>(NODE_KEYS + 1 - half);
+	right->next = leaf->next;
+	leaf->next = right;
+	separator = right->keys[0];
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::insert_inner(Inner *inner,
+	std::size_t pos, void*& right, K& separator)
+{
+	std::size_t count = inner->count;
+	if (count < NODE_KEYS) {
+		std::move_backward(inner->keys + pos, inner->keys + count,
+			inner->keys + count + 1);
+		std::copy_backward(inner->children + pos + 1,
+			inner->children + count + 1, inner->children + count + 2);
+		inner->keys[pos] = separator;
+		inner->children[pos + 1] = right;
+		++inner->count;
+		right = nullptr;
+		return;
+	}
+
+	// Lay out the NODE_KEYS + 1 keys and NODE_KEYS + 2 children, then the
+	// middle key moves up and the upper half goes to a new node.
+	K keys[NODE_KEYS + 1];
+	void *children[NODE_KEYS + 2];
+	std::move(inner->keys, inner->keys + pos, keys);
+	keys[pos] = separator;
+	std::move(inner->keys + pos, inner->keys + count, keys + pos + 1);
+	std::copy(inner->children, inner->children + pos + 1, children);
+	children[pos + 1] = right;
+	std::copy(inner->children + pos + 1, inner->children + count + 1,
+		children + pos + 2);
+
+	std::size_t mid = (NODE_KEYS + 1) / 2;
+	Inner *split = new Inner;
+	++_inners;
+	std::move(keys, keys + mid, inner->keys);
+	std::copy(children, children + mid + 1, inner->children);
+	inner->count = static_cast<std::uint32_t>(mid);
+	std::move(keys + mid + 1, keys + NODE_KEYS + 1, split->keys);
+	std::copy(children + mid + 1, children + NODE_KEYS + 2, split->children);
+	split->count = static_cast<std::uint32_t>(NODE_KEYS - mid);
+	separator = std::move(keys[mid]);
+	right = split;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+template <typename It>
+void BPlusTree<K, V, Compare, LINES>::bulk_load(It first, It last,
+	const BulkLoadOptions& options)
+{
+	const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+	if constexpr (std::is_base_of<std::random_access_iterator_tag,
+		typename std::iterator_traits<It>::iterator_category>::value) {
+		build(n, options, true,
+			[first](Leaf *leaf, std::size_t begin, std::size_t end) {
+				It it = first + static_cast<
+					typename std::iterator_traits<It>::difference_type>(begin);
+				for (std::size_t i = 0; i < end - begin; ++i, ++it) {
+					leaf->keys[i] = it->first;
+					leaf->values[i] = it->second;
+				}
+			});
+	} else {
+		// Serial, so the leaves are filled in order, each from where the
+		// last left off.
+		build(n, options, false,
+			[&first](Leaf *leaf, std::size_t begin, std::size_t end) {
+				for (std::size_t i = 0; i < end - begin; ++i, ++first) {
+					leaf->keys[i] = first->first;
+					leaf->values[i] = first->second;
+				}
+			});
+	}
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+std::size_t BPlusTree<K, V, Compare, LINES>::leaf_pairs(
+	const BulkLoadOptions& options)
+{
+	if (!(options.fill > 0 && options.fill <= 1)) {
+		throw std::invalid_argument("BulkLoadOptions fill out of range");
+	}
+	return std::max<std::size_t>(1,
+		static_cast<std::size_t>(options.fill * NODE_KEYS + 0.5));
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+template <typename FillLeaf>
+void BPlusTree<K, V, Compare, LINES>::build(std::size_t n,
+	const BulkLoadOptions& options, bool parallel, FillLeaf fill_leaf)
+{
+	clear();
+	const std::size_t per = leaf_pairs(options);
+	if (n == 0) {
+		return;
+	}
+	// Every leaf made so far, freed if a fill throws.
+	std::vector<Leaf*> leaves(n / per + (n % per != 0), nullptr);
+	try {
+		// Pairs are shared out evenly, so leaf sizes differ by at most one
+		// and the last leaf isn't a straggler.
+		const std::size_t count = leaves.size();
+		auto fill = [&](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				const std::size_t from = n * i / count;
+				const std::size_t to = n * (i + 1) / count;
+				Leaf *leaf = new Leaf;
+				leaves[i] = leaf;
+				fill_leaf(leaf, from, to);
+				leaf->count = static_cast<std::uint32_t>(to - from);
+				check_order(leaf->keys, leaf->count);
+			}
+		};
+		if (parallel && options.pool != nullptr && count > BUILD_GRAIN) {
+			options.pool->parallel_for(count, BUILD_GRAIN, fill);
+		} else {
+			fill(0, count);
+		}
+	} catch (...) {
+		for (Leaf *leaf : leaves) {
+			delete leaf;
+		}
+		throw;
+	}
+	build_levels(leaves, n, options, parallel);
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::build_levels(std::vector<Leaf*>& leaves,
+	std::size_t n, const BulkLoadOptions& options, bool parallel)
+{
+	auto run = [&](std::size_t count,
+		const std::function<void(std::size_t, std::size_t)>& fn) {
+		if (parallel && options.pool != nullptr && count > BUILD_GRAIN) {
+			options.pool->parallel_for(count, BUILD_GRAIN, fn);
+		} else {
+			fn(0, count);
+		}
+	};
+	// At least 3 children a node, so even shares never leave a node with
+	// one child.
+	const std::size_t fanout = std::max<std::size_t>(leaf_pairs(options) + 1,
+		3);
+
+	// Every inner node made so far, freed with the leaves if the input
+	// turns out unordered.
+	std::vector<std::vector<Inner*>> inners;
+	try {
+		const std::size_t count = leaves.size();
+		for (std::size_t i = 1; i < count; ++i) {
+			const Leaf *prev = leaves[i - 1];
+			if (!_less(prev->keys[prev->count - 1], leaves[i]->keys[0])) {
+				throw std::invalid_argument(
+					"BPlusTree bulk load input not in ascending key order");
+			}
+			leaves[i - 1]->next = leaves[i];
+		}
+
+		// Each level over the one below, until one node is left. A node's
+		// separators are the first keys of its children after the first,
+		// found through the leftmost leaf under each child.
+		std::vector<void*> level(leaves.begin(), leaves.end());
+		std::vector<Leaf*> lefts(leaves);
+		while (level.size() > 1) {
+			const std::size_t children = level.size();
+			const std::size_t parents = (children + fanout - 1) / fanout;
+			inners.emplace_back(parents, nullptr);
+			std::vector<Inner*>& made = inners.back();
+			std::vector<Leaf*> up(parents);
+			run(parents, [&](std::size_t begin, std::size_t end) {
+				for (std::size_t j = begin; j < end; ++j) {
+					const std::size_t from = children * j / parents;
+					const std::size_t to = children * (j + 1) / parents;
+					Inner *inner = new Inner;
+					made[j] = inner;
+					inner->children[0] = level[from];
+					for (std::size_t c = from + 1; c < to; ++c) {
+						inner->keys[c - from - 1] = lefts[c]->keys[0];
+						inner->children[c - from] = level[c];
+					}
+					inner->count = static_cast<std::uint32_t>(to - from - 1);
+					up[j] = lefts[from];
+				}
+			});
+			level.assign(made.begin(), made.end());
+			lefts.swap(up);
+		}
+		_root = level[0];
+	} catch (...) {
+		for (Leaf *leaf : leaves) {
+			delete leaf;
+		}
+		for (const std::vector<Inner*>& made : inners) {
+			for (Inner *inner : made) {
+				delete inner;
+			}
+		}
+		throw;
+	}
+	_first = leaves[0];
+	_size = n;
+	_height = inners.size() + 1;
+	_leaves = leaves.size();
+	for (const std::vector<Inner*>& made : inners) {
+		_inners += made.size();
+	}
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::check_order(const K *keys,
+	std::size_t n) const
+{
+	for (std::size_t i = 1; i < n; ++i) {
+		if (!_less(keys[i - 1], keys[i])) {
+			throw std::invalid_argument(
+				"BPlusTree bulk load input not in ascending key order");
+		}
+	}
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::dump(std::ostream& out) const
+{
+	BinaryWriter writer(out);
+	const std::uint64_t count = _size;
+	write_dump_header(writer, DumpKind::BPLUS_TREE, count);
+	for_each([&writer](const K& key, const V& value) {
+		Codec<K>::write(writer, key);
+		Codec<V>::write(writer, value);
+	});
+	write_dump_trailer(writer, count);
+	writer.flush();
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::load(std::istream& in,
+	const BulkLoadOptions& options)
+{
+	clear();
+	const std::size_t per = leaf_pairs(options);
+	BinaryReader reader(in);
+	DumpHeader header = read_dump_header(reader);
+	if (header.kind != DumpKind::BPLUS_TREE) {
+		throw std::runtime_error("Not a BPlusTree dump");
+	}
+	// The count is untrusted: a leaf is added only once a pair arrives for
+	// it, so a count the stream doesn't hold fails at its end with a short
+	// read, having allocated only for what was there.
+	std::vector<Leaf*> leaves;
+	try {
+		Leaf *leaf = nullptr;
+		for (std::uint64_t n = 0; n < header.count; ++n) {
+			if (leaf == nullptr || leaf->count == per) {
+				// The slot first, so a new leaf is never left unowned.
+				leaves.push_back(nullptr);
+				leaf = new Leaf;
+				leaves.back() = leaf;
+			}
+			leaf->keys[leaf->count] = Codec<K>::read(reader);
+			leaf->values[leaf->count] = Codec<V>::read(reader);
+			++leaf->count;
+		}
+		read_dump_trailer(reader, header.count);
+		for (const Leaf *full : leaves) {
+			check_order(full->keys, full->count);
+		}
+		// Even out the last two leaves, so the last isn't a straggler.
+		if (leaves.size() > 1) {
+			Leaf *prev = leaves[leaves.size() - 2];
+			Leaf *last = leaves.back();
+			const std::size_t total = prev->count + last->count;
+			const std::size_t keep = (total + 1) / 2;
+			const std::size_t moved = prev->count - keep;
+			std::move_backward(last->keys, last->keys + last->count,
+				last->keys + last->count + moved);
+			std::move_backward(last->values, last->values + last->count,
+				last->values + last->count + moved);
+			std::move(prev->keys + keep, prev->keys + prev->count, last->keys);
+			std::move(prev->values + keep, prev->values + prev->count,
+				last->values);
+			prev->count = static_cast<std::uint32_t>(keep);
+			last->count = static_cast<std::uint32_t>(total - keep);
+		}
+	} catch (...) {
+		for (Leaf *leaf : leaves) {
+			delete leaf;
+		}
+		throw;
+	}
+	if (!leaves.empty()) {
+		build_levels(leaves, static_cast<std::size_t>(header.count),
+			options, true);
+	}
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+V* BPlusTree<K, V, Compare, LINES>::find(const K& key)
+{
+	return const_cast<V*>(
+		static_cast<const BPlusTree*>(this)->find(key));
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+const V* BPlusTree<K, V, Compare, LINES>::find(const K& key) const
+{
+	if (_root == nullptr) {
+		return nullptr;
+	}
+	const Leaf *leaf = leaf_for(key);
+	std::size_t pos = rank<false>(leaf->keys, leaf->count, key);
+	if (pos < leaf->count && !_less(key, leaf->keys[pos])) {
+		return &leaf->values[pos];
+	}
+	return nullptr;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+bool BPlusTree<K, V, Compare, LINES>::contains(const K& key) const
+{
+	return find(key) != nullptr;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+template <typename Fn>
+std::size_t BPlusTree<K, V, Compare, LINES>::scan(const K& from, const K& to,
+	Fn fn) const
+{
+	if (_root == nullptr) {
+		return 0;
+	}
+	std::size_t visited = 0;
+	const Leaf *leaf = leaf_for(from);
+	std::size_t pos = rank<false>(leaf->keys, leaf->count, from);
+	for (; leaf != nullptr; leaf = leaf->next, pos = 0) {
+		for (; pos < leaf->count; ++pos) {
+			if (!_less(leaf->keys[pos], to)) {
+				return visited;
+			}
+			fn(leaf->keys[pos], leaf->values[pos]);
+			++visited;
+		}
+	}
+	return visited;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+template <typename Fn>
+void BPlusTree<K, V, Compare, LINES>::for_each(Fn fn) const
+{
+	for (const Leaf *leaf = _first; leaf != nullptr; leaf = leaf->next) {
+		for (std::size_t i = 0; i < leaf->count; ++i) {
+			fn(leaf->keys[i], leaf->values[i]);
+		}
+	}
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::destroy(void *node, std::size_t level)
+{
+	if (level == 1) {
+		delete static_cast<Leaf*>(node);
+		return;
+	}
+	Inner *inner = static_cast<Inner*>(node);
+	for (std::size_t i = 0; i <= inner->count; ++i) {
+		destroy(inner->children[i], level - 1);
+	}
+	delete inner;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+void BPlusTree<K, V, Compare, LINES>::clear()
+{
+	if (_root != nullptr) {
+		destroy(_root, _height);
+	}
+	_root = nullptr;
+	_first = nullptr;
+	_size = _height = _leaves = _inners = 0;
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+std::size_t BPlusTree<K, V, Compare, LINES>::bytes() const
+{
+	return _leaves * sizeof(Leaf) + _inners * sizeof(Inner);
+}
+
+template <typename K, typename V, typename Compare, std::size_t LINES>
+double BPlusTree<K, V, Compare, LINES>::fill() const
+{
+	return _leaves == 0 ? 0 : static_cast<double>(_size) /
+		static_cast<double>(_leaves * NODE_KEYS);
+}
@@ -0,0 +1,329 @@
+/**
+ * @file cache-sim.cpp
+ * @class AccessTrace, SimPolicy
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * AccessTrace and simulator policy implementation.
+ */
+
+#include "cache-sim.h"
+#include "binary-io.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+
+using namespace csc;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// DumpHeader, and an entry and the trailer, as written.
+constexpr std::size_t HEADER_BYTES = 16;
+constexpr std::size_t RECORD_BYTES = 12;
+constexpr std::size_t TRAILER_BYTES = 12;
+
+bool space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+
+// Parses the text access at pos, up to and past its newline. FALSE if the
+// line holds no access.
+bool parse_line(const char *&pos, const char *end, Access& access)
+{
+	const char *line = pos;
+	while (pos < end && *pos != '\n') {
+		++pos;
+	}
+	const char *stop = pos;
+	if (pos < end) {
+		++pos;
+	}
+	while (line < stop && space(*line)) {
+		++line;
+	}
+	if (line == stop || *line == '#') {
+		return false;
+	}
+	const char *token = line;
+	bool number = true;
+	std::uint64_t key = 0;
+	// FNV-1a, for keys that aren't numbers.
+	std::uint64_t hash = 0xcbf29ce484222325ull;
+	for (; line < stop && !space(*line); ++line) {
+		unsigned char c = static_cast<unsigned char>(*line);
+		number = number && c >= '0' && c <= '9';
+		key = key * 10 + (c - '0');
+		hash = (hash ^ c) * 0x100000001b3ull;
+	}
+	// A number too long for 64 bits is a name.
+	access.key = number && line - token <= 19 ? key : hash;
+	while (line < stop && space(*line)) {
+		++line;
+	}
+	std::uint32_t size = 0;
+	bool sized = false;
+	for (; line < stop && *line >= '0' && *line <= '9'; ++line) {
+		size = size * 10 + static_cast<std::uint32_t>(*line - '0');
+		sized = true;
+	}
+	access.size = sized ? size : 1;
+	return true;
+}
+}
+
+AccessTrace::AccessTrace(MappedRegion region, bool binary, std::size_t skip,
+	std::size_t length) :
+	_region(std::move(region)),
+	_binary(binary)
+{
+	_begin = static_cast<const char*>(_region.data()) + skip;
+	_end = _begin + length;
+}
+
+AccessTrace AccessTrace::open(const std::string& path)
+{
+	MappedRegion region = MappedRegion::open_read(path);
+	const char *data = static_cast<const char*>(region.data());
+	std::size_t size = region.size();
+	std::uint32_t magic = 0;
+	if (size >= sizeof(magic)) {
+		std::memcpy(&magic, data, sizeof(magic));
+	}
+	if (magic != DUMP_MAGIC) {
+		return AccessTrace(std::move(region), false, 0, size);
+	}
+
+	std::uint16_t version;
+	DumpKind kind;
+	std::uint64_t count;
+	if (size < HEADER_BYTES + TRAILER_BYTES) {
+		throw std::runtime_error("Access trace is truncated or corrupt");
+	}
+	std::memcpy(&version, data + 4, sizeof(version));
+	std::memcpy(&kind, data + 6, sizeof(kind));
+	std::memcpy(&count, data + 8, sizeof(count));
+	if (version != DUMP_VERSION || kind != DumpKind::ACCESS_TRACE) {
+		throw std::runtime_error("Not an access trace: " + path);
+	}
+	std::size_t length = size - HEADER_BYTES - TRAILER_BYTES;
+	std::uint32_t end;
+	std::uint64_t trailer;
+	std::memcpy(&end, data + size - TRAILER_BYTES, sizeof(end));
+	std::memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+	if (length / RECORD_BYTES != count || length % RECORD_BYTES != 0 ||
+		end != DUMP_END || trailer != count) {
+		throw std::runtime_error("Access trace is truncated or corrupt");
+	}
+	return AccessTrace(std::move(region), true, HEADER_BYTES, length);
+}
+
+std::uint64_t AccessTrace::convert(const std::string& text,
+	const std::string& binary)
+{
+	AccessTrace trace = open(text);
+	if (trace.binary()) {
+		throw std::invalid_argument(text + " is already binary");
+	}
+	// The header holds the count, so count first; the map makes it cheap.
+	std::uint64_t count = 0;
+	Access access;
+	for (Cursor cursor = trace.cursor(); cursor.next(access); ) {
+		++count;
+	}
+	std::ofstream file(binary, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		throw std::system_error(errno, std::generic_category(),
+			"open " + binary);
+	}
+	{
+		BinaryWriter out(file);
+		write_dump_header(out, DumpKind::ACCESS_TRACE, count);
+		for (Cursor cursor = trace.cursor(); cursor.next(access); ) {
+			out.put(access.key);
+			out.put(access.size);
+		}
+		write_dump_trailer(out, count);
+	}
+	if (!file.flush()) {
+		throw std::runtime_error("Cannot write " + binary);
+	}
+	return count;
+}
+
+AccessTrace::Cursor AccessTrace::cursor() const
+{
+	return Cursor(_begin, _end, _binary);
+}
+
+bool AccessTrace::Cursor::next(Access& access)
+{
+	if (_binary) {
+		if (_pos == _end) {
+			return false;
+		}
+		std::memcpy(&access.key, _pos, sizeof(access.key));
+		std::memcpy(&access.size, _pos + sizeof(access.key),
+			sizeof(access.size));
+		_pos += RECORD_BYTES;
+		return true;
+	}
+	while (_pos < _end) {
+		if (parse_line(_pos, _end, access)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FifoPolicy::access(const Access& access, std::uint64_t)
+{
+	if (_keys.count(access.key) != 0) {
+		return true;
+	}
+	if (_capacity == 0) {
+		return false;
+	}
+	if (_queue.size() == _capacity) {
+		_keys.erase(_queue.front());
+		_queue.pop_front();
+	}
+	_queue.push_back(access.key);
+	_keys.insert(access.key);
+	return false;
+}
+
+bool ClockPolicy::access(const Access& access, std::uint64_t)
+{
+	auto it = _index.find(access.key);
+	if (it != _index.end()) {
+		_slots[it->second].referenced = true;
+		return true;
+	}
+	if (_capacity == 0) {
+		return false;
+	}
+	if (_slots.size() < _capacity) {
+		_index.emplace(access.key, _slots.size());
+		_slots.push_back({access.key, false});
+		return false;
+	}
+	while (_slots[_hand].referenced) {
+		_slots[_hand].referenced = false;
+		_hand = (_hand + 1) % _slots.size();
+	}
+	_index.erase(_slots[_hand].key);
+	_slots[_hand] = {access.key, false};
+	_index.emplace(access.key, _hand);
+	_hand = (_hand + 1) % _slots.size();
+	return false;
+}
+
+bool CachePolicy::access(const Access& access, std::uint64_t)
+{
+	if (get(access.key) != nullptr) {
+		return true;
+	}
+	insert(access.key, access.size);
+	return false;
+}
+
+OptPolicy::NextUses OptPolicy::next_uses(const AccessTrace& trace)
+{
+	auto uses = std::make_shared<std::vector<std::uint64_t>>();
+	Access access;
+	for (AccessTrace::Cursor cursor = trace.cursor(); cursor.next(access); ) {
+		uses->push_back(access.key);
+	}
+	// Backwards, remembering where each key is seen next. The keys become
+	// the next uses in place.
+	std::unordered_map<std::uint64_t, std::uint64_t> seen;
+	for (std::uint64_t i = uses->size(); i-- > 0; ) {
+		std::uint64_t& use = (*uses)[i];
+		auto it = seen.find(use);
+		std::uint64_t next = it == seen.end() ? NEVER : it->second;
+		seen[use] = i;
+		use = next;
+	}
+	return uses;
+}
+
+OptPolicy::OptPolicy(const AccessTrace& trace, std::size_t capacity) :
+	OptPolicy(next_uses(trace), capacity)
+{
+}
+
+OptPolicy::OptPolicy(NextUses next, std::size_t capacity) :
+	_capacity(capacity),
+	_next(std::move(next))
+{
+}
+
+bool OptPolicy::access(const Access& access, std::uint64_t index)
+{
+	std::uint64_t next = index < _next->size() ? (*_next)[index] : NEVER;
+	auto it = _cached.find(access.key);
+	if (it != _cached.end()) {
+		_order.erase({it->second, access.key});
+		_order.insert({next, access.key});
+		it->second = next;
+		return true;
+	}
+	if (_capacity == 0) {
+		return false;
+	}
+	if (_cached.size() == _capacity) {
+		auto victim = std::prev(_order.end());
+		_cached.erase(victim->second);
+		_order.erase(victim);
+	}
+	_order.insert({next, access.key});
+	_cached.emplace(access.key, next);
+	return false;
+}
+
+double SimResult::hit_ratio() const
+{
+	return accesses == 0 ? 0 :
+		static_cast<double>(hits) / static_cast<double>(accesses);
+}
+
+double SimResult::byte_hit_ratio() const
+{
+	return bytes == 0 ? 0 :
+		static_cast<double>(hit_bytes) / static_cast<double>(bytes);
+}
+
+double SimResult::accesses_per_sec() const
+{
+	return seconds > 0 ? static_cast<double>(accesses) / seconds : 0;
+}
+
+SimResult csc::simulate(const AccessTrace& trace, SimPolicy& policy,
+	const std::string& name, std::size_t capacity)
+{
+	SimResult result;
+	result.policy = name;
+	result.capacity = capacity;
+	Access access;
+	Clock::time_point start = Clock::now();
+	for (AccessTrace::Cursor cursor = trace.cursor(); cursor.next(access); ) {
+		bool hit = policy.access(access, result.accesses);
+		++result.accesses;
+		result.bytes += access.size;
+		if (hit) {
+			++result.hits;
+			result.hit_bytes += access.size;
+		}
+	}
+	result.seconds = std::chrono::duration<double>(Clock::now() - start)
+		.count();
+	return result;
+}
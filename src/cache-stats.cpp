@@ -0,0 +1,246 @@
+/**
+ * @file cache-stats.cpp
+ * @class CacheStats
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * CacheStats, StatsCounter and LatencyHistogram implementation.
+ */
+
+#include "cache-stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace csc;
+
+namespace {
+std::size_t top_bit(std::uint64_t v)
+{
+	return 63 - static_cast<std::size_t>(__builtin_clzll(v));
+}
+
+std::uint64_t since(std::chrono::steady_clock::time_point start)
+{
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count());
+}
+}
+
+std::uint64_t HistogramSnapshot::percentile(double p) const
+{
+	if (count == 0) {
+		return 0;
+	}
+	p = std::min(std::max(p, 0.0), 1.0);
+	std::uint64_t rank = std::max<std::uint64_t>(
+		static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count))),
+		1);
+	std::uint64_t seen = 0;
+	for (std::size_t b = 0; b < counts.size(); ++b) {
+		seen += counts[b];
+		if (seen >= rank) {
+			return LatencyHistogram::highest(b);
+		}
+	}
+	return LatencyHistogram::highest(counts.size() - 1);
+}
+
+double HistogramSnapshot::mean() const
+{
+	if (count == 0) {
+		return 0;
+	}
+	double total = 0;
+	for (std::size_t b = 0; b < counts.size(); ++b) {
+		double mid = (static_cast<double>(LatencyHistogram::lowest(b)) +
+			static_cast<double>(LatencyHistogram::highest(b))) / 2;
+		total += mid * static_cast<double>(counts[b]);
+	}
+	return total / static_cast<double>(count);
+}
+
+LatencyHistogram::LatencyHistogram() :
+	_stripes(std::make_unique<Stripe[]>(STRIPES))
+{
+	// do nothing
+}
+
+std::size_t LatencyHistogram::bucket(std::uint64_t ns)
+{
+	constexpr std::uint64_t SUB = 1ull << SUB_BITS;
+	if (ns < SUB) {
+		return static_cast<std::size_t>(ns);
+	}
+	// The top bit picks the power of two; the next SUB_BITS, the bucket.
+	std::size_t e = top_bit(ns);
+	return ((e - SUB_BITS + 1) << SUB_BITS) |
+		static_cast<std::size_t>((ns >> (e - SUB_BITS)) & (SUB - 1));
+}
+
+std::uint64_t LatencyHistogram::lowest(std::size_t bucket)
+{
+	constexpr std::uint64_t SUB = 1ull << SUB_BITS;
+	if (bucket < SUB) {
+		return bucket;
+	}
+	std::size_t e = (bucket >> SUB_BITS) + SUB_BITS - 1;
+	return (SUB + (bucket & (SUB - 1))) << (e - SUB_BITS);
+}
+
+std::uint64_t LatencyHistogram::highest(std::size_t bucket)
+{
+	if (bucket < (1u << SUB_BITS)) {
+		return bucket;
+	}
+	std::size_t e = (bucket >> SUB_BITS) + SUB_BITS - 1;
+	return lowest(bucket) + ((1ull << (e - SUB_BITS)) - 1);
+}
+
+void LatencyHistogram::record(std::uint64_t ns)
+{
+	_stripes[StatsCounter::stripe() % STRIPES].counts[bucket(ns)].fetch_add(1,
+		std::memory_order_relaxed);
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+	HistogramSnapshot out;
+	out.counts.assign(BUCKETS, 0);
+	for (std::size_t s = 0; s < STRIPES; ++s) {
+		for (std::size_t b = 0; b < BUCKETS; ++b) {
+			std::uint64_t n = _stripes[s].counts[b].load(
+				std::memory_order_relaxed);
+			out.counts[b] += n;
+			out.count += n;
+		}
+	}
+	return out;
+}
+
+void StatsCounter::add(std::int64_t n)
+{
+	_slots[stripe()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+std::int64_t StatsCounter::sum() const
+{
+	std::int64_t total = 0;
+	for (const Slot& slot : _slots) {
+		total += slot.value.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+std::size_t StatsCounter::stripe()
+{
+	static std::atomic<std::size_t> next(0);
+	static thread_local std::size_t mine =
+		next.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+	return mine;
+}
+
+double StatsSnapshot::hit_ratio() const
+{
+	std::uint64_t lookups = hits + misses;
+	return lookups == 0 ? 0 :
+		static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+std::uint64_t StatsSnapshot::removed(RemovalCause cause) const
+{
+	return removals[static_cast<std::size_t>(cause)];
+}
+
+CacheStats::Timer::Timer(LatencyHistogram *histogram) :
+	_histogram(histogram)
+{
+	if (_histogram != nullptr) {
+		_start = std::chrono::steady_clock::now();
+	}
+}
+
+CacheStats::Timer::~Timer()
+{
+	if (_histogram != nullptr) {
+		_histogram->record(since(_start));
+	}
+}
+
+void CacheStats::hit()
+{
+	_hits.add();
+}
+
+void CacheStats::miss()
+{
+	_misses.add();
+}
+
+void CacheStats::put()
+{
+	_puts.add();
+}
+
+void CacheStats::removed(RemovalCause cause)
+{
+	_removals[static_cast<std::size_t>(cause)].add();
+}
+
+void CacheStats::resident(std::int64_t bytes)
+{
+	_bytes.add(bytes);
+}
+
+std::chrono::steady_clock::time_point CacheStats::start() const
+{
+	return std::chrono::steady_clock::now();
+}
+
+void CacheStats::loaded(bool found,
+	std::chrono::steady_clock::time_point start)
+{
+	(found ? _loads : _load_failures).add();
+	_load_ns.add(static_cast<std::int64_t>(since(start)));
+}
+
+void CacheStats::enable_latency()
+{
+	if (!_get_latency) {
+		_get_latency = std::make_unique<LatencyHistogram>();
+		_put_latency = std::make_unique<LatencyHistogram>();
+	}
+}
+
+CacheStats::Timer CacheStats::time_get()
+{
+	return Timer(_get_latency.get());
+}
+
+CacheStats::Timer CacheStats::time_put()
+{
+	return Timer(_put_latency.get());
+}
+
+StatsSnapshot CacheStats::snapshot() const
+{
+	StatsSnapshot out;
+	out.hits = static_cast<std::uint64_t>(_hits.sum());
+	out.misses = static_cast<std::uint64_t>(_misses.sum());
+	out.puts = static_cast<std::uint64_t>(_puts.sum());
+	for (std::size_t c = 0; c < _removals.size(); ++c) {
+		out.removals[c] = static_cast<std::uint64_t>(_removals[c].sum());
+	}
+	out.loads = static_cast<std::uint64_t>(_loads.sum());
+	out.load_failures = static_cast<std::uint64_t>(_load_failures.sum());
+	out.load_time = std::chrono::nanoseconds(_load_ns.sum());
+	out.bytes = _bytes.sum();
+	if (_get_latency) {
+		out.get_latency = _get_latency->snapshot();
+		out.put_latency = _put_latency->snapshot();
+	}
+	return out;
+}
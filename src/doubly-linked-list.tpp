@@ -9,15 +9,16 @@
  * DoublyLinkedList implementation.
  */
 
-#include "linked-list.h"
+#include "doubly-linked-list.h"
 
 #include <iostream>
-#include <exception>
+#include <stdexcept>
 
 using namespace csc;
 
 template <typename T>
-DoublyLinkedList<T>::DoublyLinkedList(const DoublyLinkedList<T>& para)
+DoublyLinkedList<T>::DoublyLinkedList(const DoublyLinkedList<T>& para) :
+	_head(nullptr), _tail(nullptr), _count(0)
 {
     // Check if list to be copied has any nodes.
     if (!para.empty()) {
@@ -70,7 +71,7 @@ DoublyLinkedList<T>& DoublyLinkedList<T>::operator=(const DoublyLinkedList<T>& r
         this->copy_calling_list_longer(rhs);
     }
     else if (this->_count < rhs._count) {
-        this->copy_calling_list_longer(rhs);
+        this->copy_calling_list_shorter(rhs);
     }
 
     // Return calling list.
@@ -108,7 +109,7 @@ void DoublyLinkedList<T>::copy_calling_list_empty(const DoublyLinkedList<T>& par
    DLLNode<T>* curr = _head;
    DLLNode<T>* para_curr = para._head;
    // Loop through all parameter list nodes and create for caller list.
-   for (int i = 1; i < _count; ++i) {
+   for (std::size_t i = 1; i < _count; ++i) {
        para_curr = para_curr->get_next();
        curr->set_next(new DLLNode<T>(para_curr->get_element(), nullptr, curr));
        curr = curr->get_next();
@@ -141,16 +142,17 @@ void DoublyLinkedList<T>::copy_calling_list_longer(const DoublyLinkedList<T>& pa
         curr->set_element(para_curr->get_element());
         if (para_curr->get_next() == nullptr) {
            _tail = curr;
-           curr->set_next(nullptr);
         }
         curr = curr->get_next();
         para_curr = para_curr->get_next();
     }
-    // curr at new _tail for caller.
+    _tail->set_next(nullptr);
+    // curr at the first node past the new _tail.
     // Delete everything after...
     while (curr != nullptr) {
+        DLLNode<T>* curr_next = curr->get_next();
         delete curr;
-        curr = curr->get_next();
+        curr = curr_next;
     }
     // Cleanup: _count is equal, assign _tail, and delete dangling pointers.
     _count = para._count;
@@ -229,7 +231,7 @@ T DoublyLinkedList<T>::back() const
 }
 
 template <typename T>
-void DoublyLinkedList<T>::push_front(T element)
+const DLLNode<T>* DoublyLinkedList<T>::push_front(T element)
 {
 	if (empty()) {
 		_head = new DLLNode<T>(element);
@@ -242,6 +244,36 @@ void DoublyLinkedList<T>::push_front(T element)
 	}
 	// Increment count, node has been added.
     ++_count;	
+	return _head;
+}
+
+template <typename T>
+void DoublyLinkedList<T>::move_to_front(const DLLNode<T>* node)
+{
+	// The node is ours, so it may be relinked.
+	DLLNode<T>* curr = const_cast<DLLNode<T>*>(node);
+	if (curr == _head) {
+		return;
+	}
+	// Not the head, so it has a prev.
+	DLLNode<T>* prev = curr->get_prev();
+	DLLNode<T>* next = curr->get_next();
+	prev->set_next(next);
+	if (next != nullptr) {
+		next->set_prev(prev);
+	} else {
+		_tail = prev;
+	}
+	curr->set_prev(nullptr);
+	curr->set_next(_head);
+	_head->set_prev(curr);
+	_head = curr;
+}
+
+template <typename T>
+void DoublyLinkedList<T>::erase(const DLLNode<T>* node)
+{
+	unlink(const_cast<DLLNode<T>*>(node));
 }
 
 template <typename T>
@@ -311,7 +343,7 @@ bool DoublyLinkedList<T>::insert(T element, int index)
 	}
 
 	// Insert at _tail.
-	if (index == _count) {
+	if (static_cast<std::size_t>(index) == _count) {
 		push_back(element);
 		return true;
 	}
@@ -321,7 +353,7 @@ bool DoublyLinkedList<T>::insert(T element, int index)
 	// We want to stop one before the index we want to insert, so we can 
 	// use set_next() to insert at that index.
 	while (++i != index) {
-		curr->get_next();
+		curr = curr->get_next();
 	}
 	DLLNode<T>* curr_next = curr->get_next();
 	curr->set_next(new DLLNode<T>(element, curr_next, curr));
@@ -340,7 +372,7 @@ void DoublyLinkedList<T>::index_out_of_range(int index) const
 	if (index < 0) {
 		throw std::out_of_range("Index cannot be negative");
 	}
-	if (index > _count) {
+	if (static_cast<std::size_t>(index) > _count) {
 		throw std::out_of_range("Index out of range");
 	}
 }
@@ -352,32 +384,37 @@ bool DoublyLinkedList<T>::remove(T element)
 	if (empty()) {
 		throw std::out_of_range("Attempted to remove from an empty list.");
 	}
-	// If node to delete is the head, don't loop.
-	if (_head->get_element() == element) {
-		DLLNode<T>* tmp = _head;
-		_head = tmp->get_next();
-		delete tmp;
-		tmp = nullptr;
-		--_count;
-	} else {
-		DLLNode<T>* curr = _head;
-		while (curr->get_next() != nullptr && 
-			curr->get_next()->get_element() != element) {
-			curr = curr->get_next();
-		}
-		if (curr->get_next() == nullptr) {
-			// At tail and element not found.
-			return false;
-		}
-		DLLNode<T>* tmp = curr->get_next();
-		curr->set_next(tmp->get_next());
-		delete tmp;
-		tmp = nullptr;
-		--_count;
+	DLLNode<T>* curr = _head;
+	while (curr != nullptr && curr->get_element() != element) {
+		curr = curr->get_next();
+	}
+	if (curr == nullptr) {
+		// Past _tail and element not found.
+		return false;
 	}
+	unlink(curr);
 	return true;
 }
 
+template <typename T>
+void DoublyLinkedList<T>::unlink(DLLNode<T>* node)
+{
+	DLLNode<T>* prev = node->get_prev();
+	DLLNode<T>* next = node->get_next();
+	if (prev != nullptr) {
+		prev->set_next(next);
+	} else {
+		_head = next;
+	}
+	if (next != nullptr) {
+		next->set_prev(prev);
+	} else {
+		_tail = prev;
+	}
+	delete node;
+	--_count;
+}
+
 template <typename T>
 void DoublyLinkedList<T>::print() const
 {
@@ -400,12 +437,15 @@ template <typename T>
 T DoublyLinkedList<T>::get(int index) const
 {
 	index_out_of_range(index);
+	if (static_cast<std::size_t>(index) == _count) {
+		throw std::out_of_range("Index out of range");
+	}
 	// Check _head.
 	if (index == 0) {
 		return _head->get_element();
 	}
 	// Check _tail.
-	if (index == _count) {
+	if (static_cast<std::size_t>(index) == _count - 1) {
 		return _tail->get_element();
 	}
 	// _head already checked, _tail already checked.
@@ -1,169 +1,248 @@
 #include "hash-map.h"
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
+#include <iterator>
+#include <cstdint>
 #include <memory>
 #include <stdexcept>
 #include <utility> // for std::move
 
 using namespace csc;
 
-// Hash functions, to exist in this scope only.
-namespace {
-	std::size_t djb2(unsigned char *str)
-    {
-		std::size_t hash = 5381;
-        int c;
-
-        while (c = *str++)
-            hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-
-        return hash;
-    }	
-	std::size_t djb2(const std::string& str)
-	{
-		std::size_t hash = 5381;
-		for (char c : str) {
-			hash = ((hash << 5) + hash) + static_cast<unsigned char>(c);
-		}
-		return hash;
-	}
-	template <typename T>
-	std::size_t djb2(const T& key)
-	{
-		std::size_t hash = 5381;
-		const unsigned char *ptr = 
-			reinterpret_cast<const unsigned char *>(&key);
-		for (std::size_t i = 0; i < sizeof(T); ++i) {
-			hash = ((hash << 5) + hash) + ptr[i];
-		}
-		return hash;
+namespace csc {
+namespace hash {
+// Hash functions, for Hash only.
+inline std::size_t djb2(const unsigned char *str)
+{
+	std::size_t hash = 5381;
+	int c;
+
+	while ((c = *str++))
+		hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+
+	return hash;
+}
+
+inline std::size_t djb2(const std::string& str)
+{
+	std::size_t hash = 5381;
+	for (char c : str) {
+		hash = ((hash << 5) + hash) + static_cast<unsigned char>(c);
 	}
-	std::size_t sdbm(unsigned char *str)
-    {
-		std::size_t hash = 0;
-        int c;
+	return hash;
+}
+
+template <typename T>
+std::size_t djb2(const T& key)
+{
+	std::size_t hash = 5381;
+	const unsigned char *ptr = 
+		reinterpret_cast<const unsigned char *>(&key);
+	for (std::size_t i = 0; i < sizeof(T); ++i) {
+		hash = ((hash << 5) + hash) + ptr[i];
+	}
+	return hash;
+}
+
+inline std::size_t sdbm(const unsigned char *str)
+{
+	std::size_t hash = 0;
+	int c;
 
-        while (c = *str++)
-            hash = c + (hash << 6) + (hash << 16) - hash;
+	while ((c = *str++))
+		hash = c + (hash << 6) + (hash << 16) - hash;
 
-        return hash;
-    }
+	return hash;
+}
+}
 }
 
-template <>
-std::size_t Hash<unsigned char*>::operator()(unsigned char *str) const
+inline std::size_t Hash<unsigned char*>::operator()(unsigned char *str) const
 {
-	return djb2(str);
+	return hash::djb2(str);
 }
 
-template <>
-Hash<std::string>::std::size_t operator()(const std::string& str) const
+inline std::size_t Hash<std::string>::operator()(const std::string& str) const
 {
-	return djb2(str);
+	return hash::djb2(str);
 }
 
 template <typename K>
-std::size_t Hash<K>::operator()(const T& key) const 
+std::size_t Hash<K>::operator()(const K& key) const 
 {
-	return djb2(key);
+	return hash::djb2(key);
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 HashMap<K, V, F>::HashMap() : 
 	_buckets(TABLE_BUCKETS),
-	_table(new SinglyLinkedList<V>[TABLE_BUCKETS]),
+	_table(new ListPtr[TABLE_BUCKETS]),
 	_size(0),
 	_hash()
 {
 	// do nothing
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 HashMap<K, V, F>::HashMap(std::size_t buckets) : 
 	_buckets(buckets), 
-	_table(new SinglyLinkedList<V>[buckets]),
+	_table(new ListPtr[buckets]),
 	_size(0),
 	_hash()
 {
 	// do nothing
 }
 
-// Copy constructor
-HashMap::HashMap(const HashMap& src) 
-    : _buckets(src._buckets), _count(src._count) {
-    // Copy elements
-    for (auto& bucket : _buckets) {
-        for (auto& entry : bucket) {
-            _buckets[bucket].emplace_back(entry);
-        }
-    }
-}
-
-// Move constructor
-HashMap::HashMap(HashMap&& src) noexcept 
-    : _buckets(std::move(src._buckets)), _count(src._count) {
-    src._count = 0;
-}
-
-// Copy assignment operator
-HashMap& HashMap::operator=(const HashMap& rhs) {
-    if (this != &rhs) {
-        clear();
-        _buckets = rhs._buckets;
-        _count = rhs._count;
-        // Copy elements
-        for (auto& bucket : _buckets) {
-            for (auto& entry : bucket) {
-                _buckets[bucket].emplace_back(entry);
-            }
-        }
-    }
-    return *this;
-}
-
-// Move assignment operator
-HashMap& HashMap::operator=(HashMap&& rhs) noexcept {
-    if (this != &rhs) {
-        clear();
-        _buckets = std::move(rhs._buckets);
-        _count = rhs._count;
-        rhs._count = 0;
-    }
-    return *this;
-}
-
-template <typename K, typename V, typename F = Hash>
-void HashMap<K, V, F>::insert(const K& key, const V& value) const
-{
-	ListPtr ptr = _table[_hash{}(key) % _buckets];
+template <typename K, typename V, typename F>
+HashMap<K, V, F>::HashMap(std::size_t buckets, bool concurrent) : 
+	_buckets(buckets), 
+	_table(new ListPtr[buckets]),
+	_size(0),
+	_hash(),
+	_locks(concurrent ? new std::mutex[LOCK_STRIPES] : nullptr)
+{
+	// do nothing
+}
+
+template <typename K, typename V, typename F>
+HashMap<K, V, F>::~HashMap()
+{
+	// The smart ListPtrs free their buckets.
+	delete[] _table;
+}
+
+template <typename K, typename V, typename F>
+HashMap<K, V, F>::HashMap(const HashMap& src) :
+	_buckets(src._buckets),
+	_table(new ListPtr[src._buckets]),
+	_size(src._size.load()),
+	_hash(src._hash),
+	_locks(src._locks ? new std::mutex[LOCK_STRIPES] : nullptr)
+{
+	for (std::size_t i = 0; i < _buckets; ++i) {
+		if (src._table[i]) {
+			_table[i] = std::make_unique<SinglyLinkedList<HashNode<K, V>>>(
+				*src._table[i]);
+		}
+	}
+}
+
+template <typename K, typename V, typename F>
+HashMap<K, V, F>::HashMap(HashMap&& src) noexcept :
+	_buckets(src._buckets),
+	_table(src._table),
+	_size(src._size.load()),
+	_hash(std::move(src._hash)),
+	_locks(std::move(src._locks))
+{
+	// Leave src an empty, usable HashMap of one bucket.
+	src._buckets = 1;
+	src._table = new ListPtr[1];
+	src._size = 0;
+}
+
+template <typename K, typename V, typename F>
+HashMap<K, V, F>& HashMap<K, V, F>::operator=(const HashMap& rhs)
+{
+	if (this != &rhs) {
+		HashMap copy(rhs);
+		*this = std::move(copy);
+	}
+	return *this;
+}
+
+template <typename K, typename V, typename F>
+HashMap<K, V, F>& HashMap<K, V, F>::operator=(HashMap&& rhs) noexcept
+{
+	if (this != &rhs) {
+		std::swap(_buckets, rhs._buckets);
+		std::swap(_table, rhs._table);
+		std::size_t size = _size.load();
+		_size = rhs._size.load();
+		rhs._size = size;
+		std::swap(_hash, rhs._hash);
+		std::swap(_locks, rhs._locks);
+	}
+	return *this;
+}
+
+template <typename K, typename V, typename F>
+std::size_t HashMap<K, V, F>::bucket(const K& key) const
+{
+	CSC_TRACE_SCOPE(HASH);
+	return _hash(key) % _buckets;
+}
+
+template <typename K, typename V, typename F>
+void HashMap<K, V, F>::insert(const K& key, const V& value)
+{
+	std::size_t i = bucket(key);
+	auto lock = lock_bucket(i);
+	CSC_TRACE_SCOPE(BUCKET_SCAN);
+	ListPtr& ptr = _table[i];
 	if (!ptr) {
 		ptr = std::make_unique<SinglyLinkedList<HashNode<K, V>>>();
 	}
+	HashNode<K, V> *node = ptr->find(HashNode<K, V>(key));
+	if (node != nullptr) {
+		node->set_value(value);
+		return;
+	}
 	ptr->insert(HashNode<K, V>(key, value));
+	++_size;
 }
 
-template <typename K, typename V, typename F = Hash>
-bool HashMap<K, V, F>::remove(const K& key) const
+template <typename K, typename V, typename F>
+bool HashMap<K, V, F>::remove(const K& key)
 {
 	if (empty()) {
 		return false;
 	}
-	ListPtr ptr = _table[_hash{}(key) % _buckets];
+	std::size_t i = bucket(key);
+	auto lock = lock_bucket(i);
+	CSC_TRACE_SCOPE(BUCKET_SCAN);
+	ListPtr& ptr = _table[i];
+	if (!ptr || !ptr->remove(HashNode<K, V>(key))) {
+		return false;
+	}
+	--_size;
+	return true;
+}
+
+template <typename K, typename V, typename F>
+bool HashMap<K, V, F>::remove(const K& key, const V& value)
+{
+	if (empty()) {
+		return false;
+	}
+	std::size_t i = bucket(key);
+	auto lock = lock_bucket(i);
+	CSC_TRACE_SCOPE(BUCKET_SCAN);
+	ListPtr& ptr = _table[i];
 	if (!ptr) {
 		return false;
 	}
-	return ptr->remove(HashNode<K, V>(key));
+	HashNode<K, V> *node = ptr->find(HashNode<K, V>(key));
+	if (node == nullptr || !(node->get_value() == value)) {
+		return false;
+	}
+	ptr->remove(HashNode<K, V>(key));
+	--_size;
+	return true;
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 V* HashMap<K, V, F>::get(const K& key) const
 {
 	if (empty()) {
 		return nullptr;
 	}
-
-	ListPtr ptr = _table[_hash{}(key) % _buckets];
+	std::size_t i = bucket(key);
+	auto lock = lock_bucket(i);
+	CSC_TRACE_SCOPE(BUCKET_SCAN);
+	const ListPtr& ptr = _table[i];
 	if (!ptr) {
 		return nullptr;
 	}
@@ -172,33 +251,25 @@ V* HashMap<K, V, F>::get(const K& key) const
 	if (node == nullptr) {
 		return nullptr;
 	}
-
-	V *v = node->get_value();
-	node = nullptr;
-	return v;
+	return &node->get_value();
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 bool HashMap<K, V, F>::contains(const K& key) const
 {
-	if (empty()) {
-		return false;
-	}
-	ListPtr ptr = _table[_hash{}(key) % _buckets];
-	if (!ptr) {
-		return false;
-	}
-	return ptr->contains(HashNode<K, V>(key));
+	return get(key) != nullptr;
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 bool HashMap<K, V, F>::replace(const K& key, const V& value)
 {
 	if (empty()) {
 		return false;
 	}
-
-	ListPtr ptr = _table[_hash{}(key) % _buckets];
+	std::size_t i = bucket(key);
+	auto lock = lock_bucket(i);
+	CSC_TRACE_SCOPE(BUCKET_SCAN);
+	ListPtr& ptr = _table[i];
 	if (!ptr) {
 		return false;
 	}
@@ -207,32 +278,232 @@ bool HashMap<K, V, F>::replace(const K& key, const V& value)
 	if (node == nullptr) {
 		return false;
 	}
-
 	node->set_value(value);
-	node == nullptr;
 	return true;
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 bool HashMap<K, V, F>::empty() const
 {
-	return _table == nullptr && _size == 0;
+	return _size == 0;
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 std::size_t HashMap<K, V, F>::size() const
 {
 	return _size;
 }
 
-template <typename K, typename V, typename F = Hash>
+template <typename K, typename V, typename F>
 void HashMap<K, V, F>::clear()
+{
+	// Each bucket's smart ListPtr frees its list when reset.
+	for (std::size_t i = 0; i < _buckets; ++i) {
+		auto lock = lock_bucket(i);
+		_table[i].reset();
+	}
+	_size = 0;
+}
+
+template <typename K, typename V, typename F>
+std::unique_lock<std::mutex> HashMap<K, V, F>::lock_bucket(
+	std::size_t bucket) const
+{
+	if (!_locks) {
+		return std::unique_lock<std::mutex>();
+	}
+	return std::unique_lock<std::mutex>(_locks[bucket % LOCK_STRIPES]);
+}
+
+template <typename K, typename V, typename F>
+std::size_t HashMap<K, V, F>::bulk_grain(const ThreadPool& pool) const
+{
+	std::size_t grain = _buckets / (4 * (pool.size() + 1));
+	if (grain > BULK_GRAIN) {
+		grain = BULK_GRAIN;
+	}
+	return grain > 0 ? grain : 1;
+}
+
+template <typename K, typename V, typename F>
+template <typename Fn>
+void HashMap<K, V, F>::for_each(Fn fn, ThreadPool& pool) const
+{
+	pool.parallel_for(_buckets, bulk_grain(pool), 
+		[this, &fn](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			// Lock one bucket at a time, so point operations on the rest of
+			// the range are not held up for the whole walk.
+			auto lock = lock_bucket(i);
+			if (!_table[i]) {
+				continue;
+			}
+			for (const HashNode<K, V>& node : *_table[i]) {
+				fn(node.get_key(), node.get_value());
+			}
+		}
+	});
+}
+
+template <typename K, typename V, typename F>
+template <typename Pred>
+std::size_t HashMap<K, V, F>::erase_if(Pred pred, ThreadPool& pool)
+{
+	std::atomic<std::size_t> erased(0);
+	pool.parallel_for(_buckets, bulk_grain(pool), 
+		[this, &pred, &erased](std::size_t begin, std::size_t end) {
+		std::vector<K> victims;
+		std::size_t count = 0;
+		for (std::size_t i = begin; i < end; ++i) {
+			auto lock = lock_bucket(i);
+			if (!_table[i]) {
+				continue;
+			}
+			// Don't remove while iterating the bucket; gather first.
+			victims.clear();
+			for (const HashNode<K, V>& node : *_table[i]) {
+				if (pred(node.get_key(), node.get_value())) {
+					victims.push_back(node.get_key());
+				}
+			}
+			for (const K& key : victims) {
+				if (_table[i]->remove(HashNode<K, V>(key))) {
+					++count;
+				}
+			}
+		}
+		// One atomic add per range rather than per entry.
+		erased += count;
+	});
+	_size -= erased;
+	return erased;
+}
+
+template <typename K, typename V, typename F>
+template <typename Pred>
+std::vector<std::pair<K, V>> HashMap<K, V, F>::collect(Pred pred, 
+	ThreadPool& pool) const
+{
+	// Each range fills its own vector, so ranges never contend; the vectors
+	// are spliced together in table order afterwards.
+	std::size_t grain = bulk_grain(pool);
+	std::vector<std::vector<std::pair<K, V>>> parts(
+		(_buckets + grain - 1) / grain);
+	pool.parallel_for(_buckets, grain, 
+		[this, &pred, &parts, grain](std::size_t begin, std::size_t end) {
+		std::vector<std::pair<K, V>>& part = parts[begin / grain];
+		for (std::size_t i = begin; i < end; ++i) {
+			auto lock = lock_bucket(i);
+			if (!_table[i]) {
+				continue;
+			}
+			for (const HashNode<K, V>& node : *_table[i]) {
+				if (pred(node.get_key(), node.get_value())) {
+					part.emplace_back(node.get_key(), node.get_value());
+				}
+			}
+		}
+	});
+
+	std::size_t total = 0;
+	for (const auto& part : parts) {
+		total += part.size();
+	}
+	std::vector<std::pair<K, V>> out;
+	out.reserve(total);
+	for (auto& part : parts) {
+		std::move(part.begin(), part.end(), std::back_inserter(out));
+	}
+	return out;
+}
+
+template <typename K, typename V, typename F>
+void HashMap<K, V, F>::dump(std::ostream& out) const
+{
+	BinaryWriter writer(out);
+	const std::uint64_t count = _size;
+	write_dump_header(writer, DumpKind::HASH_MAP, count);
+	std::uint64_t written = 0;
+	for (std::size_t i = 0; i < _buckets; ++i) {
+		if (!_table[i]) {
+			continue;
+		}
+		for (const HashNode<K, V>& node : *_table[i]) {
+			Codec<K>::write(writer, node.get_key());
+			Codec<V>::write(writer, node.get_value());
+			++written;
+		}
+	}
+	if (written != count) {
+		throw std::logic_error("HashMap changed while it was dumped");
+	}
+	write_dump_trailer(writer, count);
+	writer.flush();
+}
+
+template <typename K, typename V, typename F>
+void HashMap<K, V, F>::load(std::istream& in)
+{
+	BinaryReader reader(in);
+	DumpHeader header = read_dump_header(reader);
+	if (header.kind != DumpKind::HASH_MAP) {
+		throw std::runtime_error("Not a HashMap dump");
+	}
+	clear();
+	// reserve() caps the count; a count larger than the stream holds fails
+	// at its end rather than up front, and past the cap the table doubles
+	// as entries arrive.
+	reserve(static_cast<std::size_t>(std::min<std::uint64_t>(header.count, 
+		MAX_RESERVE)));
+	for (std::uint64_t n = 0; n < header.count; ++n) {
+		K key = Codec<K>::read(reader);
+		V value = Codec<V>::read(reader);
+		insert(key, value);
+		if (_size > _buckets) {
+			rehash(_buckets * 2);
+		}
+	}
+	read_dump_trailer(reader, header.count);
+}
+
+template <typename K, typename V, typename F>
+void HashMap<K, V, F>::reserve(std::size_t count)
 {
 	if (!empty()) {
-		// When table is deleted, its smart ListPtrs will lose scope and call
-		// their destructors.
-		delete[] _table;
-		_table = nullptr;
+		return;
+	}
+	// Capped, so the doubling below can neither overflow nor run away.
+	count = std::min(count, MAX_RESERVE);
+	std::size_t buckets = TABLE_BUCKETS;
+	while (buckets < count) {
+		buckets <<= 1;
+	}
+	if (buckets <= _buckets) {
+		return;
+	}
+	delete[] _table;
+	_table = new ListPtr[buckets];
+	_buckets = buckets;
+}
+
+template <typename K, typename V, typename F>
+void HashMap<K, V, F>::rehash(std::size_t buckets)
+{
+	ListPtr *table = new ListPtr[buckets];
+	for (std::size_t i = 0; i < _buckets; ++i) {
+		if (!_table[i]) {
+			continue;
+		}
+		for (const HashNode<K, V>& node : *_table[i]) {
+			// Keys are distinct already, so no find() before the insert.
+			ListPtr& ptr = table[_hash(node.get_key()) % buckets];
+			if (!ptr) {
+				ptr = std::make_unique<SinglyLinkedList<HashNode<K, V>>>();
+			}
+			ptr->insert(node);
+		}
 	}
-	// else, do nothing
+	delete[] _table;
+	_table = table;
+	_buckets = buckets;
 }
@@ -0,0 +1,151 @@
+/**
+ * @file hot-keys.tpp
+ * @class HotKeys
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * HotKeys implementation.
+ */
+
+#include "hot-keys.h"
+
+#include <algorithm>
+
+using namespace csc;
+
+template <typename K>
+HotKeys<K>::HotKeys(const HotKeyOptions& options) :
+	_options(options),
+	_samples(0)
+{
+	_options.capacity = std::max<std::size_t>(_options.capacity, 1);
+	_options.sample_every = std::max<std::uint32_t>(_options.sample_every, 1);
+	_options.window = std::max<std::uint64_t>(_options.window, 2);
+	_heap.reserve(_options.capacity);
+	_pos.reserve(_options.capacity);
+}
+
+template <typename K>
+bool HotKeys<K>::record(const K& key)
+{
+	// A per-thread tick keeps the sampling decision off shared memory.
+	static thread_local std::uint32_t tick = 0;
+	if (++tick < _options.sample_every) {
+		return false;
+	}
+	tick = 0;
+	std::unique_lock<std::mutex> lock(_mutex, std::try_to_lock);
+	if (!lock) {
+		return false;
+	}
+	return count(key);
+}
+
+template <typename K>
+bool HotKeys<K>::count(const K& key)
+{
+	std::size_t i;
+	auto it = _pos.find(key);
+	if (it != _pos.end()) {
+		i = it->second;
+		++_heap[i].count;
+	} else if (_heap.size() < _options.capacity) {
+		i = _heap.size();
+		_heap.push_back(HotKey<K>{key, 1, 0});
+		_pos[key] = i;
+		sift_up(i);
+		i = _pos[key];
+	} else {
+		// Take over the smallest counter.
+		i = 0;
+		_pos.erase(_heap[0].key);
+		std::uint64_t min = _heap[0].count;
+		_heap[0] = HotKey<K>{key, min + 1, min};
+		_pos[key] = 0;
+	}
+	sift_down(i);
+	const HotKey<K>& entry = _heap[_pos[key]];
+	std::uint64_t sure = entry.count - entry.error;
+	// A floor on the count keeps a cold start from calling everything hot.
+	bool hot = sure >= MIN_HOT_COUNT && static_cast<double>(sure) >=
+		_options.threshold * static_cast<double>(_samples + 1);
+
+	if (++_samples >= _options.window) {
+		// Halving keeps the heap order, since x <= y implies x/2 <= y/2.
+		for (HotKey<K>& h : _heap) {
+			h.count /= 2;
+			h.error /= 2;
+		}
+		_samples /= 2;
+	}
+	return hot;
+}
+
+template <typename K>
+std::vector<HotKey<K>> HotKeys<K>::top(std::size_t k)
+{
+	std::vector<HotKey<K>> out;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		out = _heap;
+	}
+	std::sort(out.begin(), out.end(),
+		[](const HotKey<K>& a, const HotKey<K>& b) {
+			return a.count > b.count;
+		});
+	if (out.size() > k) {
+		out.resize(k);
+	}
+	return out;
+}
+
+template <typename K>
+std::uint64_t HotKeys<K>::samples()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _samples;
+}
+
+template <typename K>
+void HotKeys<K>::sift_down(std::size_t i)
+{
+	for (;;) {
+		std::size_t left = 2 * i + 1;
+		std::size_t right = left + 1;
+		std::size_t min = i;
+		if (left < _heap.size() && _heap[left].count < _heap[min].count) {
+			min = left;
+		}
+		if (right < _heap.size() && _heap[right].count < _heap[min].count) {
+			min = right;
+		}
+		if (min == i) {
+			return;
+		}
+		swap(i, min);
+		i = min;
+	}
+}
+
+template <typename K>
+void HotKeys<K>::sift_up(std::size_t i)
+{
+	while (i > 0) {
+		std::size_t parent = (i - 1) / 2;
+		if (!(_heap[i].count < _heap[parent].count)) {
+			return;
+		}
+		swap(i, parent);
+		i = parent;
+	}
+}
+
+template <typename K>
+void HotKeys<K>::swap(std::size_t a, std::size_t b)
+{
+	std::swap(_heap[a], _heap[b]);
+	_pos[_heap[a].key] = a;
+	_pos[_heap[b].key] = b;
+}
@@ -0,0 +1,212 @@
+/**
+ * @file load-driver.cpp
+ * @class LoadDriver
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * LoadDriver implementation.
+ */
+
+#include "load-driver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace csc;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+std::uint64_t nanoseconds(Clock::duration d)
+{
+	return static_cast<std::uint64_t>(std::max<std::int64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(), 0));
+}
+}
+
+LoadDriver::LoadDriver(const LoadOptions& options) :
+	_options(options)
+{
+	_options.threads = std::max<std::size_t>(_options.threads, 1);
+	_options.batch = std::max<std::size_t>(_options.batch, 1);
+}
+
+void LoadDriver::pin(std::size_t core)
+{
+#ifdef __linux__
+	unsigned cores = std::max(std::thread::hardware_concurrency(), 1u);
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core % cores, &set);
+	// Best effort: a cpuset may forbid the core.
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+	(void)core;
+#endif
+}
+
+std::chrono::steady_clock::time_point LoadDriver::arrive(
+	Barrier& barrier) const
+{
+	std::unique_lock<std::mutex> lock(barrier.mutex);
+	if (++barrier.waiting == _options.threads) {
+		barrier.start = Clock::now();
+		barrier.released.notify_all();
+	} else {
+		barrier.released.wait(lock, [this, &barrier]() {
+			return barrier.waiting == _options.threads;
+		});
+	}
+	return barrier.start;
+}
+
+ThreadLoad LoadDriver::drive(std::size_t index, const Executor& executor,
+	Barrier& barrier)
+{
+	if (_options.pin) {
+		pin(index);
+	}
+	util::WorkloadOptions workload = _options.workload;
+	workload.keys.seed += index;
+	workload.insert_offset += index * workload.insert_stride;
+	workload.insert_stride *= _options.threads;
+	util::Workload generator(workload);
+	LatencyHistogram latency;
+
+	bool open = _options.rate > 0;
+	Clock::duration interval{};
+	std::size_t size = _options.batch;
+	if (open) {
+		double per_second = _options.rate /
+			static_cast<double>(_options.threads);
+		interval = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(1.0 / per_second));
+		// A refill mid-run would hold up every operation due behind it.
+		double needed = _options.ops > 0 ?
+			static_cast<double>(_options.ops) : per_second *
+			std::chrono::duration<double>(_options.duration).count() + 1;
+		size = static_cast<std::size_t>(std::min(needed,
+			static_cast<double>(MAX_SCHEDULE)));
+	}
+	std::vector<util::Op> ops(std::max<std::size_t>(size, 1));
+	generator.fill(ops.data(), ops.size());
+
+	ThreadLoad result;
+	// Every thread counts from the release, so time spent waking up is
+	// charged to the run rather than dropped from it.
+	Clock::time_point start = arrive(barrier);
+	Clock::time_point stop = start + _options.duration;
+	Clock::time_point due = start;
+	std::size_t next = 0;
+	while (_options.ops > 0 ? result.ops < _options.ops :
+		Clock::now() < stop) {
+		if (next == ops.size()) {
+			// Closed-loop, only the executor's calls are timed.
+			if (!open) {
+				generator.fill(ops.data(), ops.size());
+			}
+			next = 0;
+		}
+		const util::Op& op = ops[next++];
+		Clock::time_point sent;
+		if (open) {
+			while ((sent = Clock::now()) < due) {
+				std::this_thread::yield();
+			}
+		} else {
+			sent = Clock::now();
+		}
+		executor(op);
+		Clock::time_point end = Clock::now();
+		latency.record(nanoseconds(end - (open ? due : sent)));
+		due += interval;
+		++result.ops;
+	}
+	result.seconds = std::chrono::duration<double>(Clock::now() - start)
+		.count();
+	result.latency = latency.snapshot();
+	return result;
+}
+
+LoadReport LoadDriver::run(const Executor& executor)
+{
+	LoadReport report;
+	report.threads.resize(_options.threads);
+	std::vector<std::thread> threads;
+	threads.reserve(_options.threads);
+	Barrier barrier;
+	for (std::size_t i = 0; i < _options.threads; ++i) {
+		threads.emplace_back([this, i, &executor, &report, &barrier]() {
+			report.threads[i] = drive(i, executor, barrier);
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	// Each thread's time runs from the same release, so the longest is the
+	// wall time of the run.
+	for (const ThreadLoad& thread : report.threads) {
+		report.seconds = std::max(report.seconds, thread.seconds);
+	}
+
+	double sum = 0;
+	double squares = 0;
+	report.latency.counts.assign(LatencyHistogram::BUCKETS, 0);
+	for (const ThreadLoad& thread : report.threads) {
+		report.ops += thread.ops;
+		double rate = thread.seconds > 0 ?
+			static_cast<double>(thread.ops) / thread.seconds : 0;
+		sum += rate;
+		squares += rate * rate;
+		for (std::size_t b = 0; b < thread.latency.counts.size(); ++b) {
+			report.latency.counts[b] += thread.latency.counts[b];
+		}
+		report.latency.count += thread.latency.count;
+	}
+	report.ops_per_sec = report.seconds > 0 ?
+		static_cast<double>(report.ops) / report.seconds : 0;
+	if (squares > 0) {
+		report.fairness = sum * sum /
+			(static_cast<double>(report.threads.size()) * squares);
+	}
+	return report;
+}
+
+void LoadReport::print(std::ostream& out) const
+{
+	out << "threads " << threads.size() << ", " << ops << " ops in " <<
+		seconds << " s: " << static_cast<std::uint64_t>(ops_per_sec) <<
+		" ops/s, fairness " << fairness << '\n';
+	out << "latency ns: p50 " << latency.percentile(0.5) << ", p99 " <<
+		latency.percentile(0.99) << ", p999 " << latency.percentile(0.999) <<
+		", max " << latency.percentile(1.0) << '\n';
+	for (std::size_t i = 0; i < threads.size(); ++i) {
+		const ThreadLoad& thread = threads[i];
+		out << "  thread " << i << ": " << thread.ops << " ops, p99 " <<
+			thread.latency.percentile(0.99) << " ns\n";
+	}
+}
+
+void LoadReport::json(std::ostream& out) const
+{
+	out << "{\"threads\": " << threads.size() << ", \"ops\": " << ops <<
+		", \"seconds\": " << seconds << ", \"ops_per_sec\": " << ops_per_sec <<
+		", \"fairness\": " << fairness <<
+		", \"p50_ns\": " << latency.percentile(0.5) <<
+		", \"p99_ns\": " << latency.percentile(0.99) <<
+		", \"p999_ns\": " << latency.percentile(0.999) <<
+		", \"max_ns\": " << latency.percentile(1.0) <<
+		", \"per_thread_ops\": [";
+	for (std::size_t i = 0; i < threads.size(); ++i) {
+		out << (i == 0 ? "" : ", ") << threads[i].ops;
+	}
+	out << "]}\n";
+}
@@ -0,0 +1,205 @@
+/**
+ * @file load-main.cpp
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Entry point of cache-load: CacheManager under load from several pinned
+ * threads, closed-loop or at a fixed rate, for throughput, fairness and
+ * tail latency. --sweep repeats the run at 1, 2, 4, ... threads up to
+ * --threads, to find where scaling stops.
+ *
+ * Usage: cache-load [--threads=<n>] [--sweep] [--duration=<ms>]
+ *                   [--ops=<per thread>] [--rate=<ops/s>] [--no-pin]
+ *                   [--workload=<A-F>] [--read=<p>] [--update=<p>]
+ *                   [--insert=<p>] [--distribution=<name>] [--theta=<t>]
+ *                   [--items=<n>] [--capacity=<n>] [--seed=<n>] [--json]
+ */
+
+#include "load-driver.h"
+#include "cache-manager.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace csc;
+
+namespace {
+/**
+* CacheManager's constructor is protected; it is a singleton.
+*/
+class LoadCache : public CacheManager<std::uint64_t, std::uint64_t> {
+public:
+	explicit LoadCache(std::size_t capacity) : CacheManager(capacity) {}
+};
+
+util::Distribution distribution(const std::string& name)
+{
+	if (name == "uniform") {
+		return util::Distribution::UNIFORM;
+	} else if (name == "zipfian") {
+		return util::Distribution::ZIPFIAN;
+	} else if (name == "scrambled") {
+		return util::Distribution::SCRAMBLED_ZIPFIAN;
+	} else if (name == "hotspot") {
+		return util::Distribution::HOTSPOT;
+	} else if (name == "latest") {
+		return util::Distribution::LATEST;
+	} else if (name == "sequential") {
+		return util::Distribution::SEQUENTIAL;
+	}
+	throw std::invalid_argument("No distribution " + name);
+}
+
+/**
+ * Applies one operation. The value stored is the key itself, so nothing
+ * is allocated on the clock; op.length only sizes scans.
+ */
+void apply(LoadCache& cache, const util::Op& op)
+{
+	switch (op.type) {
+	case util::OpType::READ:
+		cache.get(op.key);
+		break;
+	case util::OpType::UPDATE:
+	case util::OpType::INSERT:
+		cache.insert(op.key, op.key);
+		break;
+	case util::OpType::SCAN:
+		for (std::uint64_t k = op.key; k < op.key + op.length; ++k) {
+			cache.get(k);
+		}
+		break;
+	case util::OpType::READ_MODIFY_WRITE:
+		cache.get(op.key);
+		cache.insert(op.key, op.key);
+		break;
+	}
+}
+
+LoadReport run(const LoadOptions& options, std::size_t capacity)
+{
+	LoadCache cache(capacity);
+	// Warm the cache with the key space, or as much of it as fits.
+	std::uint64_t items = options.workload.keys.items;
+	for (std::uint64_t k = 0; k < items && k < capacity; ++k) {
+		cache.insert(k, k);
+	}
+	LoadDriver driver(options);
+	return driver.run([&cache](const util::Op& op) { apply(cache, op); });
+}
+
+std::uint64_t number(const std::string& arg, std::size_t prefix)
+{
+	return std::strtoull(arg.c_str() + prefix, nullptr, 10);
+}
+}
+
+int main(int argc, char **argv)
+{
+	LoadOptions options;
+	options.threads = std::max(std::thread::hardware_concurrency(), 1u);
+	options.workload = util::ycsb('B', 100000);
+	std::size_t capacity = 10000;
+	std::uint64_t seed = 1;
+	bool sweep = false;
+	bool json = false;
+	try {
+		// The preset first, so the flags below refine it in any order.
+		for (int i = 1; i < argc; ++i) {
+			std::string arg = argv[i];
+			if (arg.rfind("--workload=", 0) == 0 && arg.size() == 12) {
+				options.workload = util::ycsb(arg[11],
+					options.workload.keys.items);
+			}
+		}
+		for (int i = 1; i < argc; ++i) {
+			std::string arg = argv[i];
+			util::WorkloadOptions& workload = options.workload;
+			if (arg == "--sweep") {
+				sweep = true;
+			} else if (arg == "--json") {
+				json = true;
+			} else if (arg == "--no-pin") {
+				options.pin = false;
+			} else if (arg.rfind("--threads=", 0) == 0) {
+				options.threads = number(arg, 10);
+			} else if (arg.rfind("--duration=", 0) == 0) {
+				options.duration = std::chrono::milliseconds(number(arg, 11));
+			} else if (arg.rfind("--ops=", 0) == 0) {
+				options.ops = number(arg, 6);
+			} else if (arg.rfind("--rate=", 0) == 0) {
+				options.rate = std::strtod(arg.c_str() + 7, nullptr);
+			} else if (arg.rfind("--workload=", 0) == 0 && arg.size() == 12) {
+				// Applied above.
+			} else if (arg.rfind("--read=", 0) == 0) {
+				workload.read = std::strtod(arg.c_str() + 7, nullptr);
+			} else if (arg.rfind("--update=", 0) == 0) {
+				workload.update = std::strtod(arg.c_str() + 9, nullptr);
+			} else if (arg.rfind("--insert=", 0) == 0) {
+				workload.insert = std::strtod(arg.c_str() + 9, nullptr);
+			} else if (arg.rfind("--distribution=", 0) == 0) {
+				workload.keys.distribution = distribution(arg.substr(15));
+			} else if (arg.rfind("--theta=", 0) == 0) {
+				workload.keys.theta = std::strtod(arg.c_str() + 8, nullptr);
+			} else if (arg.rfind("--items=", 0) == 0) {
+				workload.keys.items = number(arg, 8);
+			} else if (arg.rfind("--capacity=", 0) == 0) {
+				capacity = number(arg, 11);
+			} else if (arg.rfind("--seed=", 0) == 0) {
+				seed = number(arg, 7);
+			} else {
+				std::cerr << "Usage: " << argv[0] << " [--threads=<n>]" <<
+					" [--sweep] [--duration=<ms>] [--ops=<per thread>]" <<
+					" [--rate=<ops/s>] [--no-pin] [--workload=<A-F>]" <<
+					" [--read=<p>] [--update=<p>] [--insert=<p>]" <<
+					" [--distribution=uniform|zipfian|scrambled|hotspot|" <<
+					"latest|sequential] [--theta=<t>] [--items=<n>]" <<
+					" [--capacity=<n>] [--seed=<n>] [--json]\n";
+				return 2;
+			}
+		}
+		options.workload.keys.seed = seed;
+
+		if (!sweep) {
+			LoadReport report = run(options, capacity);
+			if (json) {
+				report.json(std::cout);
+			} else {
+				report.print(std::cout);
+			}
+			return 0;
+		}
+		std::size_t most = std::max<std::size_t>(options.threads, 1);
+		double single = 0;
+		for (std::size_t threads = 1; ; threads *= 2) {
+			options.threads = std::min(threads, most);
+			LoadReport report = run(options, capacity);
+			if (json) {
+				report.json(std::cout);
+			} else {
+				if (options.threads == 1) {
+					single = report.ops_per_sec;
+				}
+				double speedup = single > 0 ? report.ops_per_sec / single : 0;
+				std::cout << options.threads << " threads: " <<
+					static_cast<std::uint64_t>(report.ops_per_sec) <<
+					" ops/s, speedup " << speedup << ", efficiency " <<
+					speedup / static_cast<double>(options.threads) <<
+					", p99 " << report.latency.percentile(0.99) << " ns\n";
+			}
+			if (options.threads == most) {
+				break;
+			}
+		}
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
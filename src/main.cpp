@@ -2,7 +2,59 @@
 #include "test.h"
 #include "linked-list.h"
 
-int main()
+#include <cstring>
+#include <iostream>
+
+namespace {
+struct TestCase {
+	const char *name;
+	void (*run)();
+};
+
+// Each is registered with ctest by name; see CMakeLists.txt.
+const TestCase TESTS[] = {
+	{"node", test::node},
+	{"linked_list", test::linked_list},
+	{"hash_map", test::hash_map},
+	{"thread_pool", test::thread_pool},
+	{"binary_io", test::binary_io},
+	{"mapped_cache", test::mapped_cache},
+	{"shared_cache", test::shared_cache},
+	{"spill_tier", test::spill_tier},
+	{"write_back", test::write_back},
+	{"negative_cache", test::negative_cache},
+	{"hot_keys", test::hot_keys},
+	{"removal_listener", test::removal_listener},
+	{"maintenance", test::maintenance},
+	{"memory_pressure", test::memory_pressure},
+	{"shards", test::shards},
+	{"cache_stats", test::cache_stats},
+	{"trace", test::trace},
+	{"workload", test::workload},
+	{"cache_sim", test::cache_sim},
+	{"alloc_counter", test::alloc_counter},
+	{"bplus_tree", test::bplus_tree},
+	{"cache_manager", test::cache_manager},
+};
+}
+
+/**
+ * Runs every test case, or only the one named by the first argument.
+ */
+int main(int argc, char *argv[])
 {
-	test::linked_list();
+	const char *only = argc > 1 ? argv[1] : nullptr;
+	bool found = false;
+	for (const TestCase& test : TESTS) {
+		if (only != nullptr && std::strcmp(only, test.name) != 0) {
+			continue;
+		}
+		found = true;
+		test.run();
+	}
+	if (!found) {
+		std::cerr << "No test named " << only << '\n';
+		return 1;
+	}
+	return 0;
 }
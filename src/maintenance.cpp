@@ -0,0 +1,128 @@
+/**
+ * @file maintenance.cpp
+ * @class Maintenance
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Maintenance implementation.
+ */
+
+#include "maintenance.h"
+
+#include <algorithm>
+
+using namespace csc;
+
+Maintenance::Maintenance(const MaintenanceOptions& options) :
+	_options(options),
+	_writes(0),
+	_runs(0),
+	_interval_us(options.max_interval.count()),
+	_last_run(Clock::now()),
+	_last_writes(0),
+	_stop(false)
+{
+	_options.min_interval = std::max(_options.min_interval,
+		std::chrono::microseconds(1));
+	_options.max_interval = std::max(_options.max_interval,
+		_options.min_interval);
+	_options.writes_per_run = std::max<std::uint64_t>(
+		_options.writes_per_run, 1);
+	if (_options.own_thread) {
+		_thread = std::thread(&Maintenance::run, this);
+	}
+}
+
+Maintenance::~Maintenance()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+void Maintenance::add_task(const std::string& name, Task task,
+	std::chrono::milliseconds every)
+{
+	std::lock_guard<std::mutex> lock(_run_mutex);
+	_tasks.push_back(Entry{name, std::move(task), every,
+		Clock::time_point()});
+}
+
+void Maintenance::note_write()
+{
+	_writes.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::chrono::microseconds Maintenance::run_once()
+{
+	std::lock_guard<std::mutex> lock(_run_mutex);
+	bool backlog = false;
+	for (Entry& entry : _tasks) {
+		Clock::time_point now = Clock::now();
+		if (entry.every.count() > 0 && now - entry.last < entry.every) {
+			continue;
+		}
+		entry.last = now;
+		try {
+			backlog |= entry.task(now + _options.slice);
+		} catch (...) {
+			// A failed slice is retried on the next run.
+		}
+	}
+
+	// Pace by the write rate since the last run.
+	Clock::time_point now = Clock::now();
+	std::uint64_t writes = _writes.load(std::memory_order_relaxed);
+	double elapsed = std::chrono::duration<double, std::micro>(
+		now - _last_run).count();
+	double rate = static_cast<double>(writes - _last_writes) /
+		std::max(elapsed, 1.0);
+	_last_run = now;
+	_last_writes = writes;
+
+	std::chrono::microseconds next = _options.max_interval;
+	if (backlog) {
+		next = _options.min_interval;
+	} else if (rate > 0) {
+		double us = static_cast<double>(_options.writes_per_run) / rate;
+		if (us < static_cast<double>(_options.max_interval.count())) {
+			next = std::max(_options.min_interval,
+				std::chrono::microseconds(static_cast<std::int64_t>(us)));
+		}
+	}
+	_interval_us.store(next.count(), std::memory_order_relaxed);
+	_runs.fetch_add(1, std::memory_order_relaxed);
+	return next;
+}
+
+std::uint64_t Maintenance::runs() const
+{
+	return _runs.load(std::memory_order_relaxed);
+}
+
+std::chrono::microseconds Maintenance::interval() const
+{
+	return std::chrono::microseconds(
+		_interval_us.load(std::memory_order_relaxed));
+}
+
+void Maintenance::run()
+{
+	std::chrono::microseconds delay = _options.min_interval;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			if (_cv.wait_for(lock, delay, [this]() { return _stop; })) {
+				return;
+			}
+		}
+		delay = run_once();
+	}
+}
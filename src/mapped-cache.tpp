@@ -0,0 +1,456 @@
+/**
+ * @file mapped-cache.tpp
+ * @class MappedCache
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * MappedCache implementation.
+ */
+
+#include "mapped-cache.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+
+#include <time.h>
+
+using namespace csc;
+
+namespace {
+	constexpr std::size_t round_up(std::size_t n, std::size_t align)
+	{
+		return (n + align - 1) / align * align;
+	}
+}
+
+template <typename K, typename V>
+MappedCache<K, V>::MappedCache(const std::string& path, std::size_t capacity,
+	Backing backing) :
+	_capacity(checked_capacity(capacity)),
+	_region(open_region(path, _capacity, backing)),
+	_header(static_cast<Header*>(_region.data())),
+	_buckets(reinterpret_cast<std::uint32_t*>(
+		static_cast<char*>(_region.data()) + buckets_offset())),
+	_slots(reinterpret_cast<Slot*>(
+		static_cast<char*>(_region.data()) + slots_offset(capacity))),
+	_restored(false),
+	_shared(backing == Backing::SHARED_MEMORY)
+{
+	if (_shared) {
+		if (_region.created()) {
+			format();
+			init_mutex();
+			// Publish the arena to processes waiting in wait_ready().
+			__atomic_store_n(&_header->ready, 1, __ATOMIC_RELEASE);
+		} else {
+			wait_ready();
+			if (!compatible()) {
+				throw std::runtime_error(
+					"Shared MappedCache " + path + " has a different layout");
+			}
+			_restored = true;
+		}
+		return;
+	}
+
+	// A file has a single user, so its mutex is always re-initialized.
+	if (!_region.created() && valid()) {
+		_restored = true;
+	} else {
+		format();
+	}
+	init_mutex();
+	// Dirty until closed: a crash from here on leaves a file that is
+	// reformatted on the next start rather than trusted. The flag has to be
+	// on disk before the first change to the table is.
+	_header->clean = 0;
+	_region.sync(sizeof(Header));
+}
+
+template <typename K, typename V>
+MappedCache<K, V>::~MappedCache()
+{
+	if (_shared) {
+		return;
+	}
+	Guard guard(*this);
+	try {
+		// The entries must be on disk before the header says they are valid.
+		_region.sync();
+		_header->clean = 1;
+		_header->checksum = fnv1a(_header, offsetof(Header, checksum));
+		_region.sync();
+	} catch (...) {
+		// Leave the file dirty; it is reformatted next time.
+	}
+}
+
+template <typename K, typename V>
+std::size_t MappedCache<K, V>::checked_capacity(std::size_t capacity)
+{
+	// Links are 32-bit slot indices with 0 reserved for null.
+	if (capacity == 0 ||
+		capacity >= std::numeric_limits<std::uint32_t>::max()) {
+		throw std::invalid_argument("MappedCache capacity out of range");
+	}
+	return capacity;
+}
+
+template <typename K, typename V>
+std::size_t MappedCache<K, V>::region_size(std::size_t capacity)
+{
+	return slots_offset(capacity) + capacity * sizeof(Slot);
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::unlink_shared(const std::string& name)
+{
+	MappedRegion::unlink_shm(name);
+}
+
+template <typename K, typename V>
+MappedRegion MappedCache<K, V>::open_region(const std::string& path,
+	std::size_t capacity, Backing backing)
+{
+	if (backing == Backing::SHARED_MEMORY) {
+		return MappedRegion::open_shm(path, region_size(capacity));
+	}
+	return MappedRegion::open_file(path, region_size(capacity));
+}
+
+template <typename K, typename V>
+std::size_t MappedCache<K, V>::bucket_count(std::size_t capacity)
+{
+	std::size_t buckets = 16;
+	while (buckets < capacity) {
+		buckets <<= 1;
+	}
+	return buckets;
+}
+
+template <typename K, typename V>
+std::size_t MappedCache<K, V>::buckets_offset()
+{
+	// Keep the header's hot fields off the first bucket's cache line.
+	return round_up(sizeof(Header), 64);
+}
+
+template <typename K, typename V>
+std::size_t MappedCache<K, V>::slots_offset(std::size_t capacity)
+{
+	return round_up(buckets_offset() +
+		bucket_count(capacity) * sizeof(std::uint32_t), 64);
+}
+
+template <typename K, typename V>
+std::uint64_t MappedCache<K, V>::fnv1a(const void* data, std::size_t n)
+{
+	const unsigned char *bytes = static_cast<const unsigned char*>(data);
+	std::uint64_t hash = 0xcbf29ce484222325;
+	for (std::size_t i = 0; i < n; ++i) {
+		hash = (hash ^ bytes[i]) * 0x100000001b3;
+	}
+	return hash;
+}
+
+template <typename K, typename V>
+bool MappedCache<K, V>::compatible() const
+{
+	return _header->magic == MAGIC &&
+		_header->version == VERSION &&
+		_header->key_size == sizeof(K) &&
+		_header->value_size == sizeof(V) &&
+		_header->capacity == _capacity &&
+		_header->buckets == bucket_count(_capacity);
+}
+
+template <typename K, typename V>
+bool MappedCache<K, V>::valid() const
+{
+	// Links are followed as soon as the file is trusted, so each must name
+	// a slot that was handed out.
+	return compatible() &&
+		_header->clean == 1 &&
+		_header->checksum == fnv1a(_header, offsetof(Header, checksum)) &&
+		_header->used <= _capacity &&
+		_header->count <= _header->used &&
+		_header->head <= _header->used &&
+		_header->tail <= _header->used &&
+		_header->free <= _header->used &&
+		(_header->head == 0) == (_header->tail == 0);
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::format()
+{
+	// A new file is already zeros; only a stale one needs its buckets wiped.
+	// Slots are handed out from `used` up, so they never need clearing.
+	if (!_region.created()) {
+		std::memset(_buckets, 0,
+			bucket_count(_capacity) * sizeof(std::uint32_t));
+	}
+	std::memset(_header, 0, sizeof(Header));
+	_header->magic = MAGIC;
+	_header->version = VERSION;
+	_header->key_size = sizeof(K);
+	_header->value_size = sizeof(V);
+	_header->capacity = _capacity;
+	_header->buckets = bucket_count(_capacity);
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::init_mutex()
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+	int rc = pthread_mutex_init(&_header->mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+	if (rc != 0) {
+		throw std::system_error(rc, std::generic_category(),
+			"pthread_mutex_init");
+	}
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::wait_ready() const
+{
+	for (int waited = 0;
+		__atomic_load_n(&_header->ready, __ATOMIC_ACQUIRE) == 0; ++waited) {
+		if (waited == READY_WAIT_MS) {
+			throw std::system_error(ETIMEDOUT, std::generic_category(),
+				"Shared MappedCache was never formatted");
+		}
+		struct timespec ms = {0, 1000000};
+		::nanosleep(&ms, nullptr);
+	}
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::reset()
+{
+	std::memset(_buckets, 0, _header->buckets * sizeof(std::uint32_t));
+	_header->count = 0;
+	_header->head = 0;
+	_header->tail = 0;
+	_header->free = 0;
+	_header->used = 0;
+	++_header->recoveries;
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::begin_write()
+{
+	_header->writing = 1;
+	// The flag must be visible before any link changes.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::end_write()
+{
+	// Every link change must be visible before the flag clears.
+	__atomic_store_n(&_header->writing, 0, __ATOMIC_RELEASE);
+}
+
+template <typename K, typename V>
+MappedCache<K, V>::Guard::Guard(MappedCache& cache) : _cache(cache)
+{
+	int rc = pthread_mutex_lock(&_cache._header->mutex);
+	if (rc == EOWNERDEAD) {
+		// The holder died. If it was mid-change the links can't be trusted,
+		// and the cheapest consistent state is an empty table.
+		if (_cache._header->writing != 0) {
+			_cache.reset();
+			_cache._header->writing = 0;
+		}
+		pthread_mutex_consistent(&_cache._header->mutex);
+	} else if (rc != 0) {
+		throw std::system_error(rc, std::generic_category(),
+			"pthread_mutex_lock");
+	}
+}
+
+template <typename K, typename V>
+MappedCache<K, V>::Guard::~Guard()
+{
+	pthread_mutex_unlock(&_cache._header->mutex);
+}
+
+template <typename K, typename V>
+std::uint32_t& MappedCache<K, V>::bucket(const K& key)
+{
+	return _buckets[fnv1a(&key, sizeof(K)) & (_header->buckets - 1)];
+}
+
+template <typename K, typename V>
+std::uint32_t* MappedCache<K, V>::find(const K& key)
+{
+	std::uint32_t *at = &bucket(key);
+	while (*at != 0) {
+		if (slot(*at).key == key) {
+			return at;
+		}
+		at = &slot(*at).chain;
+	}
+	return nullptr;
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::lru_unlink(std::uint32_t link)
+{
+	Slot& s = slot(link);
+	if (s.prev != 0) {
+		slot(s.prev).next = s.next;
+	} else {
+		_header->head = s.next;
+	}
+	if (s.next != 0) {
+		slot(s.next).prev = s.prev;
+	} else {
+		_header->tail = s.prev;
+	}
+	s.prev = s.next = 0;
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::lru_push_front(std::uint32_t link)
+{
+	Slot& s = slot(link);
+	s.prev = 0;
+	s.next = _header->head;
+	if (_header->head != 0) {
+		slot(_header->head).prev = link;
+	} else {
+		_header->tail = link;
+	}
+	_header->head = link;
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::erase(std::uint32_t* at)
+{
+	std::uint32_t link = *at;
+	Slot& s = slot(link);
+	*at = s.chain;
+	lru_unlink(link);
+	s.chain = _header->free;
+	_header->free = link;
+	--_header->count;
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::evict()
+{
+	if (_header->tail == 0) {
+		return;
+	}
+	std::uint32_t *at = find(slot(_header->tail).key);
+	erase(at);
+}
+
+template <typename K, typename V>
+bool MappedCache<K, V>::get(const K& key, V& value)
+{
+	Guard guard(*this);
+	std::uint32_t *at = find(key);
+	if (at == nullptr) {
+		return false;
+	}
+	std::uint32_t link = *at;
+	if (_header->head != link) {
+		begin_write();
+		lru_unlink(link);
+		lru_push_front(link);
+		end_write();
+	}
+	value = slot(link).value;
+	return true;
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::put(const K& key, const V& value)
+{
+	Guard guard(*this);
+	std::uint32_t *at = find(key);
+	begin_write();
+	if (at != nullptr) {
+		std::uint32_t link = *at;
+		slot(link).value = value;
+		if (_header->head != link) {
+			lru_unlink(link);
+			lru_push_front(link);
+		}
+		end_write();
+		return;
+	}
+	if (_header->count >= _capacity) {
+		evict();
+	}
+	// Reuse a freed slot, else take the next never-used one.
+	std::uint32_t link;
+	if (_header->free != 0) {
+		link = _header->free;
+		_header->free = slot(link).chain;
+	} else {
+		link = ++_header->used;
+	}
+	Slot& s = slot(link);
+	s.key = key;
+	s.value = value;
+	std::uint32_t& head = bucket(key);
+	s.chain = head;
+	head = link;
+	lru_push_front(link);
+	++_header->count;
+	end_write();
+}
+
+template <typename K, typename V>
+bool MappedCache<K, V>::remove(const K& key)
+{
+	Guard guard(*this);
+	std::uint32_t *at = find(key);
+	if (at == nullptr) {
+		return false;
+	}
+	begin_write();
+	erase(at);
+	end_write();
+	return true;
+}
+
+template <typename K, typename V>
+bool MappedCache<K, V>::contains(const K& key)
+{
+	Guard guard(*this);
+	return find(key) != nullptr;
+}
+
+template <typename K, typename V>
+std::size_t MappedCache<K, V>::size()
+{
+	Guard guard(*this);
+	return _header->count;
+}
+
+template <typename K, typename V>
+std::uint64_t MappedCache<K, V>::recoveries()
+{
+	Guard guard(*this);
+	return _header->recoveries;
+}
+
+template <typename K, typename V>
+void MappedCache<K, V>::sync()
+{
+	Guard guard(*this);
+	_region.sync();
+}
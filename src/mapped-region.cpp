@@ -0,0 +1,220 @@
+/**
+ * @file mapped-region.cpp
+ * @class MappedRegion
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * MappedRegion implementation.
+ */
+
+#include "mapped-region.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace csc;
+
+namespace {
+	[[noreturn]] void fail(const std::string& what)
+	{
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	// How long an opener waits for another process to size a new object.
+	constexpr int SHM_WAIT_MS = 5000;
+}
+
+MappedRegion MappedRegion::open_file(const std::string& path, std::size_t size)
+{
+	int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		fail("open " + path);
+	}
+	struct stat st;
+	if (::fstat(fd, &st) != 0) {
+		int saved = errno;
+		::close(fd);
+		errno = saved;
+		fail("fstat " + path);
+	}
+	// A file of the wrong size can't hold a previous run's data. It is
+	// emptied before it is resized, so that none of the old bytes survive
+	// and the whole mapping reads as zeros.
+	bool created = static_cast<std::size_t>(st.st_size) != size;
+	if (created && (::ftruncate(fd, 0) != 0 ||
+		::ftruncate(fd, static_cast<off_t>(size)) != 0)) {
+		int saved = errno;
+		::close(fd);
+		errno = saved;
+		fail("ftruncate " + path);
+	}
+	void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		fd, 0);
+	// The mapping keeps the file open; the descriptor isn't needed.
+	int saved = errno;
+	::close(fd);
+	if (data == MAP_FAILED) {
+		errno = saved;
+		fail("mmap " + path);
+	}
+	return MappedRegion(data, size, created);
+}
+
+MappedRegion MappedRegion::open_read(const std::string& path)
+{
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		fail("open " + path);
+	}
+	struct stat st;
+	if (::fstat(fd, &st) != 0) {
+		int saved = errno;
+		::close(fd);
+		errno = saved;
+		fail("fstat " + path);
+	}
+	std::size_t size = static_cast<std::size_t>(st.st_size);
+	if (size == 0) {
+		::close(fd);
+		return MappedRegion(nullptr, 0, false);
+	}
+	// Private and read-only: nothing is ever written back.
+	void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	int saved = errno;
+	::close(fd);
+	if (data == MAP_FAILED) {
+		errno = saved;
+		fail("mmap " + path);
+	}
+	::madvise(data, size, MADV_SEQUENTIAL);
+	return MappedRegion(data, size, false);
+}
+
+MappedRegion MappedRegion::open_shm(const std::string& name, std::size_t size)
+{
+	// Exactly one process wins O_EXCL and sizes the object.
+	int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+		0600);
+	bool created = fd >= 0;
+	if (created) {
+		if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+			int saved = errno;
+			::close(fd);
+			::shm_unlink(name.c_str());
+			errno = saved;
+			fail("ftruncate " + name);
+		}
+	} else {
+		if (errno != EEXIST) {
+			fail("shm_open " + name);
+		}
+		fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+		if (fd < 0) {
+			fail("shm_open " + name);
+		}
+		// The creator may not have sized the object yet.
+		for (int waited = 0; ; ++waited) {
+			struct stat st;
+			if (::fstat(fd, &st) != 0) {
+				int saved = errno;
+				::close(fd);
+				errno = saved;
+				fail("fstat " + name);
+			}
+			if (static_cast<std::size_t>(st.st_size) == size) {
+				break;
+			}
+			if (st.st_size != 0) {
+				::close(fd);
+				throw std::invalid_argument(
+					"Shared memory object " + name + " has a different size");
+			}
+			if (waited == SHM_WAIT_MS) {
+				::close(fd);
+				errno = ETIMEDOUT;
+				fail("shm_open " + name);
+			}
+			struct timespec ms = {0, 1000000};
+			::nanosleep(&ms, nullptr);
+		}
+	}
+	void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+		fd, 0);
+	int saved = errno;
+	::close(fd);
+	if (data == MAP_FAILED) {
+		errno = saved;
+		fail("mmap " + name);
+	}
+	return MappedRegion(data, size, created);
+}
+
+void MappedRegion::unlink_shm(const std::string& name)
+{
+	if (::shm_unlink(name.c_str()) != 0 && errno != ENOENT) {
+		fail("shm_unlink " + name);
+	}
+}
+
+MappedRegion::MappedRegion(void* data, std::size_t size, bool created) :
+	_data(data), _size(size), _created(created)
+{
+	// do nothing
+}
+
+MappedRegion::~MappedRegion()
+{
+	unmap();
+}
+
+MappedRegion::MappedRegion(MappedRegion&& other) noexcept :
+	_data(other._data), _size(other._size), _created(other._created)
+{
+	other._data = nullptr;
+	other._size = 0;
+}
+
+MappedRegion& MappedRegion::operator=(MappedRegion&& other) noexcept
+{
+	if (this != &other) {
+		unmap();
+		_data = other._data;
+		_size = other._size;
+		_created = other._created;
+		other._data = nullptr;
+		other._size = 0;
+	}
+	return *this;
+}
+
+void MappedRegion::sync()
+{
+	sync(_size);
+}
+
+void MappedRegion::sync(std::size_t bytes)
+{
+	if (_data != nullptr &&
+		::msync(_data, std::min(bytes, _size), MS_SYNC) != 0) {
+		fail("msync");
+	}
+}
+
+void MappedRegion::unmap()
+{
+	if (_data != nullptr) {
+		::munmap(_data, _size);
+		_data = nullptr;
+		_size = 0;
+	}
+}
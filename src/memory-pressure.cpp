@@ -0,0 +1,102 @@
+/**
+ * @file memory-pressure.cpp
+ * @class MemoryPressure
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * MemoryPressure implementation.
+ */
+
+#include "memory-pressure.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+using namespace csc;
+
+MemoryPressure::MemoryPressure(const MemoryPressureOptions& options,
+	std::size_t full_capacity) :
+	_options(options),
+	_full(full_capacity)
+{
+	_options.min_capacity = std::min(_options.min_capacity, _full);
+}
+
+bool MemoryPressure::read_number(const std::string& path,
+	std::uint64_t& value, std::size_t field)
+{
+	std::ifstream in(path);
+	std::string token;
+	for (std::size_t i = 0; i <= field; ++i) {
+		if (!(in >> token)) {
+			return false;
+		}
+	}
+	if (token.empty() || token.find_first_not_of("0123456789") !=
+		std::string::npos) {
+		return false;
+	}
+	try {
+		value = std::stoull(token);
+	} catch (const std::out_of_range&) {
+		return false;
+	}
+	return true;
+}
+
+double MemoryPressure::usage() const
+{
+	std::uint64_t used = 0;
+	std::uint64_t limit = 0;
+	if (_options.use_rss) {
+		// statm's second field is the resident set, in pages.
+		std::uint64_t pages = 0;
+		if (!read_number(_options.statm_path, pages, 1)) {
+			return -1.0;
+		}
+		used = pages * static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+		limit = _options.rss_limit;
+	} else if (!read_number(_options.current_path, used) ||
+		!read_number(_options.max_path, limit)) {
+		// An unlimited cgroup reads "max".
+		return -1.0;
+	}
+	if (limit == 0) {
+		return -1.0;
+	}
+	return static_cast<double>(used) / static_cast<double>(limit);
+}
+
+std::size_t MemoryPressure::adjust(std::size_t capacity) const
+{
+	return adjust(capacity, usage());
+}
+
+std::size_t MemoryPressure::adjust(std::size_t capacity, double u) const
+{
+	if (u < 0) {
+		return capacity;
+	}
+	std::size_t step = std::max<std::size_t>(
+		static_cast<std::size_t>(_options.step * static_cast<double>(_full)),
+		1);
+	if (u > _options.high) {
+		std::size_t cut = u > _options.critical ? 2 * step : step;
+		return capacity > _options.min_capacity + cut ?
+			capacity - cut : _options.min_capacity;
+	}
+	if (u < _options.low) {
+		return std::min(_full, capacity + std::max<std::size_t>(step / 2, 1));
+	}
+	return capacity;
+}
+
+const MemoryPressureOptions& MemoryPressure::options() const
+{
+	return _options;
+}
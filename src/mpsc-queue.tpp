@@ -0,0 +1,87 @@
+/**
+ * @file mpsc-queue.tpp
+ * @class MpscQueue
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * MpscQueue implementation.
+ */
+
+#include "mpsc-queue.h"
+
+#include <utility>
+
+using namespace csc;
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::size_t capacity) : _tail(0), _head(0)
+{
+	std::size_t n = 2;
+	while (n < capacity) {
+		n <<= 1;
+	}
+	_mask = n - 1;
+	_slots.reset(new Slot[n]);
+	for (std::size_t i = 0; i < n; ++i) {
+		_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template <typename T>
+bool MpscQueue<T>::try_push(T&& element)
+{
+	std::uint64_t pos = _tail.load(std::memory_order_relaxed);
+	for (;;) {
+		Slot& slot = _slots[pos & _mask];
+		std::uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+		std::int64_t diff = static_cast<std::int64_t>(seq) -
+			static_cast<std::int64_t>(pos);
+		if (diff == 0) {
+			// Free for this lap; claim it.
+			if (_tail.compare_exchange_weak(pos, pos + 1,
+				std::memory_order_relaxed)) {
+				slot.element = std::move(element);
+				slot.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (diff < 0) {
+			// Still holds last lap's element: full.
+			return false;
+		} else {
+			pos = _tail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T>
+std::size_t MpscQueue<T>::pop_batch(std::vector<T>& out, std::size_t max)
+{
+	std::size_t n = 0;
+	while (n < max) {
+		Slot& slot = _slots[_head & _mask];
+		if (slot.sequence.load(std::memory_order_acquire) != _head + 1) {
+			break;
+		}
+		out.push_back(std::move(slot.element));
+		// Hand the slot to the producer of the next lap.
+		slot.sequence.store(_head + _mask + 1, std::memory_order_release);
+		++_head;
+		++n;
+	}
+	return n;
+}
+
+template <typename T>
+bool MpscQueue<T>::empty() const
+{
+	const Slot& slot = _slots[_head & _mask];
+	return slot.sequence.load(std::memory_order_acquire) != _head + 1;
+}
+
+template <typename T>
+std::size_t MpscQueue<T>::capacity() const
+{
+	return _mask + 1;
+}
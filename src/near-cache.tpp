@@ -0,0 +1,90 @@
+/**
+ * @file near-cache.tpp
+ * @class NearCache
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * NearCache implementation.
+ */
+
+#include "near-cache.h"
+
+using namespace csc;
+
+template <typename K, typename V>
+NearCache<K, V>::NearCache(std::size_t slots)
+{
+	std::size_t n = 1;
+	while (2 * n < slots) {
+		n <<= 1;
+	}
+	_sets.resize(n);
+	_mask = n - 1;
+}
+
+template <typename K, typename V>
+std::size_t NearCache<K, V>::index(std::size_t hash) const
+{
+	// Mix so the index doesn't share bits with the VersionTable stripe.
+	std::uint64_t h = static_cast<std::uint64_t>(hash) *
+		0xff51afd7ed558ccdull;
+	return static_cast<std::size_t>(h >> 17) & _mask;
+}
+
+template <typename K, typename V>
+V* NearCache<K, V>::get(const K& key, std::size_t hash,
+	const VersionTable& versions)
+{
+	Set& set = _sets[index(hash)];
+	for (unsigned way = 0; way < 2; ++way) {
+		Slot& slot = set.ways[way];
+		if (!slot.used || !(slot.key == key)) {
+			continue;
+		}
+		if (versions.current(versions.stripe(hash)) != slot.version ||
+			(slot.deadline != Clock::time_point::max() &&
+			 Clock::now() >= slot.deadline)) {
+			slot.used = false;
+			set.victim = static_cast<unsigned char>(way);
+			return nullptr;
+		}
+		set.victim = static_cast<unsigned char>(way ^ 1);
+		return &slot.value;
+	}
+	return nullptr;
+}
+
+template <typename K, typename V>
+void NearCache<K, V>::put(const K& key, std::size_t hash, const V& value,
+	std::uint64_t version, Clock::time_point deadline)
+{
+	Set& set = _sets[index(hash)];
+	unsigned way = set.victim;
+	for (unsigned w = 0; w < 2; ++w) {
+		if (set.ways[w].used && set.ways[w].key == key) {
+			way = w;
+			break;
+		}
+		if (!set.ways[w].used) {
+			way = w;
+		}
+	}
+	Slot& slot = set.ways[way];
+	slot.used = true;
+	slot.key = key;
+	slot.value = value;
+	slot.version = version;
+	slot.deadline = deadline;
+	set.victim = static_cast<unsigned char>(way ^ 1);
+}
+
+template <typename K, typename V>
+void NearCache<K, V>::clear()
+{
+	for (Set& set : _sets) {
+		set.ways[0].used = false;
+		set.ways[1].used = false;
+	}
+}
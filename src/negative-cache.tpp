@@ -0,0 +1,175 @@
+/**
+ * @file negative-cache.tpp
+ * @class NegativeCache
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * NegativeCache implementation.
+ */
+
+#include "negative-cache.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace csc;
+
+template <typename K, typename Hash>
+NegativeCache<K, Hash>::NegativeCache(const NegativeCacheOptions& options) :
+	_reset_after(std::max<std::size_t>(options.expected_keys, 1)),
+	_adds(0)
+{
+	// Classic Bloom sizing, in counters rather than bits.
+	const double ln2 = std::log(2.0);
+	double p = std::min(std::max(options.false_positive_rate, 1e-9), 0.5);
+	double counters = -static_cast<double>(_reset_after) * std::log(p) /
+		(ln2 * ln2);
+	std::size_t want = static_cast<std::size_t>(
+		std::ceil(counters / BLOCK_COUNTERS));
+	std::size_t cap = std::max<std::size_t>(options.max_bytes / BLOCK_BYTES, 1);
+	_nblocks = std::min(std::max<std::size_t>(want, 1), cap);
+
+	double per_key = static_cast<double>(_nblocks * BLOCK_COUNTERS) /
+		static_cast<double>(_reset_after);
+	long k = std::lround(per_key * ln2);
+	_probes = static_cast<unsigned>(std::min<long>(std::max<long>(k, 1),
+		MAX_PROBES));
+
+	_blocks.reset(new Block[_nblocks]);
+	clear();
+}
+
+template <typename K, typename Hash>
+std::uint64_t NegativeCache<K, Hash>::mix(std::uint64_t h)
+{
+	// splitmix64 finalizer.
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ull;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebull;
+	h ^= h >> 31;
+	return h;
+}
+
+template <typename K, typename Hash>
+typename NegativeCache<K, Hash>::Block& NegativeCache<K, Hash>::locate(
+	const K& key, unsigned* slots) const
+{
+	std::uint64_t h = mix(static_cast<std::uint64_t>(_hash(key)));
+	// The high half picks the block without a division; the probes come
+	// from seven-bit slices of a second mix.
+	std::size_t block = static_cast<std::size_t>(
+		((h >> 32) * static_cast<std::uint64_t>(_nblocks)) >> 32);
+	std::uint64_t bits = mix(h);
+	for (unsigned i = 0; i < _probes; ++i) {
+		if (i == 9) {
+			bits = mix(bits);
+		}
+		slots[i] = static_cast<unsigned>(bits & (BLOCK_COUNTERS - 1));
+		bits >>= 7;
+	}
+	return _blocks[block];
+}
+
+template <typename K, typename Hash>
+std::uint64_t NegativeCache<K, Hash>::count(const Block& block, unsigned slot)
+{
+	std::uint64_t word = block.words[slot / 16].load(std::memory_order_relaxed);
+	return (word >> (4 * (slot % 16))) & MAX_COUNT;
+}
+
+template <typename K, typename Hash>
+void NegativeCache<K, Hash>::bump(Block& block, unsigned slot, int delta)
+{
+	std::atomic<std::uint64_t>& word = block.words[slot / 16];
+	unsigned shift = 4 * (slot % 16);
+	std::uint64_t old = word.load(std::memory_order_relaxed);
+	for (;;) {
+		std::uint64_t c = (old >> shift) & MAX_COUNT;
+		// A saturated counter has lost track of its count; leave it.
+		if (c == MAX_COUNT || (delta < 0 && c == 0)) {
+			return;
+		}
+		std::uint64_t next = delta > 0 ? old + (1ull << shift) :
+			old - (1ull << shift);
+		if (word.compare_exchange_weak(old, next,
+			std::memory_order_relaxed)) {
+			return;
+		}
+	}
+}
+
+template <typename K, typename Hash>
+bool NegativeCache<K, Hash>::absent(const K& key) const
+{
+	unsigned slots[MAX_PROBES];
+	const Block& block = locate(key, slots);
+	for (unsigned i = 0; i < _probes; ++i) {
+		if (count(block, slots[i]) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename K, typename Hash>
+void NegativeCache<K, Hash>::add(const K& key)
+{
+	if (_adds.fetch_add(1, std::memory_order_relaxed) + 1 >= _reset_after) {
+		clear();
+	}
+	unsigned slots[MAX_PROBES];
+	Block& block = locate(key, slots);
+	// Probes may repeat; count each counter once so forget() undoes add().
+	std::sort(slots, slots + _probes);
+	unsigned *end = std::unique(slots, slots + _probes);
+	for (unsigned *s = slots; s != end; ++s) {
+		bump(block, *s, 1);
+	}
+}
+
+template <typename K, typename Hash>
+void NegativeCache<K, Hash>::forget(const K& key)
+{
+	if (!absent(key)) {
+		return;
+	}
+	unsigned slots[MAX_PROBES];
+	Block& block = locate(key, slots);
+	std::sort(slots, slots + _probes);
+	unsigned *end = std::unique(slots, slots + _probes);
+	for (unsigned *s = slots; s != end; ++s) {
+		bump(block, *s, -1);
+	}
+	// A collision still reports the key; give up the block to be exact.
+	if (absent(key)) {
+		for (std::size_t w = 0; w < BLOCK_WORDS; ++w) {
+			block.words[w].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename K, typename Hash>
+void NegativeCache<K, Hash>::clear()
+{
+	for (std::size_t b = 0; b < _nblocks; ++b) {
+		for (std::size_t w = 0; w < BLOCK_WORDS; ++w) {
+			_blocks[b].words[w].store(0, std::memory_order_relaxed);
+		}
+	}
+	_adds.store(0, std::memory_order_relaxed);
+}
+
+template <typename K, typename Hash>
+std::size_t NegativeCache<K, Hash>::bytes() const
+{
+	return _nblocks * BLOCK_BYTES;
+}
+
+template <typename K, typename Hash>
+unsigned NegativeCache<K, Hash>::probes() const
+{
+	return _probes;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file removal-listener.tpp
+ * @class RemovalDispatcher
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * RemovalDispatcher implementation.
+ */
+
+#include "removal-listener.h"
+
+#include <chrono>
+
+using namespace csc;
+
+template <typename K, typename V>
+RemovalDispatcher<K, V>::RemovalDispatcher(const RemovalOptions& options) :
+	_options(options),
+	_queue(options.queue_capacity),
+	_queued(0),
+	_delivered(0),
+	_dropped(0),
+	_idle(false),
+	_listeners(std::make_shared<const std::vector<Listener>>()),
+	_stop(false),
+	_thread(&RemovalDispatcher::run, this)
+{
+	// do nothing
+}
+
+template <typename K, typename V>
+RemovalDispatcher<K, V>::~RemovalDispatcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	_thread.join();
+}
+
+template <typename K, typename V>
+void RemovalDispatcher<K, V>::add_listener(Listener listener)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	// Copy on write, so the dispatcher can deliver from a snapshot.
+	auto next = std::make_shared<std::vector<Listener>>(*_listeners);
+	next->push_back(std::move(listener));
+	_listeners = next;
+}
+
+template <typename K, typename V>
+bool RemovalDispatcher<K, V>::notify(const K& key, const V& value,
+	RemovalCause cause)
+{
+	if (!_queue.try_push(Removal<K, V>{key, value, cause})) {
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	_queued.fetch_add(1, std::memory_order_relaxed);
+	// Pairs with the fence in run(): either the dispatcher sees the element
+	// or this sees it idle.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_idle.load(std::memory_order_relaxed)) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_idle.store(false, std::memory_order_relaxed);
+		_cv.notify_one();
+	}
+	return true;
+}
+
+template <typename K, typename V>
+void RemovalDispatcher<K, V>::drain()
+{
+	std::uint64_t target = _queued.load();
+	std::unique_lock<std::mutex> lock(_mutex);
+	_drained.wait(lock, [this, target]() {
+		return _delivered.load() >= target;
+	});
+}
+
+template <typename K, typename V>
+std::uint64_t RemovalDispatcher<K, V>::dropped() const
+{
+	return _dropped.load(std::memory_order_relaxed);
+}
+
+template <typename K, typename V>
+std::uint64_t RemovalDispatcher<K, V>::delivered() const
+{
+	return _delivered.load(std::memory_order_relaxed);
+}
+
+template <typename K, typename V>
+void RemovalDispatcher<K, V>::run()
+{
+	std::vector<Removal<K, V>> batch;
+	batch.reserve(_options.batch_size);
+	for (;;) {
+		batch.clear();
+		std::size_t n = _queue.pop_batch(batch, _options.batch_size);
+		if (n > 0) {
+			std::shared_ptr<const std::vector<Listener>> listeners;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				listeners = _listeners;
+			}
+			for (const Removal<K, V>& r : batch) {
+				for (const Listener& listener : *listeners) {
+					try {
+						listener(r.key, r.value, r.cause);
+					} catch (...) {
+						// do nothing
+					}
+				}
+			}
+			_delivered.fetch_add(n);
+			std::lock_guard<std::mutex> lock(_mutex);
+			_drained.notify_all();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_stop) {
+			// Deliver anything queued before the stop.
+			if (_queue.empty()) {
+				return;
+			}
+			continue;
+		}
+		_idle.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (!_queue.empty()) {
+			_idle.store(false, std::memory_order_relaxed);
+			continue;
+		}
+		// The timeout is only a backstop; producers wake an idle thread.
+		_cv.wait_for(lock, std::chrono::milliseconds(100), [this]() {
+			return _stop || !_idle.load(std::memory_order_relaxed);
+		});
+		_idle.store(false, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,214 @@
+/**
+ * @file shards.tpp
+ * @class Shards
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Shards implementation.
+ */
+
+#include "shards.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace csc;
+
+template <typename K, typename Hash>
+Shards<K, Hash>::Shards(const MrcOptions& options) :
+	_options(options),
+	_now(0),
+	_beyond(0),
+	_cold(0)
+{
+	double rate = std::min(std::max(_options.sample_rate, 1.0 / MODULUS),
+		1.0);
+	_threshold.store(static_cast<std::uint64_t>(rate * MODULUS));
+	_options.max_keys = std::max<std::size_t>(_options.max_keys, 1);
+	_options.buckets = std::max<std::size_t>(_options.buckets, 1);
+	_width = std::max<std::size_t>(
+		(_options.max_cache_size + _options.buckets - 1) / _options.buckets,
+		1);
+	_histogram.assign(_options.buckets, 0.0);
+	// Times run up to 4x the tracked keys before a renumbering.
+	_tree.assign(4 * _options.max_keys + 1, 0);
+}
+
+template <typename K, typename Hash>
+std::uint64_t Shards<K, Hash>::mix(std::uint64_t h)
+{
+	// splitmix64 finalizer.
+	h ^= h >> 30;
+	h *= 0xbf58476d1ce4e5b9ull;
+	h ^= h >> 27;
+	h *= 0x94d049bb133111ebull;
+	h ^= h >> 31;
+	return h;
+}
+
+template <typename K, typename Hash>
+void Shards<K, Hash>::access(const K& key)
+{
+	std::uint64_t h = mix(static_cast<std::uint64_t>(_hash(key)));
+	std::uint32_t sample = static_cast<std::uint32_t>(h % MODULUS);
+	if (sample >= _threshold.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	// The threshold may have dropped while waiting.
+	if (sample >= _threshold.load(std::memory_order_relaxed)) {
+		return;
+	}
+	if (_now + 1 >= _tree.size()) {
+		compact();
+	}
+	std::uint32_t now = ++_now;
+	double rate = static_cast<double>(_threshold.load()) / MODULUS;
+
+	auto it = _last.find(h);
+	if (it == _last.end()) {
+		_cold += 1;
+		_last.emplace(h, now);
+		_by_sample.emplace_back(sample, h);
+		std::push_heap(_by_sample.begin(), _by_sample.end());
+	} else {
+		// Distinct tracked keys since the last access, scaled to the stream.
+		std::int64_t between = tree_sum(now - 1) - tree_sum(it->second);
+		double distance = static_cast<double>(between) / rate;
+		std::size_t bucket = static_cast<std::size_t>(distance /
+			static_cast<double>(_width));
+		if (bucket < _histogram.size()) {
+			_histogram[bucket] += 1;
+		} else {
+			_beyond += 1;
+		}
+		tree_add(it->second, -1);
+		it->second = now;
+	}
+	tree_add(now, 1);
+
+	while (_last.size() > _options.max_keys) {
+		shed();
+	}
+}
+
+template <typename K, typename Hash>
+void Shards<K, Hash>::shed()
+{
+	std::pop_heap(_by_sample.begin(), _by_sample.end());
+	std::pair<std::uint32_t, std::uint64_t> top = _by_sample.back();
+	_by_sample.pop_back();
+	auto it = _last.find(top.second);
+	if (it != _last.end()) {
+		tree_add(it->second, -1);
+		_last.erase(it);
+	}
+	// Counts so far were taken at the old rate; scale them to the new one.
+	double old_rate = static_cast<double>(_threshold.load());
+	_threshold.store(top.first);
+	double scale = static_cast<double>(top.first) / old_rate;
+	for (double& count : _histogram) {
+		count *= scale;
+	}
+	_beyond *= scale;
+	_cold *= scale;
+	// Keys sharing the dropped key's sample value are out too.
+	while (!_by_sample.empty() && _by_sample.front().first >= top.first) {
+		std::pop_heap(_by_sample.begin(), _by_sample.end());
+		it = _last.find(_by_sample.back().second);
+		if (it != _last.end()) {
+			tree_add(it->second, -1);
+			_last.erase(it);
+		}
+		_by_sample.pop_back();
+	}
+}
+
+template <typename K, typename Hash>
+void Shards<K, Hash>::compact()
+{
+	std::vector<std::pair<std::uint32_t, std::uint64_t>> order;
+	order.reserve(_last.size());
+	for (const auto& entry : _last) {
+		order.emplace_back(entry.second, entry.first);
+	}
+	std::sort(order.begin(), order.end());
+	std::fill(_tree.begin(), _tree.end(), 0);
+	_now = 0;
+	for (const auto& entry : order) {
+		_last[entry.second] = ++_now;
+		tree_add(_now, 1);
+	}
+}
+
+template <typename K, typename Hash>
+void Shards<K, Hash>::tree_add(std::size_t i, int delta)
+{
+	for (; i < _tree.size(); i += i & (~i + 1)) {
+		_tree[i] += delta;
+	}
+}
+
+template <typename K, typename Hash>
+std::int64_t Shards<K, Hash>::tree_sum(std::size_t i) const
+{
+	std::int64_t sum = 0;
+	for (; i > 0; i -= i & (~i + 1)) {
+		sum += _tree[i];
+	}
+	return sum;
+}
+
+template <typename K, typename Hash>
+double Shards<K, Hash>::miss_ratio_locked(std::size_t cache_size) const
+{
+	double total = _beyond + _cold;
+	double hits = 0;
+	// A distance d hits in a cache of size c if d < c; count whole buckets.
+	std::size_t full = std::min(cache_size / _width, _histogram.size());
+	for (std::size_t b = 0; b < _histogram.size(); ++b) {
+		total += _histogram[b];
+		if (b < full) {
+			hits += _histogram[b];
+		}
+	}
+	if (total <= 0) {
+		return 1.0;
+	}
+	return 1.0 - hits / total;
+}
+
+template <typename K, typename Hash>
+double Shards<K, Hash>::miss_ratio(std::size_t cache_size)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return miss_ratio_locked(cache_size);
+}
+
+template <typename K, typename Hash>
+std::vector<std::pair<std::size_t, double>> Shards<K, Hash>::curve()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<std::pair<std::size_t, double>> points;
+	points.reserve(_histogram.size() + 1);
+	for (std::size_t b = 0; b <= _histogram.size(); ++b) {
+		points.emplace_back(b * _width, miss_ratio_locked(b * _width));
+	}
+	return points;
+}
+
+template <typename K, typename Hash>
+double Shards<K, Hash>::rate() const
+{
+	return static_cast<double>(_threshold.load()) / MODULUS;
+}
+
+template <typename K, typename Hash>
+std::size_t Shards<K, Hash>::tracked()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _last.size();
+}
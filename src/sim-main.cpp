@@ -0,0 +1,184 @@
+/**
+ * @file sim-main.cpp
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Entry point of cache-sim: replays a key-access trace against each policy
+ * at each cache size, one configuration per core at a time, and reports
+ * hit ratio, byte hit ratio and replay throughput. "lru" is CacheManager
+ * itself; fifo and clock are the cheaper alternatives, and opt (Belady) is
+ * the bound none of them can beat. See cache-sim.h for the trace formats.
+ *
+ * Usage: cache-sim <trace> [--policies=lru,fifo,clock,opt]
+ *                  [--sizes=<n>,<n>,...] [--threads=<n>] [--json]
+ *        cache-sim --convert <text trace> <binary trace>
+ */
+
+#include "cache-sim.h"
+#include "thread-pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace csc;
+
+namespace {
+const std::vector<std::string> POLICIES = {"lru", "fifo", "clock", "opt"};
+
+std::unique_ptr<SimPolicy> policy(const std::string& name,
+	const OptPolicy::NextUses& next, std::size_t capacity)
+{
+	if (name == "lru") {
+		return std::make_unique<CachePolicy>(capacity);
+	} else if (name == "fifo") {
+		return std::make_unique<FifoPolicy>(capacity);
+	} else if (name == "clock") {
+		return std::make_unique<ClockPolicy>(capacity);
+	} else if (name == "opt") {
+		return std::make_unique<OptPolicy>(next, capacity);
+	}
+	throw std::invalid_argument("No policy " + name);
+}
+
+std::vector<std::string> split(const std::string& list)
+{
+	std::vector<std::string> items;
+	std::istringstream in(list);
+	std::string item;
+	while (std::getline(in, item, ',')) {
+		if (!item.empty()) {
+			items.push_back(item);
+		}
+	}
+	return items;
+}
+
+void report(std::ostream& out, const std::vector<SimResult>& results)
+{
+	out << std::left << std::setw(8) << "policy" << std::right <<
+		std::setw(12) << "size" << std::setw(12) << "hit ratio" <<
+		std::setw(12) << "byte hits" << std::setw(16) << "accesses/s" << '\n';
+	out << std::fixed;
+	for (const SimResult& result : results) {
+		out << std::left << std::setw(8) << result.policy << std::right <<
+			std::setw(12) << result.capacity << std::setprecision(4) <<
+			std::setw(12) << result.hit_ratio() << std::setw(12) <<
+			result.byte_hit_ratio() << std::setprecision(0) <<
+			std::setw(16) << result.accesses_per_sec() << '\n';
+	}
+}
+
+void json(std::ostream& out, const std::vector<SimResult>& results)
+{
+	out << std::setprecision(10) << "{\n  \"results\": [";
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const SimResult& result = results[i];
+		out << (i == 0 ? "\n" : ",\n") << "    {\"policy\": \"" <<
+			result.policy << "\", \"size\": " << result.capacity <<
+			", \"accesses\": " << result.accesses <<
+			", \"hit_ratio\": " << result.hit_ratio() <<
+			", \"byte_hit_ratio\": " << result.byte_hit_ratio() <<
+			", \"accesses_per_sec\": " << result.accesses_per_sec() << "}";
+	}
+	out << "\n  ]\n}\n";
+}
+
+int usage(const char *name)
+{
+	std::cerr << "Usage: " << name << " <trace> [--policies=lru,fifo,clock," <<
+		"opt] [--sizes=<n>,<n>,...] [--threads=<n>] [--json]\n" <<
+		"       " << name << " --convert <text trace> <binary trace>\n";
+	return 2;
+}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		return usage(argv[0]);
+	}
+	try {
+		if (std::string(argv[1]) == "--convert") {
+			if (argc != 4) {
+				return usage(argv[0]);
+			}
+			std::uint64_t count = AccessTrace::convert(argv[2], argv[3]);
+			std::cout << count << " accesses\n";
+			return 0;
+		}
+
+		std::vector<std::string> policies = POLICIES;
+		std::vector<std::size_t> sizes = {1000, 10000, 100000};
+		std::size_t threads = 0;
+		bool as_json = false;
+		for (int i = 2; i < argc; ++i) {
+			std::string arg = argv[i];
+			if (arg == "--json") {
+				as_json = true;
+			} else if (arg.rfind("--policies=", 0) == 0) {
+				policies = split(arg.substr(11));
+			} else if (arg.rfind("--sizes=", 0) == 0) {
+				sizes.clear();
+				for (const std::string& size : split(arg.substr(8))) {
+					sizes.push_back(std::strtoull(size.c_str(), nullptr, 10));
+				}
+			} else if (arg.rfind("--threads=", 0) == 0) {
+				threads = std::strtoull(arg.c_str() + 10, nullptr, 10);
+			} else {
+				return usage(argv[0]);
+			}
+		}
+
+		AccessTrace trace = AccessTrace::open(argv[1]);
+		std::vector<std::pair<std::string, std::size_t>> configs;
+		for (const std::string& name : policies) {
+			for (std::size_t size : sizes) {
+				configs.emplace_back(name, size);
+			}
+		}
+		// Fail on a bad policy name before any replay starts.
+		for (const std::string& name : policies) {
+			if (std::find(POLICIES.begin(), POLICIES.end(), name) ==
+				POLICIES.end()) {
+				throw std::invalid_argument("No policy " + name);
+			}
+		}
+		// Built once for every size opt is replayed at.
+		OptPolicy::NextUses next;
+		if (std::find(policies.begin(), policies.end(), "opt") !=
+			policies.end()) {
+			next = OptPolicy::next_uses(trace);
+		}
+		std::vector<SimResult> results(configs.size());
+		// Configurations share nothing but the read-only trace and next.
+		ThreadPool pool(threads);
+		pool.parallel_for(configs.size(), 1,
+			[&](std::size_t begin, std::size_t end) {
+				for (std::size_t i = begin; i < end; ++i) {
+					const auto& config = configs[i];
+					std::unique_ptr<SimPolicy> sim = policy(config.first, next,
+						config.second);
+					results[i] = simulate(trace, *sim, config.first,
+						config.second);
+				}
+			});
+		if (as_json) {
+			json(std::cout, results);
+		} else {
+			report(std::cout, results);
+		}
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+	return 0;
+}
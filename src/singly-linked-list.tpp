@@ -1,5 +1,5 @@
 /**
- * @file singly-linked-list.cpp
+ * @file singly-linked-list.tpp
  * @class SinglyLinkedList<T>
  *
  * @author Tyler Baxter
@@ -11,10 +11,12 @@
 
 #include "singly-linked-list.h"
 
-#include <exception>
+#include <stdexcept>
+#include <utility>
 
 using namespace csc;
 
+template <typename T>
 SLLIterator<T>& SLLIterator<T>::operator++()
 {
 	if (_node) {
@@ -23,14 +25,16 @@ SLLIterator<T>& SLLIterator<T>::operator++()
 	return *this;
 }
 
-SLLIterator<T> SLLIterator::operator++(int)
+template <typename T>
+SLLIterator<T> SLLIterator<T>::operator++(int)
 {
 	SLLIterator tmp = *this;
 	++(*this);
 	return tmp;
 }
 
-T& operator*() const
+template <typename T>
+T& SLLIterator<T>::operator*() const
 {
 	if (!_node) {
 		throw std::out_of_range("Attempt to dereference nullptr iterator");
@@ -38,175 +42,177 @@ T& operator*() const
 	return _node->get_element();
 }
 
-void SLLIterator::add(const T& element)
+template <typename T>
+SinglyLinkedList<T>::SinglyLinkedList(const SinglyLinkedList<T>& other) :
+	_head(nullptr), _size(0)
 {
-	_node->set_next(new SLLNode<T>(element, _node->get_next()));
+	*this = other;
 }
 
-void SLLIterator::delete()
+template <typename T>
+SinglyLinkedList<T>::SinglyLinkedList(SinglyLinkedList<T>&& other) noexcept :
+	_head(other._head), _size(other._size)
 {
-	// xxx don't think this syntax is going to work. likely going to need to (1)
-	// create a copy of the list and get one before our position, or (2) pass a
-	// reference to the list as the parameter. (2) is not a solution, that gives
-	// the client a ton of bookkeeping. Hopefully other solutions? We need our
-	// binded list instance
-	SLLNode<T> *node = SinglyLinkedList::search(element);
-	node->set_next() = _node->get_next();
-	delete _node;
-	_node = node->get_next();
-	node = nullptr;
+	other._head = nullptr;
+	other._size = 0;
 }
 
+template <typename T>
+SinglyLinkedList<T>& SinglyLinkedList<T>::operator=(
+	const SinglyLinkedList<T>& rhs)
+{
+	if (this == &rhs) {
+		return *this;
+	}
+	clear();
+	// Append in order, keeping a pointer to the tail.
+	SLLNode<T> *tail = nullptr;
+	for (const SLLNode<T> *curr = rhs._head; curr != nullptr; 
+		curr = curr->get_next()) {
+		SLLNode<T> *node = new SLLNode<T>(curr->get_element());
+		if (tail == nullptr) {
+			_head = node;
+		} else {
+			tail->set_next(node);
+		}
+		tail = node;
+		++_size;
+	}
+	return *this;
+}
+
+template <typename T>
+SinglyLinkedList<T>& SinglyLinkedList<T>::operator=(
+	SinglyLinkedList<T>&& rhs) noexcept
+{
+	if (this != &rhs) {
+		clear();
+		std::swap(_head, rhs._head);
+		std::swap(_size, rhs._size);
+	}
+	return *this;
+}
+
+template <typename T>
 T* SinglyLinkedList<T>::front() const
 {
 	if (empty()) {
 		return nullptr;
 	}
-	return _head->get_element();
+	return &_head->get_element();
 }
 
+template <typename T>
 void SinglyLinkedList<T>::insert(const T& element)
 {
-	if (empty()) {
-		_head = new SLLNode<T>(element);
-		++_size;
-	}
 	_head = new SLLNode<T>(element, _head);
 	++_size;
 }
 
+template <typename T>
 bool SinglyLinkedList<T>::remove(const T& element)
 {
-	SLLNode<T> *curr = search();
-	if (curr == nullptr) {
+	bool found = false;
+	SLLNode<T> *prev = search(element, found);
+	if (!found) {
 		return false;
 	}
-	curr->set_next() = curr->get_next()->get_next();
-	delete curr->get_next();
+	if (prev == nullptr) {
+		return pop_front();
+	}
+	SLLNode<T> *curr = prev->get_next();
+	prev->set_next(curr->get_next());
+	delete curr;
 	curr = nullptr;
 	--_size;
 	return true;
 }
 
-SLLNode<T>* SinglyLinkedList<T>::search(const T& element)
+template <typename T>
+SLLNode<T>* SinglyLinkedList<T>::search(const T& element, bool& found) const
 {
-	// List is empty, return nullptr.
+	found = false;
+	// List is empty.
 	if (empty()) {
 		return nullptr;
 	}
-	// Search element is head, return a pointer to head.
+	// Search element is head; there is no node before it.
 	if (_head->get_element() == element) {
-		return _head;
-	}
-	// Already checked head.
-	SLLNode<T> *curr = _head->get_next();
-	if (curr == nullptr) {
+		found = true;
 		return nullptr;
 	}
 	// General case:
-	SLLNode<T> *curr_next = _curr->get_next();
+	SLLNode<T> *curr = _head;
+	SLLNode<T> *curr_next = _head->get_next();
 	while (curr_next != nullptr) {
 		if (curr_next->get_element() == element) {
+			found = true;
 			return curr;
 		}
-		curr = curr->get_next();
+		curr = curr_next;
 		curr_next = curr_next->get_next();
 	}
 	return nullptr;
 }
 
-bool SinglyLinkedList<T>::contains(const T& element)
+template <typename T>
+bool SinglyLinkedList<T>::contains(const T& element) const
 {
-	return search() != nullptr;
+	return find(element) != nullptr;
 }
 
-T* SinglyLinkedList<T>::find(const T& element)
+template <typename T>
+T* SinglyLinkedList<T>::find(const T& element) const
 {
-	return search()->get_next();
+	bool found = false;
+	SLLNode<T> *prev = search(element, found);
+	if (!found) {
+		return nullptr;
+	}
+	return prev == nullptr ? &_head->get_element() :
+		&prev->get_next()->get_element();
 }
 
-T* SinglyLinkedList<T>::pop_front()
+template <typename T>
+bool SinglyLinkedList<T>::pop_front()
 {
 	// Guard if the list is empty.
 	if (empty()) {
-		return nullptr;
-	}
-	// Guard if the list only has one element.
-	if (_head->get_next() == nullptr) {
-		delete _head;
-		_head = nullptr;
-		return _head;
+		return false;
 	}
-	// General case:
 	SLLNode<T> *curr = _head;
 	_head = _head->get_next();
-	T *ptr = curr->get_element();
 	delete curr;
 	curr = nullptr;
 	--_size;
-	return ptr;
+	return true;
 }
 
+template <typename T>
 SLLIterator<T> SinglyLinkedList<T>::begin() const
 {
 	return SLLIterator<T>(_head);
 }
 
+template <typename T>
 SLLIterator<T> SinglyLinkedList<T>::end() const
 {
 	return SLLIterator<T>(nullptr);
 }
 
-// xxx
-ostream& SinglyLinkedList<T>::operator<<(ostream& out, 
-	const SinglyLinkedList<T>& sll) const
-{
-	if (_head == nullptr) {
-		std::cout << "Empty list\n";
-	} else if (_head->get_next() == nullptr) {
-	// Guard loop if there's only one element.
-		std::cout << _head->get_element() << "\n";
-	} else {
-		SLLNode<T>* curr = _head;
-		while (curr->get_next() != nullptr) {
-			std::cout << curr->get_element() << ", ";
-			curr = curr->get_next();
-		}
-		std::cout << curr->get_element() << "\n";
-		curr = nullptr;
-	}
-}
-
-// xxx
-istream& SinglyLinkedList<T>::operator>>(istream& in, 
-	const SinglyLinkedList<T>& sll) const
-{
-	if (_head == nullptr) {
-		std::cout << "Empty list\n";
-	} else if (_head->get_next() == nullptr) {
-	// Guard loop if there's only one element.
-		std::cout << _head->get_element() << "\n";
-	} else {
-		SLLNode<T>* curr = _head;
-		while (curr->get_next() != nullptr) {
-			std::cout << curr->get_element() << ", ";
-			curr = curr->get_next();
-		}
-		std::cout << curr->get_element() << "\n";
-		curr = nullptr;
-	}
-}
-
+template <typename T>
 std::size_t SinglyLinkedList<T>::size() const
 {
 	return _size;
 }
 
+template <typename T>
 bool SinglyLinkedList<T>::empty() const
 {
 	return _head == nullptr && _size == 0;
 }
 
+template <typename T>
 void SinglyLinkedList<T>::clear()
 {
 	while (!empty()) {
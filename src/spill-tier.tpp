@@ -0,0 +1,493 @@
+/**
+ * @file spill-tier.tpp
+ * @class SpillTier
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * SpillTier implementation.
+ */
+
+#include "spill-tier.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace csc;
+
+template <typename K, typename V>
+SpillTier<K, V>::Segment::~Segment()
+{
+	::close(fd);
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::FreeDeleter::operator()(char* p) const
+{
+	std::free(p);
+}
+
+template <typename K, typename V>
+SpillTier<K, V>::SpillTier(const SpillOptions& options) :
+	_options(options),
+	_buffered(0),
+	_next_id(0),
+	_disk_bytes(0),
+	_reading(0),
+	_closed(false),
+	_io(options.io_threads)
+{
+	// A private directory, so tiers sharing options.directory never open
+	// each other's segments.
+	std::string pattern = _options.directory + "/spill-XXXXXX";
+	if (::mkdtemp(&pattern[0]) == nullptr) {
+		throw std::system_error(errno, std::generic_category(),
+			"mkdtemp " + pattern);
+	}
+	_directory = pattern;
+	// Round the batch up to whole blocks so every flush is aligned.
+	_options.buffer_bytes = std::max<std::size_t>(
+		(_options.buffer_bytes + BLOCK - 1) / BLOCK * BLOCK, BLOCK);
+	void *buffer = nullptr;
+	if (::posix_memalign(&buffer, BLOCK, _options.buffer_bytes) != 0) {
+		throw std::bad_alloc();
+	}
+	_buffer.reset(static_cast<char*>(buffer));
+	std::lock_guard<std::mutex> lock(_mutex);
+	try {
+		roll();
+	} catch (...) {
+		::rmdir(_directory.c_str());
+		throw;
+	}
+}
+
+template <typename K, typename V>
+SpillTier<K, V>::~SpillTier()
+{
+	close();
+	std::lock_guard<std::mutex> lock(_mutex);
+	_index.clear();
+	_active.reset();
+	for (auto& entry : _segments) {
+		::unlink(entry.second->path.c_str());
+	}
+	_segments.clear();
+	::rmdir(_directory.c_str());
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::close()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_closed = true;
+	_drained.wait(lock, [this]() { return _reading == 0; });
+}
+
+template <typename K, typename V>
+std::string SpillTier<K, V>::encode(const K& key, const V& value)
+{
+	std::ostringstream out;
+	{
+		BinaryWriter writer(out, 256);
+		Codec<K>::write(writer, key);
+		Codec<V>::write(writer, value);
+	}
+	return out.str();
+}
+
+template <typename K, typename V>
+bool SpillTier<K, V>::decode(const std::string& record, const K& key,
+	V& value)
+{
+	std::istringstream in(record);
+	BinaryReader reader(in, 256);
+	// The key is stored to catch a record that was moved under a reader.
+	if (!(Codec<K>::read(reader) == key)) {
+		return false;
+	}
+	value = Codec<V>::read(reader);
+	return true;
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::put(const K& key, const V& value)
+{
+	std::string record = encode(key, value);
+	if (record.size() > std::numeric_limits<std::uint32_t>::max()) {
+		throw std::length_error("Record too large to spill");
+	}
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _index.find(key);
+	if (it != _index.end()) {
+		unindex(it);
+	}
+	append(key, record);
+	// Stay within the disk budget by dropping whole segments, oldest first.
+	while (_disk_bytes > _options.max_bytes && _segments.size() > 1) {
+		drop(_segments.begin()->first);
+	}
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::append(const K& key, const std::string& record)
+{
+	std::uint64_t end = _active->written + _buffered;
+	if (end > 0 && end + record.size() > _options.segment_bytes) {
+		roll();
+	}
+
+	Location loc;
+	loc.segment = _active;
+	loc.length = static_cast<std::uint32_t>(record.size());
+	if (record.size() > _options.buffer_bytes) {
+		// Too big to batch: write it alone, still block-aligned.
+		flush_buffer();
+		std::size_t padded = (record.size() + BLOCK - 1) / BLOCK * BLOCK;
+		void *block = nullptr;
+		if (::posix_memalign(&block, BLOCK, padded) != 0) {
+			throw std::bad_alloc();
+		}
+		std::unique_ptr<char, FreeDeleter> owner(static_cast<char*>(block));
+		std::memcpy(owner.get(), record.data(), record.size());
+		std::memset(owner.get() + record.size(), 0, padded - record.size());
+		loc.offset = _active->written;
+		pwrite_all(_active->fd, owner.get(), padded, _active->written);
+		_active->written += padded;
+		_disk_bytes += padded;
+	} else {
+		if (_buffered + record.size() > _options.buffer_bytes) {
+			flush_buffer();
+		}
+		loc.offset = _active->written + _buffered;
+		std::memcpy(_buffer.get() + _buffered, record.data(), record.size());
+		_buffered += record.size();
+		_disk_bytes += record.size();
+	}
+	_active->live += record.size();
+	_active->keys.push_back(key);
+	_index[key] = loc;
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::unindex(
+	typename std::unordered_map<K, Location>::iterator it)
+{
+	it->second.segment->live -= it->second.length;
+	_index.erase(it);
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::flush_buffer()
+{
+	if (_buffered == 0) {
+		return;
+	}
+	std::size_t padded = (_buffered + BLOCK - 1) / BLOCK * BLOCK;
+	std::memset(_buffer.get() + _buffered, 0, padded - _buffered);
+	pwrite_all(_active->fd, _buffer.get(), padded, _active->written);
+	_active->written += padded;
+	_disk_bytes += padded - _buffered;
+	_buffered = 0;
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::roll()
+{
+	if (_active) {
+		flush_buffer();
+	}
+	auto segment = std::make_shared<Segment>();
+	segment->id = _next_id++;
+	segment->path = _directory + "/segment-" +
+		std::to_string(segment->id) + ".log";
+	segment->fd = ::open(segment->path.c_str(),
+		O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+	if (segment->fd < 0) {
+		throw std::system_error(errno, std::generic_category(),
+			"open " + segment->path);
+	}
+	segment->written = 0;
+	segment->live = 0;
+	_segments[segment->id] = segment;
+	_active = segment;
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::drop(std::uint64_t id)
+{
+	auto found = _segments.find(id);
+	if (found == _segments.end()) {
+		return;
+	}
+	std::shared_ptr<Segment> segment = found->second;
+	if (segment == _active) {
+		roll();
+	}
+	for (const K& key : segment->keys) {
+		auto it = _index.find(key);
+		if (it != _index.end() && it->second.segment == segment) {
+			unindex(it);
+		}
+	}
+	_disk_bytes -= segment->written;
+	::unlink(segment->path.c_str());
+	_segments.erase(found);
+}
+
+template <typename K, typename V>
+bool SpillTier<K, V>::read(const Location& loc,
+	std::unique_lock<std::mutex>& lock, std::string& record)
+{
+	record.resize(loc.length);
+	if (loc.segment == _active && loc.offset >= _active->written) {
+		// Still in the write buffer.
+		std::memcpy(&record[0], _buffer.get() +
+			(loc.offset - _active->written), loc.length);
+		return true;
+	}
+	// The Location copy keeps the segment open across the unlocked read.
+	Location held = loc;
+	lock.unlock();
+	pread_all(held.segment->fd, &record[0], held.length, held.offset);
+	return true;
+}
+
+template <typename K, typename V>
+bool SpillTier<K, V>::get(const K& key, V& value)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _index.find(key);
+	if (it == _index.end()) {
+		return false;
+	}
+	std::string record;
+	read(it->second, lock, record);
+	return decode(record, key, value);
+}
+
+template <typename K, typename V>
+bool SpillTier<K, V>::take(const K& key, V& value)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _index.find(key);
+	if (it == _index.end()) {
+		return false;
+	}
+	Location loc = it->second;
+	std::string record;
+	read(loc, lock, record);
+	if (!decode(record, key, value)) {
+		return false;
+	}
+	if (!lock.owns_lock()) {
+		lock.lock();
+	}
+	// Only erase the record that was read; a newer put wins.
+	it = _index.find(key);
+	if (it != _index.end() && it->second.segment == loc.segment &&
+		it->second.offset == loc.offset) {
+		unindex(it);
+	}
+	return true;
+}
+
+template <typename K, typename V>
+std::future<std::optional<V>> SpillTier<K, V>::get_async(const K& key)
+{
+	return get_async(key, [](std::optional<V>&) {});
+}
+
+template <typename K, typename V>
+template <typename Then>
+std::future<std::optional<V>> SpillTier<K, V>::get_async(const K& key,
+	Then then)
+{
+	auto promise = std::make_shared<std::promise<std::optional<V>>>();
+	std::future<std::optional<V>> future = promise->get_future();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_closed) {
+			promise->set_value(std::nullopt);
+			return future;
+		}
+		++_reading;
+	}
+	_io.submit([this, key, then, promise]() mutable {
+		bool closed;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			closed = _closed;
+		}
+		try {
+			std::optional<V> result;
+			V value;
+			if (!closed && get(key, value)) {
+				result = value;
+			}
+			if (!closed) {
+				then(result);
+			}
+			promise->set_value(result);
+		} catch (...) {
+			promise->set_exception(std::current_exception());
+		}
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_reading == 0) {
+			_drained.notify_all();
+		}
+	});
+	return future;
+}
+
+template <typename K, typename V>
+bool SpillTier<K, V>::erase(const K& key)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _index.find(key);
+	if (it == _index.end()) {
+		return false;
+	}
+	unindex(it);
+	return true;
+}
+
+template <typename K, typename V>
+template <typename Pred>
+std::size_t SpillTier<K, V>::erase_if(Pred pred)
+{
+	std::vector<std::pair<K, Location>> entries;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		entries.assign(_index.begin(), _index.end());
+	}
+	std::size_t erased = 0;
+	for (const auto& entry : entries) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		std::string record;
+		read(entry.second, lock, record);
+		V value;
+		if (!decode(record, entry.first, value) ||
+			!pred(entry.first, value)) {
+			continue;
+		}
+		if (!lock.owns_lock()) {
+			lock.lock();
+		}
+		// Only erase the record that was matched; a newer put wins.
+		auto it = _index.find(entry.first);
+		if (it != _index.end() && it->second.segment == entry.second.segment &&
+			it->second.offset == entry.second.offset) {
+			unindex(it);
+			++erased;
+		}
+	}
+	return erased;
+}
+
+template <typename K, typename V>
+bool SpillTier<K, V>::contains(const K& key)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _index.find(key) != _index.end();
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::flush()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	flush_buffer();
+}
+
+template <typename K, typename V>
+std::size_t SpillTier<K, V>::reclaim()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	std::vector<std::uint64_t> victims;
+	for (const auto& entry : _segments) {
+		const Segment& s = *entry.second;
+		if (entry.second != _active && s.written > 0 &&
+			s.live < _options.reclaim_below * s.written) {
+			victims.push_back(entry.first);
+		}
+	}
+	for (std::uint64_t id : victims) {
+		std::shared_ptr<Segment> segment = _segments[id];
+		// Move each live record to the head of the log.
+		for (const K& key : segment->keys) {
+			auto it = _index.find(key);
+			if (it == _index.end() || it->second.segment != segment) {
+				continue;
+			}
+			std::string record(it->second.length, '\0');
+			pread_all(segment->fd, &record[0], record.size(),
+				it->second.offset);
+			unindex(it);
+			append(key, record);
+		}
+		drop(id);
+	}
+	return victims.size();
+}
+
+template <typename K, typename V>
+std::size_t SpillTier<K, V>::size()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _index.size();
+}
+
+template <typename K, typename V>
+std::uint64_t SpillTier<K, V>::disk_bytes()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _disk_bytes;
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::pread_all(int fd, char* data, std::size_t n,
+	std::uint64_t offset)
+{
+	while (n > 0) {
+		ssize_t got = ::pread(fd, data, n, static_cast<off_t>(offset));
+		if (got < 0 && errno == EINTR) {
+			continue;
+		}
+		if (got <= 0) {
+			throw std::system_error(got < 0 ? errno : EIO,
+				std::generic_category(), "pread");
+		}
+		data += got;
+		n -= static_cast<std::size_t>(got);
+		offset += static_cast<std::uint64_t>(got);
+	}
+}
+
+template <typename K, typename V>
+void SpillTier<K, V>::pwrite_all(int fd, const char* data, std::size_t n,
+	std::uint64_t offset)
+{
+	while (n > 0) {
+		ssize_t put = ::pwrite(fd, data, n, static_cast<off_t>(offset));
+		if (put < 0 && errno == EINTR) {
+			continue;
+		}
+		if (put < 0) {
+			throw std::system_error(errno, std::generic_category(), "pwrite");
+		}
+		data += put;
+		n -= static_cast<std::size_t>(put);
+		offset += static_cast<std::uint64_t>(put);
+	}
+}
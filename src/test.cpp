@@ -10,11 +10,52 @@
 
 #include "test.h"
 #include "linked-list.h"
+#include "hash-map.h"
+#include "cache-manager.h"
+#include "thread-pool.h"
+#include "binary-io.h"
+#include "mapped-cache.h"
+#include "spill-tier.h"
+#include "write-back.h"
+#include "negative-cache.h"
+#include "hot-keys.h"
+#include "near-cache.h"
+#include "removal-listener.h"
+#include "maintenance.h"
+#include "memory-pressure.h"
+#include "shards.h"
+#include "cache-stats.h"
+#include "trace.h"
+#include "util.h"
+#include "cache-sim.h"
+#include "alloc-counter.h"
+#include "bplus-tree.h"
 
 #include <iostream>
 #include <memory>
 #include <cassert>
 #include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <map>
+#include <new>
+#include <iterator>
+#include <csignal>
+#include <chrono>
+#include <thread>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
 
 using namespace csc;
 
@@ -27,7 +68,7 @@ using namespace csc;
 void test::node()
 {
     // Test Node creation
-    Node<int> node1(10);
+    DLLNode<int> node1(10);
     assert(node1.get_element() == 10);
     assert(node1.get_next() == nullptr);
     assert(node1.get_prev() == nullptr);
@@ -37,7 +78,7 @@ void test::node()
     assert(node1.get_element() == 20);
 
     // Test setting and getting next and previous nodes
-    Node<int> node2(30);
+    DLLNode<int> node2(30);
     node1.set_next(&node2);
     node2.set_prev(&node1);
     assert(node1.get_next() == &node2);
@@ -97,6 +138,20 @@ void test::linked_list()
     assert(list->get(1) == 2);
 	std::cout << "remove() passed.\n";
 
+    // Test move_to_front and erase, by node
+	const DLLNode<int>* zero = list->push_front(0);
+	const DLLNode<int>* one = list->find(1);
+	list->move_to_front(list->find(2));
+	assert(list->get(0) == 2 && list->get(1) == 0 && list->back() == 1);
+	list->move_to_front(one);
+	assert(list->front() == 1 && list->back() == 0);
+	list->erase(zero);
+	assert(list->size() == 2 && list->back() == 2);
+	list->erase(one);
+	assert(list->size() == 1 && list->front() == 2 && list->back() == 2);
+	list->push_front(1);
+	std::cout << "move_to_front(), erase() passed.\n";
+
     // Test pop_front
     list->pop_front();
     assert(list->size() == 1);
@@ -173,13 +228,13 @@ void test::linked_list()
     assert(listMoved->contains(8) == false);
 	std::cout << "contains() passed.\n";
 
-    const Node<int>* beginNode = listMoved->begin();
+    const DLLNode<int>* beginNode = listMoved->begin();
     assert(beginNode != nullptr); // Check if beginNode is not null
     assert(beginNode->get_element() == 6);
 	beginNode = nullptr;
 	std::cout << "begin() passed.\n";
     
-    const Node<int>* endNode = listMoved->end();
+    const DLLNode<int>* endNode = listMoved->end();
     assert(endNode != nullptr); // Check if endNode is not null
     assert(endNode->get_element() == 7);
 	endNode = nullptr;
@@ -292,4 +347,1959 @@ void test::hash_map()
 //    assert(map3.empty() == true);
 //
 //    std::cout << "All tests passed!" << std::endl;
+
+	// Dump and load round trip.
+	HashMap<int, std::string> table;
+	for (int i = 0; i < 1000; ++i) {
+		table.insert(i, std::to_string(i));
+	}
+	std::stringstream stream;
+	table.dump(stream);
+	std::string bytes = stream.str();
+	HashMap<int, std::string> loaded;
+	loaded.insert(-1, "gone");
+	loaded.load(stream);
+	assert(loaded.size() == 1000);
+	assert(!loaded.contains(-1));
+	for (int i = 0; i < 1000; ++i) {
+		assert(*loaded.get(i) == std::to_string(i));
+	}
+	std::cout << "Dump and load passed.\n";
+
+	// Dumps read back to back, and what follows them, are not lost to the
+	// reader's read-ahead.
+	std::stringstream chain;
+	chain << table << loaded << "tail";
+	HashMap<int, std::string> first;
+	HashMap<int, std::string> second;
+	assert(chain >> first && chain >> second);
+	assert(first.size() == 1000 && second.size() == 1000);
+	std::string tail;
+	assert(chain >> tail && tail == "tail");
+	std::cout << "Back to back dumps passed.\n";
+
+	// A corrupt count neither overflows reserve() nor allocates for it; the
+	// stream runs out first.
+	std::string corrupt = bytes;
+	std::uint64_t count = (std::uint64_t(1) << 63) + 1;
+	// The count follows the magic, version and kind.
+	corrupt.replace(8, sizeof(count), 
+		reinterpret_cast<const char *>(&count), sizeof(count));
+	std::stringstream huge(corrupt);
+	try {
+		loaded.load(huge);
+		assert(false);
+	} catch (const std::runtime_error& e) {
+		std::cout << "Corrupt count passed. " << e.what() << "\n";
+	}
+
+	// A dump of something else is rejected.
+	std::stringstream other;
+	{
+		BinaryWriter writer(other);
+		write_dump_header(writer, DumpKind::CACHE_MANAGER, 0);
+		write_dump_trailer(writer, 0);
+		writer.flush();
+	}
+	try {
+		loaded.load(other);
+		assert(false);
+	} catch (const std::runtime_error& e) {
+		std::cout << "Wrong dump kind passed. " << e.what() << "\n";
+	}
+}
+
+/**
+* Unit tests for ThreadPool.
+*/
+void test::thread_pool()
+{
+	ThreadPool pool(4);
+	assert(pool.size() == 4);
+
+	// Every index is visited exactly once, in ranges no larger than grain.
+	std::vector<int> hits(10007, 0);
+	pool.parallel_for(hits.size(), 64, [&hits](std::size_t begin, 
+		std::size_t end) {
+		assert(end - begin <= 64);
+		for (std::size_t i = begin; i < end; ++i) {
+			++hits[i];
+		}
+	});
+	for (int h : hits) {
+		assert(h == 1);
+	}
+	std::cout << "parallel_for() passed.\n";
+
+	// Nothing to do.
+	pool.parallel_for(0, 64, [](std::size_t, std::size_t) { assert(false); });
+	std::cout << "parallel_for() on empty range passed.\n";
+
+	// Exceptions reach the caller.
+	try {
+		pool.parallel_for(100, 1, [](std::size_t begin, std::size_t) {
+			if (begin == 42) {
+				throw std::runtime_error("range 42");
+			}
+		});
+		assert(false);
+	} catch (const std::runtime_error& e) {
+		std::cout << "parallel_for() exception passed. " << e.what() << "\n";
+	}
+
+	// Tasks submitted directly all run before the pool is destroyed.
+	std::atomic<int> count(0);
+	{
+		ThreadPool scoped(2);
+		for (int i = 0; i < 100; ++i) {
+			scoped.submit([&count]() { ++count; });
+		}
+	}
+	assert(count == 100);
+	std::cout << "submit() passed.\n";
+}
+
+/**
+* Unit tests for BinaryWriter, BinaryReader and the dump format.
+*/
+void test::binary_io()
+{
+	// Round trip a header, mixed entries and a trailer through a small
+	// buffer, so every path through write() and read() is taken.
+	std::stringstream stream;
+	std::string big(300, 'x');
+	{
+		BinaryWriter writer(stream, 64);
+		write_dump_header(writer, DumpKind::CACHE_MANAGER, 3);
+		for (int i = 0; i < 3; ++i) {
+			Codec<std::int64_t>::write(writer, i * 1000);
+			Codec<std::string>::write(writer, i == 1 ? big : "v");
+		}
+		write_dump_trailer(writer, 3);
+		writer.flush();
+	}
+	{
+		BinaryReader reader(stream, 64);
+		DumpHeader header = read_dump_header(reader);
+		assert(header.kind == DumpKind::CACHE_MANAGER);
+		assert(header.count == 3);
+		for (int i = 0; i < 3; ++i) {
+			assert(Codec<std::int64_t>::read(reader) == i * 1000);
+			assert(Codec<std::string>::read(reader) == (i == 1 ? big : "v"));
+		}
+		read_dump_trailer(reader, 3);
+	}
+	std::cout << "Dump round trip passed.\n";
+
+	// A truncated dump is rejected.
+	std::string bytes = stream.str();
+	std::stringstream truncated(bytes.substr(0, bytes.size() - 4));
+	try {
+		BinaryReader reader(truncated);
+		DumpHeader header = read_dump_header(reader);
+		for (std::uint64_t i = 0; i < header.count; ++i) {
+			Codec<std::int64_t>::read(reader);
+			Codec<std::string>::read(reader);
+		}
+		read_dump_trailer(reader, header.count);
+		assert(false);
+	} catch (const std::runtime_error& e) {
+		std::cout << "Truncated dump passed. " << e.what() << "\n";
+	}
+
+	// So is something that isn't a dump.
+	std::stringstream garbage("not a dump at all");
+	try {
+		BinaryReader reader(garbage);
+		read_dump_header(reader);
+		assert(false);
+	} catch (const std::runtime_error& e) {
+		std::cout << "Bad magic passed. " << e.what() << "\n";
+	}
+
+	// A corrupt string length runs out of stream before it is allocated.
+	std::stringstream lying;
+	{
+		BinaryWriter writer(lying);
+		writer.put(std::numeric_limits<std::uint32_t>::max());
+		writer.write("short", 5);
+		writer.flush();
+	}
+	try {
+		BinaryReader reader(lying);
+		Codec<std::string>::read(reader);
+		assert(false);
+	} catch (const std::runtime_error& e) {
+		std::cout << "Corrupt string length passed. " << e.what() << "\n";
+	}
+}
+
+/**
+* Unit tests for MappedCache.
+*/
+void test::mapped_cache()
+{
+	const std::string path = "/tmp/cache-manager-test.map";
+	std::remove(path.c_str());
+
+	// Fill a cold cache past capacity; key 0 is evicted.
+	{
+		MappedCache<std::int64_t, std::int64_t> cache(path, 4);
+		assert(!cache.restored());
+		assert(cache.size() == 0);
+		for (std::int64_t i = 0; i < 5; ++i) {
+			cache.put(i, i * 10);
+		}
+		assert(cache.size() == 4);
+		assert(!cache.contains(0));
+		// Touch 1 so that 2 is now the least recently used.
+		std::int64_t v = 0;
+		assert(cache.get(1, v) && v == 10);
+		assert(cache.remove(4));
+		assert(!cache.remove(4));
+		cache.put(3, 33);
+	}
+	std::cout << "MappedCache put(), get(), remove() passed.\n";
+
+	// Reopen: the entries and their LRU order survive the restart.
+	{
+		MappedCache<std::int64_t, std::int64_t> cache(path, 4);
+		assert(cache.restored());
+		assert(cache.size() == 3);
+		std::int64_t v = 0;
+		assert(cache.get(3, v) && v == 33);
+		cache.put(5, 50);
+		cache.put(6, 60);
+		// 2 was least recently used, then 1.
+		assert(!cache.contains(2));
+		assert(cache.contains(1));
+		assert(cache.size() == 4);
+
+		// A copy taken while the cache is open looks like a crash and must
+		// not be trusted.
+		std::ifstream src(path, std::ios::binary);
+		std::ofstream dst(path + ".crash", std::ios::binary);
+		dst << src.rdbuf();
+	}
+	std::cout << "MappedCache warm restart passed.\n";
+
+	{
+		MappedCache<std::int64_t, std::int64_t> cache(path + ".crash", 4);
+		assert(!cache.restored());
+		assert(cache.size() == 0);
+	}
+	std::cout << "MappedCache dirty file passed.\n";
+
+	// A clean file whose links point past the slots it handed out is not
+	// trusted, even with a matching checksum. The header keeps head at byte
+	// 56 and the checksum of the 80 bytes before it at byte 80.
+	{
+		std::ifstream src(path, std::ios::binary);
+		std::string bytes((std::istreambuf_iterator<char>(src)),
+			std::istreambuf_iterator<char>());
+		std::uint32_t head = 1000;
+		std::memcpy(&bytes[56], &head, sizeof(head));
+		std::uint64_t checksum = 0xcbf29ce484222325;
+		for (std::size_t i = 0; i < 80; ++i) {
+			checksum = (checksum ^ static_cast<unsigned char>(bytes[i])) *
+				0x100000001b3;
+		}
+		std::memcpy(&bytes[80], &checksum, sizeof(checksum));
+		std::ofstream dst(path + ".links", std::ios::binary);
+		dst << bytes;
+	}
+	{
+		MappedCache<std::int64_t, std::int64_t> cache(path + ".links", 4);
+		assert(!cache.restored());
+		assert(cache.size() == 0);
+	}
+	std::cout << "MappedCache bad links passed.\n";
+
+	// A different capacity is a different layout; start cold, with none of
+	// the old links left in the buckets, whether the file grows or shrinks.
+	for (std::size_t capacity : {8, 2}) {
+		MappedCache<std::int64_t, std::int64_t> cache(path, capacity);
+		assert(!cache.restored());
+		assert(cache.size() == 0);
+		for (std::int64_t i = 0; i < 10; ++i) {
+			assert(!cache.contains(i));
+		}
+		for (std::int64_t i = 10; i < 20; ++i) {
+			cache.put(i, i);
+		}
+		assert(cache.size() == capacity);
+		std::int64_t v = 0;
+		assert(cache.get(19, v) && v == 19);
+	}
+	std::cout << "MappedCache layout change passed.\n";
+
+	std::remove(path.c_str());
+	std::remove((path + ".crash").c_str());
+	std::remove((path + ".links").c_str());
+}
+
+/**
+* Unit tests for MappedCache in shared memory, across forked processes.
+*/
+void test::shared_cache()
+{
+	typedef MappedCache<std::int64_t, std::int64_t> Cache;
+	const std::string name = "/cache-manager-test";
+	Cache::unlink_shared(name);
+
+	Cache cache(name, 1024, Cache::Backing::SHARED_MEMORY);
+	assert(!cache.restored());
+
+	// Four workers fill disjoint key ranges of the one arena.
+	std::vector<pid_t> workers;
+	for (int w = 0; w < 4; ++w) {
+		pid_t pid = fork();
+		assert(pid >= 0);
+		if (pid == 0) {
+			Cache child(name, 1024, Cache::Backing::SHARED_MEMORY);
+			if (!child.restored()) {
+				_exit(1);
+			}
+			for (std::int64_t i = 0; i < 200; ++i) {
+				child.put(w * 1000 + i, i);
+			}
+			_exit(0);
+		}
+		workers.push_back(pid);
+	}
+	for (pid_t pid : workers) {
+		int status = 0;
+		waitpid(pid, &status, 0);
+		assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+	}
+	assert(cache.size() == 800);
+	for (std::int64_t w = 0; w < 4; ++w) {
+		for (std::int64_t i = 0; i < 200; ++i) {
+			std::int64_t v = -1;
+			assert(cache.get(w * 1000 + i, v) && v == i);
+		}
+	}
+	std::cout << "Shared MappedCache across processes passed.\n";
+
+	// A worker killed at an arbitrary point must leave a usable arena.
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if (pid == 0) {
+		Cache child(name, 1024, Cache::Backing::SHARED_MEMORY);
+		for (std::int64_t i = 0; ; ++i) {
+			child.put(i % 5000, i);
+		}
+	}
+	struct timespec pause = {0, 20000000};
+	nanosleep(&pause, nullptr);
+	kill(pid, SIGKILL);
+	waitpid(pid, nullptr, 0);
+
+	for (std::int64_t i = 0; i < 3000; ++i) {
+		cache.put(100000 + i, i);
+	}
+	assert(cache.size() == 1024);
+	for (std::int64_t i = 3000 - 1024; i < 3000; ++i) {
+		std::int64_t v = -1;
+		assert(cache.get(100000 + i, v) && v == i);
+	}
+	std::cout << "Shared MappedCache after a killed worker passed ("
+		<< cache.recoveries() << " recoveries).\n";
+
+	Cache::unlink_shared(name);
+}
+
+/**
+* Unit tests for SpillTier.
+*/
+void test::spill_tier()
+{
+	const std::string dir = "/tmp/cache-manager-spill-test";
+	mkdir(dir.c_str(), 0755);
+
+	SpillOptions options;
+	options.directory = dir;
+	options.segment_bytes = 64 * 1024;
+	options.buffer_bytes = 8 * 1024;
+	options.io_threads = 2;
+	{
+		SpillTier<std::int64_t, std::string> tier(options);
+
+		// Records in the write buffer and on disk both read back.
+		for (std::int64_t i = 0; i < 2000; ++i) {
+			tier.put(i, "value-" + std::to_string(i));
+		}
+		assert(tier.size() == 2000);
+		std::string v;
+		assert(tier.get(0, v) && v == "value-0");
+		assert(tier.get(1999, v) && v == "value-1999");
+		assert(!tier.get(5000, v));
+		std::cout << "SpillTier put(), get() passed.\n";
+
+		// A record larger than the write batch.
+		std::string big(20000, 'b');
+		tier.put(-1, big);
+		assert(tier.get(-1, v) && v == big);
+		std::cout << "SpillTier large record passed.\n";
+
+		// Overwrites leave the old segments mostly dead; reclaim them.
+		std::uint64_t before = tier.disk_bytes();
+		for (std::int64_t i = 0; i < 1500; ++i) {
+			tier.put(i, "new-" + std::to_string(i));
+		}
+		tier.flush();
+		assert(tier.reclaim() > 0);
+		for (std::int64_t i = 0; i < 2000; ++i) {
+			assert(tier.get(i, v));
+			assert(v == (i < 1500 ? "new-" : "value-") + std::to_string(i));
+		}
+		assert(tier.disk_bytes() < before + before / 2);
+		std::cout << "SpillTier reclaim() passed.\n";
+
+		// take() removes, erase() removes, async reads go through the pool.
+		assert(tier.take(7, v) && v == "new-7");
+		assert(!tier.contains(7));
+		assert(tier.erase(8));
+		assert(!tier.erase(8));
+		auto hit = tier.get_async(9);
+		auto miss = tier.get_async(8);
+		assert(hit.get().value() == "new-9");
+		assert(!miss.get().has_value());
+		std::cout << "SpillTier take(), erase(), get_async() passed.\n";
+
+		// erase_if() matches on the values read back.
+		assert(tier.erase_if([](std::int64_t, const std::string& value) {
+			return value == "new-9" || value == "value-1999";
+		}) == 2);
+		assert(!tier.contains(9) && !tier.contains(1999));
+		assert(tier.contains(10));
+		std::cout << "SpillTier erase_if() passed.\n";
+
+		// Once closed, async reads resolve empty without touching the disk.
+		tier.close();
+		assert(!tier.get_async(10).get().has_value());
+		std::cout << "SpillTier close() passed.\n";
+	}
+
+	// Tiers sharing a directory keep their segments apart.
+	{
+		SpillTier<std::int64_t, std::string> a(options);
+		SpillTier<std::int64_t, std::string> b(options);
+		a.put(1, "a");
+		a.flush();
+		b.put(1, "b");
+		b.flush();
+		std::string v;
+		assert(a.get(1, v) && v == "a");
+		assert(b.get(1, v) && v == "b");
+	}
+	std::cout << "SpillTier shared directory passed.\n";
+
+	// A tight budget drops the oldest segments.
+	options.max_bytes = 128 * 1024;
+	{
+		SpillTier<std::int64_t, std::string> tier(options);
+		for (std::int64_t i = 0; i < 20000; ++i) {
+			tier.put(i, "value-" + std::to_string(i));
+		}
+		assert(tier.disk_bytes() <= options.max_bytes);
+		std::string v;
+		assert(!tier.get(0, v));
+		assert(tier.get(19999, v) && v == "value-19999");
+	}
+	std::cout << "SpillTier disk budget passed.\n";
+	// Empty again: every tier removed its own subdirectory.
+	assert(rmdir(dir.c_str()) == 0);
+}
+
+namespace {
+	/**
+	* A BackingStore that fails its first write.
+	*/
+	class FlakyStore : public BackingStore<int, int> {
+	public:
+		void write_batch(const std::vector<std::pair<int, int>>& batch) override
+		{
+			if (!failed) {
+				failed = true;
+				throw std::runtime_error("store unavailable");
+			}
+			for (const auto& kv : batch) {
+				values[kv.first] = kv.second;
+			}
+		}
+		bool read(const int& key, int& value) override
+		{
+			auto it = values.find(key);
+			if (it == values.end()) {
+				return false;
+			}
+			value = it->second;
+			return true;
+		}
+		bool failed = false;
+		std::unordered_map<int, int> values;
+	};
+
+	/**
+	* A BackingStore that takes 20 ms per batch.
+	*/
+	class SlowStore : public BackingStore<int, int> {
+	public:
+		void write_batch(const std::vector<std::pair<int, int>>&) override
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			++batches;
+		}
+		bool read(const int&, int&) override
+		{
+			return false;
+		}
+		std::atomic<int> batches{0};
+	};
+}
+
+/**
+* Unit tests for WriteBack and FileStore.
+*/
+void test::write_back()
+{
+	const std::string path = "/tmp/cache-manager-test.store";
+	std::remove(path.c_str());
+	{
+		FileStore<std::int64_t, std::string> store(path);
+		WriteBackOptions options;
+		options.batch_size = 1000;
+		options.interval = std::chrono::milliseconds(20);
+		WriteBack<std::int64_t, std::string> wb(store, options);
+
+		// 100 writes to one key and one write to each of ten others reach
+		// the store as eleven writes.
+		for (int i = 0; i < 100; ++i) {
+			wb.mark_dirty(0, "v" + std::to_string(i));
+		}
+		for (std::int64_t k = 1; k <= 10; ++k) {
+			wb.mark_dirty(k, "w");
+		}
+		assert(wb.coalesced() == 99);
+		wb.flush_all();
+		assert(wb.pending() == 0);
+		assert(store.writes() == 11);
+		std::string v;
+		assert(store.read(0, v) && v == "v99");
+		std::cout << "WriteBack coalescing passed.\n";
+
+		// A synchronous flush of one key, as before an eviction.
+		wb.mark_dirty(42, "evicted");
+		assert(wb.dirty(42));
+		wb.flush(42);
+		assert(!wb.dirty(42));
+		assert(store.read(42, v) && v == "evicted");
+		std::cout << "WriteBack flush() passed.\n";
+
+		// The flusher drains in the background.
+		wb.mark_dirty(7, "background");
+		for (int i = 0; i < 100 && wb.pending() > 0; ++i) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		assert(wb.pending() == 0);
+		assert(store.read(7, v) && v == "background");
+		std::cout << "WriteBack background flush passed.\n";
+	}
+	{
+		// The log replays on reopen.
+		FileStore<std::int64_t, std::string> store(path);
+		std::string v;
+		assert(store.read(0, v) && v == "v99");
+		assert(store.read(7, v) && v == "background");
+	}
+	std::cout << "FileStore replay passed.\n";
+	std::remove(path.c_str());
+
+	// A failed batch stays pending and is retried.
+	FlakyStore flaky;
+	{
+		WriteBack<int, int> wb(flaky);
+		wb.mark_dirty(1, 10);
+		try {
+			wb.flush(1);
+			assert(false);
+		} catch (const std::runtime_error&) {
+			// Expected.
+		}
+		assert(wb.errors() == 1);
+		assert(wb.dirty(1));
+	}
+	int v = 0;
+	assert(flaky.read(1, v) && v == 10);
+	std::cout << "WriteBack retry passed.\n";
+
+	// A synchronous flush waits for the batch in flight, not the whole
+	// drain the flusher is in.
+	SlowStore slow;
+	{
+		WriteBackOptions options;
+		options.batch_size = 1;
+		WriteBack<int, int> wb(slow, options);
+		for (int k = 0; k < 20; ++k) {
+			wb.mark_dirty(k, k);
+		}
+		while (slow.batches.load() == 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		wb.mark_dirty(99, 99);
+		wb.flush(99);
+		assert(slow.batches.load() < 10);
+	}
+	std::cout << "WriteBack flush() during a drain passed.\n";
+}
+
+/**
+* Unit tests for NegativeCache.
+*/
+void test::negative_cache()
+{
+	NegativeCacheOptions options;
+	options.expected_keys = 100000;
+	options.false_positive_rate = 0.01;
+	NegativeCache<std::int64_t> filter(options);
+	assert(filter.bytes() % NegativeCache<std::int64_t>::BLOCK_BYTES == 0);
+	assert(filter.probes() >= 1);
+
+	const std::int64_t n = 50000;
+	for (std::int64_t k = 0; k < n; ++k) {
+		filter.add(k);
+	}
+	// No false negatives.
+	for (std::int64_t k = 0; k < n; ++k) {
+		assert(filter.absent(k));
+	}
+	// Blocking costs some accuracy; stay within a small multiple.
+	std::size_t false_positives = 0;
+	for (std::int64_t k = n; k < 2 * n; ++k) {
+		false_positives += filter.absent(k);
+	}
+	assert(false_positives < static_cast<std::size_t>(n * 0.03));
+	std::cout << "NegativeCache false positives: " << false_positives <<
+		" / " << n << ".\n";
+
+	// forget() is exact, and doesn't disturb keys outside the block.
+	for (std::int64_t k = 0; k < n; k += 2) {
+		filter.forget(k);
+		assert(!filter.absent(k));
+	}
+	std::size_t kept = 0;
+	for (std::int64_t k = 1; k < n; k += 2) {
+		kept += filter.absent(k);
+	}
+	assert(kept > static_cast<std::size_t>(n / 2 * 0.9));
+	std::cout << "NegativeCache forget() passed.\n";
+
+	filter.clear();
+	assert(!filter.absent(1));
+
+	// The memory cap wins over the requested rate.
+	options.max_bytes = 4096;
+	NegativeCache<std::int64_t> capped(options);
+	assert(capped.bytes() == 4096);
+	std::cout << "NegativeCache sizing passed.\n";
+}
+
+/**
+* Unit tests for HotKeys, VersionTable and NearCache.
+*/
+void test::hot_keys()
+{
+	HotKeyOptions options;
+	options.capacity = 16;
+	options.sample_every = 1;
+	options.threshold = 0.05;
+	HotKeys<int> tracker(options);
+
+	// Key 7 takes 30% of reads; the rest are spread over 1000 keys.
+	bool hot_seen = false;
+	bool cold_hot = false;
+	for (int i = 0; i < 100000; ++i) {
+		if (i % 10 < 3) {
+			hot_seen |= tracker.record(7);
+		} else {
+			cold_hot |= tracker.record(1000 + (i * 7919) % 1000);
+		}
+	}
+	assert(hot_seen);
+	assert(!cold_hot);
+	std::vector<HotKey<int>> top = tracker.top(3);
+	assert(!top.empty() && top[0].key == 7);
+	assert(top.size() <= 3);
+	std::cout << "HotKeys top-K passed.\n";
+
+	VersionTable versions(100);
+	NearCache<int, std::string> front(8);
+	std::size_t hash = std::hash<int>()(7);
+	std::size_t stripe = versions.stripe(hash);
+	front.put(7, hash, "seven", versions.current(stripe));
+	std::string *copy = front.get(7, hash, versions);
+	assert(copy != nullptr && *copy == "seven");
+	assert(front.get(8, std::hash<int>()(8), versions) == nullptr);
+
+	// An update bumps the stripe and the copy goes stale.
+	versions.bump(stripe);
+	assert(front.get(7, hash, versions) == nullptr);
+	front.put(7, hash, "SEVEN", versions.current(stripe));
+	assert(*front.get(7, hash, versions) == "SEVEN");
+	versions.bump_all();
+	assert(front.get(7, hash, versions) == nullptr);
+
+	// A copy past its deadline is not served.
+	front.put(7, hash, "seven", versions.current(stripe),
+		NearCache<int, std::string>::Clock::now());
+	assert(front.get(7, hash, versions) == nullptr);
+	std::cout << "NearCache invalidation passed.\n";
+
+	// With one set, the two ways keep the two most recently used keys.
+	NearCache<int, int> l1(2);
+	std::uint64_t v = versions.current(stripe);
+	l1.put(1, hash, 10, v);
+	l1.put(2, hash, 20, v);
+	assert(*l1.get(1, hash, versions) == 10);
+	assert(*l1.get(2, hash, versions) == 20);
+	assert(*l1.get(1, hash, versions) == 10);
+	l1.put(3, hash, 30, v);
+	assert(l1.get(2, hash, versions) == nullptr);
+	assert(*l1.get(1, hash, versions) == 10);
+	assert(*l1.get(3, hash, versions) == 30);
+	l1.clear();
+	assert(l1.get(1, hash, versions) == nullptr);
+	std::cout << "NearCache two-way replacement passed.\n";
+}
+
+/**
+* Unit tests for MpscQueue and RemovalDispatcher.
+*/
+void test::removal_listener()
+{
+	// Four producers; the consumer sees each producer's elements in order.
+	MpscQueue<std::uint64_t> queue(1024);
+	const std::uint64_t per_thread = 50000;
+	std::vector<std::thread> producers;
+	for (std::uint64_t t = 0; t < 4; ++t) {
+		producers.emplace_back([&queue, t, per_thread]() {
+			for (std::uint64_t i = 0; i < per_thread; ++i) {
+				std::uint64_t element = (t << 32) | i;
+				while (!queue.try_push(std::move(element))) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	std::vector<std::uint64_t> next(4, 0);
+	std::vector<std::uint64_t> batch;
+	std::uint64_t seen = 0;
+	while (seen < 4 * per_thread) {
+		batch.clear();
+		seen += queue.pop_batch(batch, 128);
+		for (std::uint64_t element : batch) {
+			std::uint64_t t = element >> 32;
+			assert((element & 0xffffffffu) == next[t]);
+			++next[t];
+		}
+	}
+	for (std::thread& p : producers) {
+		p.join();
+	}
+	assert(queue.empty());
+
+	MpscQueue<int> small(2);
+	int a = 1, b = 2, c = 3;
+	assert(small.try_push(std::move(a)) && small.try_push(std::move(b)));
+	assert(!small.try_push(std::move(c)));
+	std::cout << "MpscQueue passed.\n";
+
+	{
+		RemovalDispatcher<int, std::string> dispatcher;
+		std::vector<int> keys;
+		std::thread::id caller = std::this_thread::get_id();
+		bool off_thread = true;
+		dispatcher.add_listener([&](const int& key, const std::string& value,
+			RemovalCause cause) {
+			off_thread &= std::this_thread::get_id() != caller;
+			assert(value == std::to_string(key));
+			assert(cause == RemovalCause::SIZE);
+			keys.push_back(key);
+		});
+		for (int i = 0; i < 1000; ++i) {
+			assert(dispatcher.notify(i, std::to_string(i), RemovalCause::SIZE));
+		}
+		dispatcher.drain();
+		assert(keys.size() == 1000 && keys[999] == 999);
+		assert(off_thread);
+		assert(dispatcher.delivered() == 1000 && dispatcher.dropped() == 0);
+	}
+	std::cout << "RemovalDispatcher delivery passed.\n";
+
+	// A stuck listener fills the queue; the rest are dropped and counted.
+	{
+		RemovalOptions options;
+		options.queue_capacity = 4;
+		options.batch_size = 1;
+		RemovalDispatcher<int, int> dispatcher(options);
+		std::mutex gate;
+		std::unique_lock<std::mutex> hold(gate);
+		dispatcher.add_listener([&gate](const int&, const int&, RemovalCause) {
+			std::lock_guard<std::mutex> wait(gate);
+		});
+		std::size_t queued = 0;
+		for (int i = 0; i < 100; ++i) {
+			queued += dispatcher.notify(i, i, RemovalCause::EXPLICIT);
+		}
+		assert(queued <= 5);
+		assert(dispatcher.dropped() == 100 - queued);
+		hold.unlock();
+		dispatcher.drain();
+		assert(dispatcher.delivered() == queued);
+	}
+	std::cout << "RemovalDispatcher drops passed.\n";
+}
+
+/**
+* Unit tests for Maintenance.
+*/
+void test::maintenance()
+{
+	using std::chrono::microseconds;
+	using std::chrono::milliseconds;
+
+	// Owner-driven: run_once() paces by backlog and write rate.
+	MaintenanceOptions options;
+	options.own_thread = false;
+	options.min_interval = microseconds(100);
+	options.max_interval = microseconds(50000);
+	options.writes_per_run = 100;
+	Maintenance scheduler(options);
+
+	int backlog = 3;
+	int slices = 0;
+	int rare = 0;
+	scheduler.add_task("backlog", [&](Maintenance::Clock::time_point
+		deadline) {
+		assert(deadline > Maintenance::Clock::now() - milliseconds(1));
+		++slices;
+		return --backlog > 0;
+	});
+	scheduler.add_task("rare", [&](Maintenance::Clock::time_point) {
+		++rare;
+		return false;
+	}, milliseconds(10000));
+
+	assert(scheduler.run_once() == options.min_interval);
+	assert(scheduler.run_once() == options.min_interval);
+	// Caught up and no writes: idle pace.
+	assert(scheduler.run_once() == options.max_interval);
+	assert(scheduler.run_once() == options.max_interval);
+	assert(slices == 4 && rare == 1);
+	assert(scheduler.runs() == 4);
+
+	// A burst of writes shortens the pause.
+	std::this_thread::sleep_for(milliseconds(5));
+	for (int i = 0; i < 10000; ++i) {
+		scheduler.note_write();
+	}
+	microseconds busy = scheduler.run_once();
+	assert(busy < options.max_interval);
+	assert(busy >= options.min_interval);
+	assert(scheduler.interval() == busy);
+	std::cout << "Maintenance pacing passed.\n";
+
+	// Own thread: runs without being driven, and stops on destruction.
+	std::atomic<int> runs(0);
+	{
+		MaintenanceOptions threaded;
+		threaded.max_interval = microseconds(2000);
+		Maintenance background(threaded);
+		background.add_task("count", [&runs](Maintenance::Clock::time_point) {
+			++runs;
+			return false;
+		});
+		for (int i = 0; i < 200 && runs.load() < 3; ++i) {
+			std::this_thread::sleep_for(milliseconds(5));
+		}
+	}
+	assert(runs.load() >= 3);
+	std::cout << "Maintenance thread passed.\n";
+}
+
+namespace {
+	/**
+	* Overwrites a file with one line.
+	*/
+	void write_file(const std::string& path, const std::string& line)
+	{
+		std::ofstream out(path, std::ios::trunc);
+		out << line << "\n";
+	}
+}
+
+/**
+* Unit tests for MemoryPressure.
+*/
+void test::memory_pressure()
+{
+	MemoryPressureOptions options;
+	options.current_path = "/tmp/cache-manager-test.pressure.current";
+	options.max_path = "/tmp/cache-manager-test.pressure.max";
+	options.step = 0.1;
+	options.min_capacity = 100;
+	MemoryPressure controller(options, 1000);
+
+	// An unlimited cgroup leaves the capacity alone.
+	write_file(options.current_path, "500");
+	write_file(options.max_path, "max");
+	assert(controller.usage() < 0);
+	assert(controller.adjust(1000) == 1000);
+
+	write_file(options.max_path, "1000");
+	write_file(options.current_path, "900");
+	assert(controller.usage() > 0.89 && controller.usage() < 0.91);
+	assert(controller.adjust(1000) == 900);
+	write_file(options.current_path, "990");
+	assert(controller.adjust(900) == 700);
+	assert(controller.adjust(150) == 100);
+
+	// Hold between low and high; grow back by half steps below low.
+	write_file(options.current_path, "800");
+	assert(controller.adjust(700) == 700);
+	write_file(options.current_path, "100");
+	assert(controller.adjust(700) == 750);
+	assert(controller.adjust(990) == 1000);
+	std::cout << "MemoryPressure cgroup passed.\n";
+
+	// RSS mode reads the resident pages from statm.
+	options.use_rss = true;
+	options.statm_path = "/tmp/cache-manager-test.statm";
+	options.rss_limit = 100 * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+	MemoryPressure rss(options, 1000);
+	write_file(options.statm_path, "4000 96 10 1 0 50 0");
+	assert(rss.usage() > 0.95);
+	assert(rss.adjust(1000) == 800);
+	std::cout << "MemoryPressure RSS passed.\n";
+
+	std::remove(options.current_path.c_str());
+	std::remove(options.max_path.c_str());
+	std::remove(options.statm_path.c_str());
+}
+
+/**
+* Unit tests for Shards.
+*/
+void test::shards()
+{
+	// A loop over 10000 keys: LRU misses everything below 10000 entries and
+	// nothing above, apart from the first pass.
+	MrcOptions options;
+	options.sample_rate = 0.05;
+	options.max_cache_size = 20000;
+	options.buckets = 40;
+	Shards<std::int64_t> loop(options);
+	for (int pass = 0; pass < 20; ++pass) {
+		for (std::int64_t k = 0; k < 10000; ++k) {
+			loop.access(k);
+		}
+	}
+	assert(loop.miss_ratio(5000) > 0.95);
+	assert(loop.miss_ratio(15000) < 0.1);
+	std::vector<std::pair<std::size_t, double>> curve = loop.curve();
+	assert(curve.size() == 41 && curve.front().second == 1.0);
+	for (std::size_t i = 1; i < curve.size(); ++i) {
+		assert(curve[i].second <= curve[i - 1].second);
+	}
+	std::cout << "Shards loop passed.\n";
+
+	// Uniform over 10000 keys: the miss ratio at c is about 1 - c / 10000.
+	options.max_keys = 200;
+	Shards<std::int64_t> uniform(options);
+	std::uint64_t x = 12345;
+	for (int i = 0; i < 1000000; ++i) {
+		x = x * 6364136223846793005ull + 1442695040888963407ull;
+		uniform.access(static_cast<std::int64_t>((x >> 33) % 10000));
+	}
+	// The tracked set is capped, so the rate dropped to fit.
+	assert(uniform.tracked() <= 200);
+	assert(uniform.rate() < 0.05);
+	double half = uniform.miss_ratio(5000);
+	assert(half > 0.4 && half < 0.6);
+	std::cout << "Shards uniform passed (rate " << uniform.rate() <<
+		", miss ratio at half " << half << ").\n";
+}
+
+/**
+* Unit tests for CacheStats.
+*/
+void test::cache_stats()
+{
+	// Buckets cover every value, in order, within 1/16 of it.
+	for (std::uint64_t v : {0ull, 1ull, 15ull, 16ull, 17ull, 40ull, 1000ull,
+		123456789ull, ~0ull}) {
+		std::size_t b = LatencyHistogram::bucket(v);
+		assert(b < LatencyHistogram::BUCKETS);
+		assert(LatencyHistogram::lowest(b) <= v);
+		assert(v <= LatencyHistogram::highest(b));
+		assert(LatencyHistogram::highest(b) - LatencyHistogram::lowest(b) <=
+			v / 16);
+	}
+	for (std::size_t b = 1; b < LatencyHistogram::BUCKETS; ++b) {
+		assert(LatencyHistogram::lowest(b) ==
+			LatencyHistogram::highest(b - 1) + 1);
+	}
+
+	LatencyHistogram histogram;
+	for (std::uint64_t ns = 1; ns <= 1000; ++ns) {
+		histogram.record(ns);
+	}
+	HistogramSnapshot latency = histogram.snapshot();
+	assert(latency.count == 1000);
+	assert(latency.percentile(0.5) >= 500 && latency.percentile(0.5) <= 532);
+	assert(latency.percentile(1.0) >= 1000 && latency.percentile(1.0) < 1064);
+	assert(latency.mean() > 480 && latency.mean() < 520);
+	std::cout << "LatencyHistogram passed.\n";
+
+	// Counters add up over threads.
+	CacheStats stats;
+	stats.enable_latency();
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 8; ++t) {
+		threads.emplace_back([&stats]() {
+			for (int i = 0; i < 10000; ++i) {
+				CacheStats::Timer timer = stats.time_get();
+				if (i % 4 == 0) {
+					stats.miss();
+				} else {
+					stats.hit();
+				}
+				stats.resident(16);
+			}
+			stats.removed(RemovalCause::SIZE);
+			stats.loaded(true, stats.start());
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	StatsSnapshot snapshot = stats.snapshot();
+	assert(snapshot.hits == 60000 && snapshot.misses == 20000);
+	assert(snapshot.hit_ratio() == 0.75);
+	assert(snapshot.removed(RemovalCause::SIZE) == 8);
+	assert(snapshot.removed(RemovalCause::EXPIRED) == 0);
+	assert(snapshot.loads == 8 && snapshot.load_failures == 0);
+	assert(snapshot.bytes == 80000 * 16);
+	assert(snapshot.get_latency.count == 80000);
+	assert(snapshot.put_latency.count == 0);
+
+	// NoStats keeps nothing.
+	NoStats none;
+	none.hit();
+	assert(none.snapshot().hits == 0 && !NoStats::ENABLED);
+	std::cout << "CacheStats passed.\n";
+}
+
+/**
+* Unit tests for Tracer.
+*/
+void test::trace()
+{
+	Tracer& tracer = Tracer::shared();
+	tracer.clear();
+	tracer.set_ring_capacity(64);
+
+	// Each thread nests a span in another; only the last 64 stay.
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([]() {
+			for (int i = 0; i < 100; ++i) {
+				TraceScope outer(TracePhase::CACHE_GET);
+				TraceScope inner(TracePhase::BUCKET_SCAN);
+				inner.end();
+				inner.end();
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	assert(tracer.calibrate() > 0);
+
+	std::stringstream buffer;
+	std::size_t written = tracer.dump(buffer);
+	assert(written == 4 * 64);
+	TraceDump dump = Tracer::read(buffer);
+	assert(dump.records.size() == written);
+	assert(dump.ticks_per_ns == tracer.calibrate());
+	std::size_t outer = 0;
+	for (std::size_t i = 0; i < dump.records.size(); ++i) {
+		const TraceRecord& record = dump.records[i];
+		if (record.phase == TracePhase::CACHE_GET) {
+			++outer;
+		} else {
+			assert(record.phase == TracePhase::BUCKET_SCAN);
+		}
+		// Oldest first within a thread; inner spans end before outer ones.
+		if (i > 0 && dump.records[i - 1].thread == record.thread) {
+			const TraceRecord& prev = dump.records[i - 1];
+			assert(prev.start + prev.ticks <= record.start + record.ticks);
+		}
+	}
+	assert(outer == written / 2);
+
+	tracer.clear();
+	std::stringstream empty;
+	assert(tracer.dump(empty) == 0);
+	tracer.set_ring_capacity(Tracer::DEFAULT_RING_CAPACITY);
+	std::cout << "Tracer passed.\n";
+}
+
+/**
+* Unit tests for the workload generators in util.
+*/
+void test::workload()
+{
+	// Same seed, same stream.
+	util::Xoshiro256 a(42);
+	util::Xoshiro256 b(42);
+	for (int i = 0; i < 1000; ++i) {
+		assert(a.next() == b.next());
+		assert(a.below(10) < 10);
+		double u = a.uniform();
+		assert(u >= 0.0 && u < 1.0);
+		b.below(10);
+		b.uniform();
+	}
+	assert(util::generate_random(100, -5, 5, 7) ==
+		util::generate_random(100, -5, 5, 7));
+	for (int n : util::generate_random(1000, -5, 5)) {
+		assert(n >= -5 && n <= 5);
+	}
+
+	const std::size_t n = 200000;
+	std::vector<std::uint64_t> keys(n);
+	auto counts = [&keys](std::uint64_t items) {
+		std::vector<std::size_t> count(items, 0);
+		for (std::uint64_t k : keys) {
+			assert(k < items);
+			++count[k];
+		}
+		return count;
+	};
+
+	// Zipfian: key 0 is hottest, and at theta .99 over 1000 keys it takes
+	// about 1/zeta(1000) of the draws, ~13%.
+	util::KeyOptions options;
+	options.items = 1000;
+	util::KeyGenerator zipf(options);
+	zipf.fill(keys.data(), n);
+	std::vector<std::size_t> count = counts(1000);
+	assert(count[0] > count[1] && count[1] > count[10] &&
+		count[10] > count[500]);
+	assert(count[0] > n / 10 && count[0] < n / 6);
+
+	// Scrambled: as skewed, but the hottest key is elsewhere. The same
+	// seed draws the same ranks, and a permutation keeps every rank's
+	// count apart, so the sorted counts match exactly.
+	options.distribution = util::Distribution::SCRAMBLED_ZIPFIAN;
+	util::KeyGenerator scrambled(options);
+	scrambled.fill(keys.data(), n);
+	std::vector<std::size_t> permuted = counts(1000);
+	std::size_t hottest = std::max_element(permuted.begin(),
+		permuted.end()) - permuted.begin();
+	assert(hottest != 0 && permuted[hottest] > n / 10);
+	std::sort(count.begin(), count.end());
+	std::sort(permuted.begin(), permuted.end());
+	assert(permuted == count);
+
+	// Hotspot: 80% of draws in the first 20% of keys.
+	options.distribution = util::Distribution::HOTSPOT;
+	util::KeyGenerator hotspot(options);
+	hotspot.fill(keys.data(), n);
+	std::size_t hot = 0;
+	for (std::uint64_t k : keys) {
+		hot += k < 200;
+	}
+	assert(hot > n * 78 / 100 && hot < n * 82 / 100);
+
+	// Latest: the newest key is hottest, also after the space grows.
+	options.distribution = util::Distribution::LATEST;
+	util::KeyGenerator latest(options);
+	latest.grow(2000);
+	latest.fill(keys.data(), n);
+	count = counts(2000);
+	assert(count[1999] > count[1998] && count[1999] > n / 10);
+
+	// Sequential wraps around.
+	options.distribution = util::Distribution::SEQUENTIAL;
+	util::KeyGenerator sequential(options);
+	sequential.fill(keys.data(), 2500);
+	assert(keys[0] == 0 && keys[999] == 999 && keys[1000] == 0 &&
+		keys[2499] == 499);
+	std::cout << "KeyGenerator passed.\n";
+
+	// YCSB mixes.
+	std::vector<util::Op> ops(n);
+	util::Workload a_mix(util::ycsb('A', 1000));
+	a_mix.fill(ops.data(), n);
+	std::size_t reads = 0;
+	for (const util::Op& op : ops) {
+		assert(op.type == util::OpType::READ ||
+			op.type == util::OpType::UPDATE);
+		reads += op.type == util::OpType::READ;
+		assert(op.key < 1000 && op.length == 100);
+	}
+	assert(reads > n * 49 / 100 && reads < n * 51 / 100);
+
+	util::Workload d_mix(util::ycsb('D', 1000));
+	d_mix.fill(ops.data(), n);
+	std::size_t inserts = 0;
+	for (const util::Op& op : ops) {
+		if (op.type == util::OpType::INSERT) {
+			// Inserts take the next new key.
+			assert(op.key == 1000 + inserts);
+			++inserts;
+		} else {
+			assert(op.type == util::OpType::READ && op.key < 1000 + inserts);
+		}
+	}
+	assert(inserts > n * 4 / 100 && inserts < n * 6 / 100);
+	assert(d_mix.items() == 1000 + inserts);
+
+	// Offset and stride split the new keys between generators.
+	util::WorkloadOptions second = util::ycsb('D', 1000);
+	second.insert_offset = 1;
+	second.insert_stride = 2;
+	util::Workload d_second(second);
+	d_second.fill(ops.data(), n);
+	inserts = 0;
+	for (const util::Op& op : ops) {
+		if (op.type == util::OpType::INSERT) {
+			assert(op.key == 1001 + 2 * inserts);
+			++inserts;
+		}
+	}
+	assert(inserts > 0);
+
+	util::WorkloadOptions e_mix = util::ycsb('E', 1000);
+	e_mix.values.min = 10;
+	e_mix.values.max = 1000;
+	util::Workload e(e_mix);
+	e.fill(ops.data(), n);
+	for (const util::Op& op : ops) {
+		if (op.type == util::OpType::SCAN) {
+			assert(op.length >= 1 && op.length <= 100);
+		} else {
+			assert(op.type == util::OpType::INSERT);
+			assert(op.length >= 10 && op.length <= 1000);
+		}
+	}
+
+	bool thrown = false;
+	try {
+		util::ycsb('G', 1000);
+	} catch (const std::invalid_argument&) {
+		thrown = true;
+	}
+	assert(thrown);
+	std::cout << "Workload passed.\n";
+}
+
+/**
+* Unit tests for AccessTrace and the simulator policies.
+*/
+void test::cache_sim()
+{
+	const std::string text = "/tmp/cache-manager-test.trace";
+	const std::string binary = "/tmp/cache-manager-test.trace.bin";
+	{
+		std::ofstream out(text);
+		// 1 2 3 1 4 1 2 5 with a comment, a blank line and named keys.
+		out << "# key size\n1 10\n2 20\n3\n\n1 10\n4, 40\n1 10\n"
+			"2 20\nuser:5 50\n";
+	}
+	assert(csc::AccessTrace::convert(text, binary) == 8);
+
+	csc::AccessTrace parsed = csc::AccessTrace::open(text);
+	csc::AccessTrace mapped = csc::AccessTrace::open(binary);
+	assert(!parsed.binary() && mapped.binary());
+	csc::AccessTrace::Cursor a = parsed.cursor();
+	csc::AccessTrace::Cursor b = mapped.cursor();
+	csc::Access x, y;
+	std::size_t n = 0;
+	while (a.next(x)) {
+		assert(b.next(y));
+		assert(x.key == y.key && x.size == y.size);
+		++n;
+	}
+	assert(!b.next(y) && n == 8);
+	a = parsed.cursor();
+	a.next(x);
+	assert(x.key == 1 && x.size == 10);
+	a.next(x);
+	a.next(x);
+	assert(x.key == 3 && x.size == 1);
+	std::cout << "AccessTrace passed.\n";
+
+	// Three entries. FIFO evicts 1 for 4 though it was just used, then
+	// misses every access after.
+	csc::FifoPolicy fifo(3);
+	csc::SimResult result = csc::simulate(mapped, fifo, "fifo", 3);
+	assert(result.accesses == 8 && result.hits == 1);
+	assert(result.bytes == 10 + 20 + 1 + 10 + 40 + 10 + 20 + 50);
+	assert(result.hit_bytes == 10);
+
+	csc::ClockPolicy clock(3);
+	result = csc::simulate(mapped, clock, "clock", 3);
+	// 1 is referenced when 4 arrives, so 2 goes instead.
+	assert(result.hits == 2 && result.hit_bytes == 20);
+
+	csc::CachePolicy lru(3);
+	result = csc::simulate(mapped, lru, "lru", 3);
+	// 4 evicts 2 and 2 evicts 3: only 1 hits, twice.
+	assert(result.hits == 2 && result.hit_bytes == 20);
+
+	csc::OptPolicy opt(mapped, 3);
+	result = csc::simulate(mapped, opt, "opt", 3);
+	// 4 replaces 3, never used again: 1, 1 and 2 hit.
+	assert(result.hits == 3 && result.hit_bytes == 40);
+	// Next uses built once serve every size.
+	csc::OptPolicy::NextUses next = csc::OptPolicy::next_uses(mapped);
+	csc::OptPolicy shared(next, 3);
+	assert(csc::simulate(mapped, shared, "opt", 3).hits == 3);
+	csc::OptPolicy smaller(next, 2);
+	// 3 displaces 2, 4 displaces 3: the two accesses to 1 hit.
+	assert(csc::simulate(mapped, smaller, "opt", 2).hits == 2);
+
+	// A truncated binary trace is refused.
+	{
+		std::ifstream in(binary, std::ios::binary);
+		std::string bytes((std::istreambuf_iterator<char>(in)),
+			std::istreambuf_iterator<char>());
+		std::ofstream out(binary, std::ios::binary | std::ios::trunc);
+		out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 1));
+	}
+	bool thrown = false;
+	try {
+		csc::AccessTrace::open(binary);
+	} catch (const std::runtime_error&) {
+		thrown = true;
+	}
+	assert(thrown);
+	std::remove(text.c_str());
+	std::remove(binary.c_str());
+	std::cout << "Policies passed.\n";
+}
+
+namespace {
+/**
+* CacheManager's constructor is protected; tests make their own instances.
+*/
+class TestCache : public CacheManager<int, int> {
+public:
+	explicit TestCache(std::size_t capacity) : CacheManager(capacity) {}
+};
+}
+
+/**
+* Unit tests for AllocCounter, AllocScope and TrackingAllocator.
+*/
+void test::alloc_counter()
+{
+	// The global hook counts on this thread.
+	{
+		csc::AllocScope scope;
+		// volatile, so the pair isn't optimized away.
+		int *volatile p = new int(1);
+		delete p;
+		std::vector<std::uint64_t> v(100);
+		csc::AllocStats stats = scope.stats();
+		assert(stats.allocations == 2 && stats.deallocations == 1);
+		assert(stats.bytes == sizeof(int) + 100 * sizeof(std::uint64_t));
+	}
+	std::cout << "AllocScope passed.\n";
+
+	// A failed allocation calls the new_handler before giving up.
+	{
+		static int calls;
+		calls = 0;
+		std::set_new_handler([]() {
+			++calls;
+			std::set_new_handler(nullptr);
+		});
+		char *volatile p = new (std::nothrow) char[std::size_t(1) << 62];
+		assert(p == nullptr && calls == 1);
+	}
+	std::cout << "new_handler passed.\n";
+
+	// A tracking allocator sees only its own container's nodes.
+	csc::AllocTally tally;
+	{
+		std::list<int, csc::TrackingAllocator<int>> list{
+			csc::TrackingAllocator<int>(tally)};
+		for (int i = 0; i < 10; ++i) {
+			list.push_back(i);
+		}
+		std::vector<int> other(10);
+		assert(tally.stats().allocations == 10);
+		assert(tally.stats().bytes > 10 * sizeof(int));
+	}
+	assert(tally.stats().deallocations == 10);
+	std::cout << "TrackingAllocator passed.\n";
+
+	// Steady-state hit paths allocate nothing.
+	const std::string path = "/tmp/cache-manager-test.alloc.map";
+	std::remove(path.c_str());
+	{
+		MappedCache<std::int64_t, std::int64_t> cache(path, 64);
+		for (std::int64_t i = 0; i < 64; ++i) {
+			cache.put(i, i);
+		}
+		csc::LatencyHistogram histogram;
+		util::Workload workload(util::ycsb('A', 64));
+		std::vector<util::Op> ops(1000);
+		std::int64_t v = 0;
+
+		csc::AllocScope scope;
+		for (std::int64_t i = 0; i < 1000; ++i) {
+			assert(cache.get(i % 64, v) && v == i % 64);
+			cache.put(i % 64, i % 64);
+			histogram.record(static_cast<std::uint64_t>(i));
+		}
+		workload.fill(ops.data(), ops.size());
+		assert(scope.stats().allocations == 0);
+	}
+	std::remove(path.c_str());
+	{
+		TestCache cache(64);
+		HashMap<int, int> map;
+		for (int i = 0; i < 64; ++i) {
+			cache.insert(i, i);
+			map.insert(i, i);
+		}
+
+		csc::AllocScope scope;
+		for (int i = 0; i < 1000; ++i) {
+			assert(*cache.get(i % 64) == i % 64);
+			// Replacing a cached value relinks, but adds no node.
+			cache.insert(i % 64, i % 64);
+			assert(*map.get(i % 64) == i % 64);
+			map.replace(i % 64, i % 64);
+		}
+		assert(scope.stats().allocations == 0);
+	}
+	std::cout << "Zero-allocation hit paths passed.\n";
+}
+
+/**
+* Unit tests for BPlusTree.
+*/
+void test::bplus_tree()
+{
+	// Random keys against std::map, through several levels of splits.
+	csc::BPlusTree<std::uint64_t, std::uint64_t> tree;
+	std::map<std::uint64_t, std::uint64_t> reference;
+	util::Xoshiro256 rng(7);
+	for (int i = 0; i < 100000; ++i) {
+		std::uint64_t key = rng.below(50000) * 3;
+		assert(tree.insert(key, i) == reference.emplace(key, i).second);
+		reference[key] = i;
+	}
+	// Keys past the sign bit order as unsigned.
+	tree.insert(~std::uint64_t(0), 1);
+	reference[~std::uint64_t(0)] = 1;
+	assert(tree.size() == reference.size());
+	assert(tree.height() > 2);
+	for (std::uint64_t key = 0; key < 150003; ++key) {
+		const std::uint64_t *value = tree.find(key);
+		auto it = reference.find(key);
+		assert((value == nullptr) == (it == reference.end()));
+		assert(value == nullptr || *value == it->second);
+	}
+	assert(*tree.find(~std::uint64_t(0)) == 1);
+	auto it = reference.begin();
+	tree.for_each([&](std::uint64_t key, std::uint64_t value) {
+		assert(it != reference.end() && it->first == key &&
+			it->second == value);
+		++it;
+	});
+	assert(it == reference.end());
+	std::cout << "BPlusTree insert(), find(), for_each() passed.\n";
+
+	// Scans cross leaves; the bounds needn't be keys.
+	std::size_t expected = std::distance(reference.lower_bound(1000),
+		reference.lower_bound(90001));
+	std::uint64_t last = 0;
+	assert(tree.scan(1000, 90001, [&](std::uint64_t key, std::uint64_t) {
+		assert(key >= 1000 && key < 90001 && key > last);
+		last = key;
+	}) == expected);
+	std::cout << "BPlusTree scan() passed.\n";
+
+	// Signed keys, and the tree left empty by a move.
+	csc::BPlusTree<int, int> negative;
+	for (int i = 1000; i >= -1000; --i) {
+		negative.insert(i, -i);
+	}
+	assert(*negative.find(-1000) == 1000 && *negative.find(0) == 0);
+	assert(negative.find(1001) == nullptr);
+	csc::BPlusTree<int, int> moved(std::move(negative));
+	assert(negative.empty() && negative.find(0) == nullptr);
+	assert(moved.size() == 2001);
+	moved.clear();
+	assert(moved.empty() && moved.height() == 0);
+
+	// Keys without SIMD search go through Compare.
+	csc::BPlusTree<std::string, int> names;
+	for (int i = 0; i < 1000; ++i) {
+		names.insert("key" + std::to_string(i), i);
+	}
+	assert(names.size() == 1000 && *names.find("key517") == 517);
+	assert(!names.contains("key1000"));
+	csc::BPlusTree<int, int, std::greater<int>> descending;
+	for (int i = 0; i < 100; ++i) {
+		descending.insert(i, i);
+	}
+	int previous = 100;
+	descending.for_each([&](int key, int) {
+		assert(key < previous);
+		previous = key;
+	});
+
+	// Bulk loading the same sorted pairs packs the leaves: about half the
+	// nodes of ascending inserts, which leave each split leaf half full.
+	std::vector<std::pair<std::uint64_t, std::uint64_t>> sorted;
+	for (std::uint64_t i = 0; i < 200000; ++i) {
+		sorted.emplace_back(i * 2, i);
+	}
+	csc::BPlusTree<std::uint64_t, std::uint64_t> inserted;
+	for (const auto& pair : sorted) {
+		inserted.insert(pair.first, pair.second);
+	}
+	ThreadPool pool(4);
+	csc::BulkLoadOptions options;
+	options.pool = &pool;
+	csc::BPlusTree<std::uint64_t, std::uint64_t> packed;
+	packed.bulk_load(sorted.begin(), sorted.end(), options);
+	assert(packed.size() == sorted.size() && packed.fill() > 0.99);
+	assert(packed.bytes() * 10 < inserted.bytes() * 6);
+	assert(packed.height() <= inserted.height());
+	for (std::uint64_t key = 0; key < 400001; ++key) {
+		const std::uint64_t *value = packed.find(key);
+		assert(key % 2 == 1 || key == 400000 ? value == nullptr :
+			value != nullptr && *value == key / 2);
+	}
+	assert(packed.scan(1001, 2001, [](std::uint64_t, std::uint64_t) {}) ==
+		500);
+	// Packed leaves still take inserts, splitting as they fill.
+	assert(packed.insert(3, 3) && *packed.find(3) == 3);
+	assert(packed.size() == sorted.size() + 1);
+
+	// A lower fill leaves room; a forward range, empty or short, loads too.
+	std::list<std::pair<int, int>> few = {{1, 1}, {2, 2}, {5, 5}};
+	csc::BPlusTree<int, int> sparse;
+	sparse.bulk_load(few.begin(), few.end());
+	assert(sparse.size() == 3 && sparse.height() == 1 && *sparse.find(5) == 5);
+	sparse.bulk_load(few.end(), few.end());
+	assert(sparse.empty() && sparse.find(1) == nullptr);
+	options.fill = 0.5;
+	packed.bulk_load(sorted.begin(), sorted.end(), options);
+	assert(packed.fill() > 0.45 && packed.fill() < 0.55);
+	assert(*packed.find(399998) == 199999);
+
+	// Unordered input is refused and leaves the tree empty.
+	bool threw = false;
+	std::swap(sorted[100000], sorted[100001]);
+	try {
+		packed.bulk_load(sorted.begin(), sorted.end(), options);
+	} catch (const std::invalid_argument&) {
+		threw = true;
+	}
+	assert(threw && packed.empty());
+	std::swap(sorted[100000], sorted[100001]);
+
+	// A dump is a sorted file stream: load() bulk loads it.
+	std::stringstream stream;
+	inserted.dump(stream);
+	packed.load(stream);
+	assert(packed.size() == inserted.size() && packed.fill() > 0.99);
+	assert(*packed.find(0) == 0 && *packed.find(399998) == 199999);
+	std::stringstream truncated(stream.str().substr(0, 1000));
+	threw = false;
+	try {
+		packed.load(truncated);
+	} catch (const std::runtime_error&) {
+		threw = true;
+	}
+	assert(threw && packed.empty());
+	// A count far past the stream is refused, not allocated for.
+	std::string forged = stream.str();
+	const std::uint64_t huge = std::uint64_t(1) << 62;
+	std::memcpy(&forged[8], &huge, sizeof(huge));
+	std::stringstream oversized(forged);
+	threw = false;
+	try {
+		packed.load(oversized);
+	} catch (const std::runtime_error&) {
+		threw = true;
+	}
+	assert(threw && packed.empty());
+	// An out of order dump is read through its trailer, then refused.
+	std::stringstream unordered;
+	{
+		BinaryWriter writer(unordered);
+		write_dump_header(writer, DumpKind::BPLUS_TREE, 3);
+		for (std::uint64_t key : {1, 3, 2}) {
+			Codec<std::uint64_t>::write(writer, key);
+			Codec<std::uint64_t>::write(writer, key);
+		}
+		write_dump_trailer(writer, 3);
+		writer.flush();
+	}
+	threw = false;
+	try {
+		packed.load(unordered);
+	} catch (const std::invalid_argument&) {
+		threw = true;
+	}
+	assert(threw && packed.empty());
+	// Loaded at a lower fill, the last two leaves share what is left.
+	std::stringstream again(stream.str());
+	packed.load(again, options);
+	assert(packed.size() == inserted.size());
+	assert(packed.fill() > 0.45 && packed.fill() < 0.55);
+	std::size_t pairs = 0;
+	packed.for_each([&pairs](std::uint64_t key, std::uint64_t value) {
+		assert(value == key / 2 && key == 2 * pairs);
+		++pairs;
+	});
+	assert(pairs == inserted.size());
+	std::cout << "BPlusTree bulk_load(), dump(), load() passed.\n";
+	std::cout << "BPlusTree passed.\n";
+}
+
+/**
+* Unit tests for CacheManager.
+*/
+void test::cache_manager()
+{
+	// LRU order and eviction.
+	{
+		TestCache cache(2);
+		cache.insert(1, 10);
+		cache.insert(2, 20);
+		assert(*cache.get(1) == 10);
+		cache.insert(3, 30);
+		assert(cache.get(2) == nullptr);
+		assert(*cache.get(1) == 10 && *cache.get(3) == 30);
+	}
+	std::cout << "CacheManager get(), insert() passed.\n";
+
+	// An insert that lands while the loader runs wins over the load.
+	{
+		TestCache cache(4);
+		cache.set_loader([&cache](const int& key, int& value) {
+			cache.insert(key, 1);
+			value = 2;
+			return true;
+		});
+		assert(*cache.get(7) == 1);
+	}
+	std::cout << "CacheManager load racing insert passed.\n";
+
+	const std::string spill_dir = "/tmp/cache-manager-test.spill";
+
+	// A promotion from the spill tier is a clean copy: not written back.
+	{
+		const std::string path = "/tmp/cache-manager-test.promote";
+		std::remove(path.c_str());
+		auto owned = std::make_unique<FileStore<int, int>>(path);
+		FileStore<int, int> *store = owned.get();
+		mkdir(spill_dir.c_str(), 0755);
+		TestCache cache(2);
+		SpillOptions spill;
+		spill.directory = spill_dir;
+		cache.enable_spill(spill);
+		WriteBackOptions options;
+		options.interval = std::chrono::milliseconds(1);
+		cache.enable_write_back(std::move(owned), options);
+		cache.insert(1, 10);
+		cache.insert(2, 20);
+		// Evicts 1, flushing it and spilling it.
+		cache.insert(3, 30);
+		while (store->writes() < 3) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		assert(*cache.get_async(1).get() == 10);
+		assert(*cache.get(1) == 10);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		assert(store->writes() == 3);
+		std::remove(path.c_str());
+
+		// erase_if() reaches the spilled copy of 2 as well.
+		assert(cache.erase_if([](int key, int) { return key <= 2; }) == 2);
+		assert(!cache.get_async(2).get().has_value());
+	}
+	std::cout << "CacheManager get_async() promotion passed.\n";
+
+	// Promotions still in flight when the cache goes are dropped, not run
+	// against its destroyed members.
+	{
+		std::vector<std::future<std::optional<int>>> pending;
+		{
+			TestCache cache(2);
+			SpillOptions spill;
+			spill.directory = spill_dir;
+			cache.enable_spill(spill);
+			for (int i = 0; i < 200; ++i) {
+				cache.insert(i, i);
+			}
+			for (int i = 0; i < 198; ++i) {
+				pending.push_back(cache.get_async(i));
+			}
+		}
+		for (int i = 0; i < 198; ++i) {
+			std::optional<int> value = pending[i].get();
+			assert(!value || *value == i);
+		}
+	}
+	assert(rmdir(spill_dir.c_str()) == 0);
+	std::cout << "CacheManager destroyed with promotions pending passed.\n";
+
+	// Entries expire a TTL after they are written.
+	{
+		TestCache cache(4);
+		ExpiryOptions expiry;
+		expiry.ttl = std::chrono::milliseconds(50);
+		cache.set_expiry(expiry);
+		cache.insert(1, 10);
+		assert(*cache.get(1) == 10);
+		std::this_thread::sleep_for(std::chrono::milliseconds(60));
+		assert(cache.get(1) == nullptr);
+	}
+	std::cout << "CacheManager TTL expiry passed.\n";
+
+	// Past the refresh threshold, a get() serves the current value and
+	// reloads it in the background.
+	{
+		TestCache cache(4);
+		std::atomic<int> loads(0);
+		std::atomic<bool> release(true);
+		cache.set_loader([&](const int&, int& value) {
+			while (!release.load()) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			value = 100 + ++loads;
+			return true;
+		});
+		ExpiryOptions expiry;
+		expiry.ttl = std::chrono::milliseconds(400);
+		expiry.refresh_ratio = 0.25;
+		cache.set_expiry(expiry);
+		cache.insert(1, 10);
+		std::this_thread::sleep_for(std::chrono::milliseconds(120));
+		// Hold the reload until the served value has been read.
+		release = false;
+		assert(*cache.get(1) == 10);
+		release = true;
+		while (*cache.get(1) == 10) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		assert(loads == 1 && *cache.get(1) == 101);
+		std::cout << "CacheManager refresh-ahead passed.\n";
+
+		// An insert made while the reload runs is not overwritten by it.
+		std::this_thread::sleep_for(std::chrono::milliseconds(120));
+		release = false;
+		assert(*cache.get(1) == 101);
+		cache.insert(1, 42);
+		release = true;
+		while (loads < 2) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		assert(*cache.get(1) == 42);
+	}
+	std::cout << "CacheManager refresh racing insert passed.\n";
+
+	// Destroying the cache waits for a reload still in flight.
+	{
+		std::atomic<bool> release(false);
+		std::atomic<int> loads(0);
+		std::thread releaser;
+		{
+			TestCache cache(4);
+			cache.set_loader([&](const int&, int& value) {
+				while (!release.load()) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+				value = ++loads;
+				return true;
+			});
+			ExpiryOptions expiry;
+			expiry.ttl = std::chrono::milliseconds(400);
+			expiry.refresh_ratio = 0.25;
+			cache.set_expiry(expiry);
+			cache.insert(1, 10);
+			std::this_thread::sleep_for(std::chrono::milliseconds(120));
+			assert(*cache.get(1) == 10);
+			releaser = std::thread([&release]() {
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				release = true;
+			});
+		}
+		assert(loads == 1);
+		releaser.join();
+	}
+	std::cout << "CacheManager destroyed with a reload pending passed.\n";
+
+	// Misses recorded after an insert, colliding with it in the filter,
+	// don't hide the cached key.
+	{
+		TestCache cache(4);
+		NegativeCacheOptions options;
+		options.expected_keys = 1 << 20;
+		options.max_bytes = NegativeCache<int>::BLOCK_BYTES;
+		cache.enable_negative_cache(options);
+		cache.set_loader([](const int&, int&) {
+			return false;
+		});
+		cache.insert(1, 10);
+		for (int k = 1000; k < 2000; ++k) {
+			assert(cache.get(k) == nullptr);
+		}
+		assert(cache.get(1) != nullptr && *cache.get(1) == 10);
+	}
+	std::cout << "CacheManager negative cache collision passed.\n";
+
+	// gets() and cas(), including on entries restored by load().
+	{
+		TestCache cache(4);
+		cache.insert(1, 10);
+		int value = 0;
+		std::uint64_t first = 0;
+		assert(cache.gets(1, value, first) && value == 10);
+		assert(cache.cas(1, 11, first) == CasResult::STORED);
+		assert(cache.cas(1, 12, first) == CasResult::EXISTS);
+		assert(cache.cas(2, 20, first) == CasResult::NOT_FOUND);
+		std::uint64_t second = 0;
+		assert(cache.gets(1, value, second) && value == 11);
+		assert(second != first);
+
+		std::stringstream stream;
+		cache.dump(stream);
+		TestCache restored(4);
+		restored.load(stream);
+		std::uint64_t loaded = 0;
+		assert(restored.gets(1, value, loaded) && value == 11);
+		// Zero would mean no version was assigned on load.
+		assert(loaded != 0);
+		assert(restored.cas(1, 13, loaded) == CasResult::STORED);
+		assert(restored.cas(1, 14, loaded) == CasResult::EXISTS);
+	}
+	std::cout << "CacheManager gets(), cas() passed.\n";
+
+	// add(), replace(), incr(), decr(), and how they treat expired entries.
+	{
+		TestCache cache(4);
+		assert(cache.add(1, 10));
+		assert(!cache.add(1, 11));
+		assert(cache.replace(1, 12) && *cache.get(1) == 12);
+		assert(!cache.replace(2, 20));
+		assert(*cache.incr(1, 5) == 17);
+		assert(*cache.decr(1, 7) == 10);
+		assert(!cache.incr(2, 1));
+
+		ExpiryOptions expiry;
+		expiry.ttl = std::chrono::milliseconds(30);
+		cache.set_expiry(expiry);
+		cache.insert(3, 30);
+		cache.insert(4, 40);
+		cache.insert(5, 50);
+		std::this_thread::sleep_for(std::chrono::milliseconds(40));
+		assert(!cache.replace(3, 31));
+		assert(!cache.incr(4, 1));
+		assert(cache.add(5, 51) && *cache.get(5) == 51);
+		std::uint64_t cas = 0;
+		int value = 0;
+		assert(cache.gets(5, value, cas));
+		std::this_thread::sleep_for(std::chrono::milliseconds(40));
+		assert(cache.cas(5, 52, cas) == CasResult::NOT_FOUND);
+	}
+	std::cout << "CacheManager add(), replace(), incr(), decr() passed.\n";
+
+	// The expiry task removes expired entries, writing dirty ones out first.
+	{
+		const std::string path = "/tmp/cache-manager-test.sweep";
+		std::remove(path.c_str());
+		auto owned = std::make_unique<FileStore<int, int>>(path);
+		FileStore<int, int> *store = owned.get();
+		TestCache cache(64);
+		WriteBackOptions write_back;
+		write_back.interval = std::chrono::milliseconds(60000);
+		cache.enable_write_back(std::move(owned), write_back);
+		ExpiryOptions expiry;
+		expiry.ttl = std::chrono::milliseconds(20);
+		cache.set_expiry(expiry);
+		MaintenanceOptions maintenance;
+		maintenance.own_thread = false;
+		cache.enable_maintenance(maintenance);
+		// Rewrites move the same 32 stamps to the back of the order.
+		for (int i = 0; i < 1000; ++i) {
+			cache.insert(i % 32, i);
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(30));
+		cache.run_maintenance();
+		auto all = [](const int&, const int&) {
+			return true;
+		};
+		assert(cache.collect(all).empty());
+		assert(store->writes() == 32);
+		int value = 0;
+		assert(store->read(7, value) && value == 999);
+
+		// Replacing a running scheduler stops the old one cleanly, even
+		// while it is sweeping.
+		for (int round = 0; round < 50; ++round) {
+			cache.enable_maintenance();
+			for (int i = 0; i < 64; ++i) {
+				cache.insert(i, i);
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(
+				round % 2 == 0 ? 1 : 21));
+		}
+		while (!cache.collect(all).empty()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::remove(path.c_str());
+	}
+	std::cout << "CacheManager maintenance passed.\n";
+
+	// Memory pressure shrinks the cache, and keeps steering after the
+	// scheduler is replaced.
+	{
+		MemoryPressureOptions options;
+		options.current_path = "/tmp/cache-manager-test.cache.current";
+		options.max_path = "/tmp/cache-manager-test.cache.max";
+		options.step = 0.1;
+		options.min_capacity = 10;
+		options.interval = std::chrono::milliseconds(0);
+		write_file(options.max_path, "1000");
+		write_file(options.current_path, "900");
+		TestCache cache(100);
+		MaintenanceOptions maintenance;
+		maintenance.own_thread = false;
+		cache.enable_maintenance(maintenance);
+		cache.enable_memory_pressure(options);
+		cache.run_maintenance();
+		assert(cache.capacity() == 90);
+		cache.enable_maintenance(maintenance);
+		cache.run_maintenance();
+		assert(cache.capacity() == 80);
+		std::remove(options.current_path.c_str());
+		std::remove(options.max_path.c_str());
+	}
+	std::cout << "CacheManager memory pressure passed.\n";
 }
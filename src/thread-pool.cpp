@@ -0,0 +1,136 @@
+/**
+ * @file thread-pool.cpp
+ * @class ThreadPool
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * ThreadPool implementation.
+ */
+
+#include "thread-pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+using namespace csc;
+
+ThreadPool::ThreadPool(std::size_t workers) : _stop(false)
+{
+	if (workers == 0) {
+		workers = std::max(1u, std::thread::hardware_concurrency());
+	}
+	_workers.reserve(workers);
+	for (std::size_t i = 0; i < workers; ++i) {
+		_workers.emplace_back(&ThreadPool::run, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+}
+
+ThreadPool& ThreadPool::shared()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_tasks.push(std::move(task));
+	}
+	_cv.notify_one();
+}
+
+void ThreadPool::parallel_for(std::size_t n, std::size_t grain,
+	const std::function<void(std::size_t, std::size_t)>& fn)
+{
+	if (n == 0) {
+		return;
+	}
+	grain = std::max<std::size_t>(grain, 1);
+	const std::size_t ranges = (n + grain - 1) / grain;
+
+	// Shared between the caller and the helpers; helpers may still hold it
+	// after the caller returns, so it lives on the heap.
+	struct State {
+		std::atomic<std::size_t> next{0};
+		std::size_t pending;
+		std::exception_ptr error;
+		std::mutex mutex;
+		std::condition_variable done;
+	};
+	auto state = std::make_shared<State>();
+	state->pending = ranges;
+
+	auto work = [state, n, grain, ranges, &fn]() {
+		std::size_t r;
+		while ((r = state->next.fetch_add(1)) < ranges) {
+			std::size_t begin = r * grain;
+			std::size_t end = std::min(begin + grain, n);
+			std::exception_ptr error;
+			try {
+				fn(begin, end);
+			} catch (...) {
+				error = std::current_exception();
+			}
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (error && !state->error) {
+				state->error = error;
+			}
+			if (--state->pending == 0) {
+				state->done.notify_all();
+			}
+		}
+	};
+
+	// One helper per worker at most; the caller works too, so a call made
+	// from inside a worker still finishes if every other worker is busy.
+	std::size_t helpers = std::min(_workers.size(), ranges - 1);
+	for (std::size_t i = 0; i < helpers; ++i) {
+		submit(work);
+	}
+	work();
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->done.wait(lock, [&state]() { return state->pending == 0; });
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+
+std::size_t ThreadPool::size() const
+{
+	return _workers.size();
+}
+
+void ThreadPool::run()
+{
+	for (;;) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+			if (_stop && _tasks.empty()) {
+				return;
+			}
+			task = std::move(_tasks.front());
+			_tasks.pop();
+		}
+		task();
+	}
+}
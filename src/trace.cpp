@@ -0,0 +1,177 @@
+/**
+ * @file trace.cpp
+ * @class Tracer, TraceRing
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * Tracer and TraceRing implementation.
+ */
+
+#include "trace.h"
+#include "binary-io.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace csc;
+
+TraceRing::TraceRing(std::size_t capacity, std::uint32_t thread) :
+	_capacity(std::max<std::size_t>(capacity, 1)),
+	_thread(thread),
+	_head(0),
+	_tail(0)
+{
+	// One spare slot, for the writer to fill while a copy runs.
+	std::size_t n = 1;
+	while (n < _capacity + 1) {
+		n <<= 1;
+	}
+	_records = std::make_unique<TraceRecord[]>(n);
+	_mask = n - 1;
+}
+
+void TraceRing::push(std::uint64_t start, std::uint64_t end,
+	TracePhase phase)
+{
+	std::uint64_t head = _head.load(std::memory_order_relaxed);
+	_records[head & _mask] = TraceRecord{start, end - start, _thread, phase,
+		0};
+	_head.store(head + 1, std::memory_order_release);
+}
+
+void TraceRing::copy(std::vector<TraceRecord>& out) const
+{
+	std::uint64_t slots = _mask + 1;
+	std::uint64_t head = _head.load(std::memory_order_acquire);
+	std::uint64_t from = std::max(_tail.load(std::memory_order_relaxed),
+		head > _capacity ? head - _capacity : 0);
+	std::size_t base = out.size();
+	for (std::uint64_t i = from; i < head; ++i) {
+		out.push_back(_records[i & _mask]);
+	}
+	// The writer may be rewriting records up to now - slots; drop them.
+	std::uint64_t now = _head.load(std::memory_order_acquire);
+	if (now + 1 > from + slots) {
+		std::size_t torn = static_cast<std::size_t>(std::min(
+			now + 1 - slots - from, head - from));
+		out.erase(out.begin() + base, out.begin() + base + torn);
+	}
+}
+
+void TraceRing::clear()
+{
+	_tail.store(_head.load(std::memory_order_acquire),
+		std::memory_order_relaxed);
+}
+
+Tracer::Tracer() :
+	_capacity(DEFAULT_RING_CAPACITY),
+	_ticks_per_ns(1.0)
+{
+	// do nothing
+}
+
+Tracer& Tracer::shared()
+{
+	static Tracer tracer;
+	return tracer;
+}
+
+TraceRing& Tracer::ring()
+{
+	static thread_local TraceRing *mine = nullptr;
+	if (mine == nullptr) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_rings.push_back(std::make_shared<TraceRing>(_capacity,
+			static_cast<std::uint32_t>(_rings.size())));
+		mine = _rings.back().get();
+	}
+	return *mine;
+}
+
+void Tracer::record(std::uint64_t start, std::uint64_t end, TracePhase phase)
+{
+	ring().push(start, end, phase);
+}
+
+void Tracer::set_ring_capacity(std::size_t capacity)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_capacity = std::max<std::size_t>(capacity, 1);
+}
+
+double Tracer::calibrate()
+{
+	std::call_once(_calibrated, [this]() {
+		auto wall = std::chrono::steady_clock::now();
+		std::uint64_t ticks = tsc();
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		std::uint64_t elapsed_ticks = tsc() - ticks;
+		double elapsed_ns = std::chrono::duration<double, std::nano>(
+			std::chrono::steady_clock::now() - wall).count();
+		if (elapsed_ns > 0 && elapsed_ticks > 0) {
+			_ticks_per_ns = static_cast<double>(elapsed_ticks) / elapsed_ns;
+		}
+	});
+	return _ticks_per_ns;
+}
+
+std::size_t Tracer::dump(std::ostream& out)
+{
+	double ticks_per_ns = calibrate();
+	std::vector<TraceRecord> records;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (const std::shared_ptr<TraceRing>& ring : _rings) {
+			ring->copy(records);
+		}
+	}
+	BinaryWriter writer(out);
+	write_dump_header(writer, DumpKind::TRACE, records.size());
+	writer.put(ticks_per_ns);
+	for (const TraceRecord& record : records) {
+		writer.put(record);
+	}
+	write_dump_trailer(writer, records.size());
+	writer.flush();
+	return records.size();
+}
+
+std::size_t Tracer::dump(const std::string& path)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out) {
+		throw std::runtime_error("Cannot open trace file " + path);
+	}
+	return dump(out);
+}
+
+TraceDump Tracer::read(std::istream& in)
+{
+	BinaryReader reader(in);
+	DumpHeader header = read_dump_header(reader);
+	if (header.kind != DumpKind::TRACE) {
+		throw std::runtime_error("Not a trace dump");
+	}
+	TraceDump dump;
+	dump.ticks_per_ns = reader.get<double>();
+	dump.records.reserve(header.count);
+	for (std::uint64_t n = 0; n < header.count; ++n) {
+		dump.records.push_back(reader.get<TraceRecord>());
+	}
+	read_dump_trailer(reader, header.count);
+	return dump;
+}
+
+void Tracer::clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (const std::shared_ptr<TraceRing>& ring : _rings) {
+		ring->clear();
+	}
+}
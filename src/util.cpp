@@ -1,24 +1,332 @@
 #include "util.h"
 
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
 
 using namespace util;
 
-std::vector<int> generate_random(int n, int min, int max)
+namespace {
+std::uint64_t rotl(std::uint64_t x, int k)
 {
-    std::vector<int> numbers;
-    
-    // Create a random number generator with a random device seed
-    std::random_device rd;
-    std::mt19937 gen(rd()); // Mersenne Twister engine
-    
-    // Define the range for the random numbers
-    std::uniform_int_distribution<> dis(min, max);
+	return (x << k) | (x >> (64 - k));
+}
+
+// Maps x in 0..items-1 to its place in a fixed permutation of 0..items-1.
+// Adds, odd multiplies and xor-shifts are bijections on the enclosing power
+// of two; the add moves rank 0 off key 0. A result past the end is mixed
+// again (cycle walking) until it lands inside, which each round does with
+// probability over 1/2. Unlike hashing and taking the remainder, no two
+// ranks share a key.
+std::uint64_t scramble(std::uint64_t x, std::uint64_t items)
+{
+	int bits = items > 1 ? 64 - __builtin_clzll(items - 1) : 1;
+	std::uint64_t mask = bits == 64 ? ~0ull : (1ull << bits) - 1;
+	int shift = std::max(bits / 2, 1);
+	do {
+		x = (x + 0x632be59bd9b4e019ull) & mask;
+		x = (x * 0x9e3779b97f4a7c15ull) & mask;
+		x ^= x >> shift;
+		x = (x * 0xbf58476d1ce4e5b9ull) & mask;
+		x ^= x >> shift;
+	} while (x >= items);
+	return x;
+}
+
+// Sum of 1/i^theta for i in (from, to].
+double zeta(std::uint64_t from, std::uint64_t to, double theta)
+{
+	double sum = 0;
+	for (std::uint64_t i = from + 1; i <= to; ++i) {
+		sum += 1.0 / std::pow(static_cast<double>(i), theta);
+	}
+	return sum;
+}
+
+bool zipfian(Distribution distribution)
+{
+	return distribution == Distribution::ZIPFIAN ||
+		distribution == Distribution::SCRAMBLED_ZIPFIAN ||
+		distribution == Distribution::LATEST;
+}
+}
+
+std::vector<int> util::generate_random(int n, int min, int max,
+	std::uint64_t seed)
+{
+	std::vector<int> numbers(static_cast<std::size_t>(std::max(n, 0)));
+	Xoshiro256 rng(seed);
+	std::uint64_t range = static_cast<std::uint64_t>(
+		static_cast<std::int64_t>(max) - min) + 1;
+	for (int& number : numbers) {
+		number = static_cast<int>(min + static_cast<std::int64_t>(
+			rng.below(range)));
+	}
+	return numbers;
+}
+
+std::uint64_t SplitMix64::next()
+{
+	std::uint64_t z = (_state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+Xoshiro256::Xoshiro256(std::uint64_t seed)
+{
+	SplitMix64 seeder(seed);
+	for (std::uint64_t& s : _s) {
+		s = seeder.next();
+	}
+}
+
+std::uint64_t Xoshiro256::next()
+{
+	std::uint64_t result = rotl(_s[1] * 5, 7) * 9;
+	std::uint64_t t = _s[1] << 17;
+	_s[2] ^= _s[0];
+	_s[3] ^= _s[1];
+	_s[1] ^= _s[2];
+	_s[0] ^= _s[3];
+	_s[2] ^= t;
+	_s[3] = rotl(_s[3], 45);
+	return result;
+}
+
+double Xoshiro256::uniform()
+{
+	// The top 53 bits, as a fraction.
+	return static_cast<double>(next() >> 11) * 0x1.0p-53;
+}
+
+std::uint64_t Xoshiro256::below(std::uint64_t n)
+{
+	if (n == 0) {
+		return 0;
+	}
+	unsigned __int128 m = static_cast<unsigned __int128>(next()) * n;
+	std::uint64_t low = static_cast<std::uint64_t>(m);
+	if (low < n) {
+		// Reject the few values that would bias the result.
+		std::uint64_t threshold = -n % n;
+		while (low < threshold) {
+			m = static_cast<unsigned __int128>(next()) * n;
+			low = static_cast<std::uint64_t>(m);
+		}
+	}
+	return static_cast<std::uint64_t>(m >> 64);
+}
+
+Zipfian::Zipfian(std::uint64_t items, double theta) :
+	_items(std::max<std::uint64_t>(items, 1)),
+	// theta = 1 divides by zero below.
+	_theta(std::min(std::max(theta, 0.01), 0.999)),
+	_alpha(1.0 / (1.0 - _theta)),
+	_zeta2(zeta(0, 2, _theta)),
+	_zetan(zeta(0, _items, _theta))
+{
+	_eta = eta();
+}
+
+double Zipfian::eta() const
+{
+	double n = static_cast<double>(_items);
+	return (1.0 - std::pow(2.0 / n, 1.0 - _theta)) / (1.0 - _zeta2 / _zetan);
+}
 
-    // Generate 'n' random numbers
-    for (int i = 0; i < n; ++i) {
-        numbers.push_back(dis(gen));
-    }
+void Zipfian::grow(std::uint64_t items)
+{
+	if (items <= _items) {
+		return;
+	}
+	_zetan += zeta(_items, items, _theta);
+	_items = items;
+	_eta = eta();
+}
 
-    return numbers;
+std::uint64_t Zipfian::next(Xoshiro256& rng)
+{
+	double u = rng.uniform();
+	double uz = u * _zetan;
+	if (uz < 1.0) {
+		return 0;
+	}
+	if (uz < 1.0 + std::pow(0.5, _theta)) {
+		return std::min<std::uint64_t>(1, _items - 1);
+	}
+	std::uint64_t rank = static_cast<std::uint64_t>(
+		static_cast<double>(_items) *
+		std::pow(_eta * u - _eta + 1.0, _alpha));
+	return std::min(rank, _items - 1);
+}
+
+KeyGenerator::KeyGenerator(const KeyOptions& options) :
+	_options(options),
+	_rng(options.seed),
+	// The O(items) setup only for the distributions that need it.
+	_zipf(zipfian(options.distribution) ? options.items : 1, options.theta),
+	_sequence(0)
+{
+	_options.items = std::max<std::uint64_t>(_options.items, 1);
+	_hot = std::max<std::uint64_t>(static_cast<std::uint64_t>(
+		_options.hot_fraction * static_cast<double>(_options.items)), 1);
+}
+
+std::uint64_t KeyGenerator::next()
+{
+	std::uint64_t items = _options.items;
+	switch (_options.distribution) {
+	case Distribution::UNIFORM:
+		return _rng.below(items);
+	case Distribution::ZIPFIAN:
+		return _zipf.next(_rng);
+	case Distribution::SCRAMBLED_ZIPFIAN:
+		return scramble(_zipf.next(_rng), items);
+	case Distribution::HOTSPOT:
+		if (_hot >= items || _rng.uniform() < _options.hot_ops) {
+			return _rng.below(std::min(_hot, items));
+		}
+		return _hot + _rng.below(items - _hot);
+	case Distribution::LATEST:
+		return items - 1 - _zipf.next(_rng);
+	case Distribution::SEQUENTIAL:
+		return _sequence++ % items;
+	}
+	return 0;
+}
+
+void KeyGenerator::fill(std::uint64_t *out, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		out[i] = next();
+	}
+}
+
+void KeyGenerator::grow(std::uint64_t items)
+{
+	if (items <= _options.items) {
+		return;
+	}
+	_options.items = items;
+	if (zipfian(_options.distribution)) {
+		_zipf.grow(items);
+	}
+}
+
+WorkloadOptions util::ycsb(char workload, std::uint64_t items,
+	std::uint64_t seed)
+{
+	WorkloadOptions options;
+	options.keys.items = items;
+	options.keys.seed = seed;
+	options.keys.distribution = Distribution::ZIPFIAN;
+	options.read = 0;
+	switch (workload) {
+	case 'A': case 'a':
+		options.read = 0.5;
+		options.update = 0.5;
+		break;
+	case 'B': case 'b':
+		options.read = 0.95;
+		options.update = 0.05;
+		break;
+	case 'C': case 'c':
+		options.read = 1.0;
+		break;
+	case 'D': case 'd':
+		options.read = 0.95;
+		options.insert = 0.05;
+		options.keys.distribution = Distribution::LATEST;
+		break;
+	case 'E': case 'e':
+		options.scan = 0.95;
+		options.insert = 0.05;
+		break;
+	case 'F': case 'f':
+		options.read = 0.5;
+		options.read_modify_write = 0.5;
+		break;
+	default:
+		throw std::invalid_argument("No YCSB workload " +
+			std::string(1, workload));
+	}
+	return options;
+}
+
+Workload::Workload(const WorkloadOptions& options) :
+	_options(options),
+	_keys(options.keys),
+	_next_insert(_keys.items() + options.insert_offset),
+	// Its own stream, so the mix doesn't shift the keys for a given seed.
+	_rng(options.keys.seed ^ 0x5851f42d4c957f2dull),
+	_sizes(options.values.distribution == Distribution::ZIPFIAN &&
+		options.values.max > options.values.min ?
+		std::uint64_t(options.values.max) - options.values.min + 1 : 1,
+		options.keys.theta)
+{
+	_options.values.max = std::max(_options.values.max, _options.values.min);
+	_options.max_scan_length = std::max<std::uint32_t>(
+		_options.max_scan_length, 1);
+	_options.insert_stride = std::max<std::uint64_t>(_options.insert_stride,
+		1);
+	double total = _options.read + _options.update + _options.insert +
+		_options.scan + _options.read_modify_write;
+	if (total <= 0) {
+		throw std::invalid_argument("Workload has no operations");
+	}
+	_cut[0] = _options.read / total;
+	_cut[1] = _cut[0] + _options.update / total;
+	_cut[2] = _cut[1] + _options.insert / total;
+	_cut[3] = _cut[2] + _options.scan / total;
+}
+
+std::uint32_t Workload::value_size()
+{
+	const ValueSizeOptions& values = _options.values;
+	std::uint64_t span = std::uint64_t(values.max) - values.min + 1;
+	if (span == 1) {
+		return values.min;
+	}
+	if (values.distribution == Distribution::ZIPFIAN) {
+		return values.min + static_cast<std::uint32_t>(_sizes.next(_rng));
+	}
+	return values.min + static_cast<std::uint32_t>(_rng.below(span));
+}
+
+Op Workload::next()
+{
+	Op op;
+	double u = _rng.uniform();
+	if (u < _cut[0]) {
+		op.type = OpType::READ;
+	} else if (u < _cut[1]) {
+		op.type = OpType::UPDATE;
+	} else if (u < _cut[2]) {
+		op.type = OpType::INSERT;
+	} else if (u < _cut[3]) {
+		op.type = OpType::SCAN;
+	} else {
+		op.type = OpType::READ_MODIFY_WRITE;
+	}
+
+	if (op.type == OpType::INSERT) {
+		op.key = _next_insert;
+		_next_insert += _options.insert_stride;
+		_keys.grow(op.key + 1);
+	} else {
+		op.key = _keys.next();
+	}
+	op.length = op.type == OpType::SCAN ?
+		1 + static_cast<std::uint32_t>(_rng.below(_options.max_scan_length)) :
+		value_size();
+	return op;
+}
+
+void Workload::fill(Op *out, std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i) {
+		out[i] = next();
+	}
 }
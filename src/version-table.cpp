@@ -0,0 +1,52 @@
+/**
+ * @file version-table.cpp
+ * @class VersionTable
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * VersionTable implementation.
+ */
+
+#include "version-table.h"
+
+using namespace csc;
+
+VersionTable::VersionTable(std::size_t stripes)
+{
+	std::size_t n = 1;
+	while (n < stripes) {
+		n <<= 1;
+	}
+	_mask = n - 1;
+	_versions.reset(new std::atomic<std::uint64_t>[n]);
+	for (std::size_t i = 0; i < n; ++i) {
+		_versions[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+std::size_t VersionTable::stripe(std::size_t hash) const
+{
+	// Fibonacci hashing, so weak hashes still spread over the stripes.
+	std::uint64_t h = static_cast<std::uint64_t>(hash) *
+		0x9e3779b97f4a7c15ull;
+	return static_cast<std::size_t>(h >> 40) & _mask;
+}
+
+std::uint64_t VersionTable::current(std::size_t stripe) const
+{
+	return _versions[stripe].load(std::memory_order_acquire);
+}
+
+void VersionTable::bump(std::size_t stripe)
+{
+	_versions[stripe].fetch_add(1, std::memory_order_release);
+}
+
+void VersionTable::bump_all()
+{
+	for (std::size_t i = 0; i <= _mask; ++i) {
+		bump(i);
+	}
+}
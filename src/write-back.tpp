@@ -0,0 +1,202 @@
+/**
+ * @file write-back.tpp
+ * @class WriteBack
+ *
+ * @author Tyler Baxter
+ * @version 1.0
+ * @since 2026-10-19
+ *
+ * WriteBack implementation.
+ */
+
+#include "write-back.h"
+
+#include <algorithm>
+
+using namespace csc;
+
+template <typename K, typename V>
+WriteBack<K, V>::WriteBack(BackingStore<K, V>& store,
+	const WriteBackOptions& options) :
+	_store(store),
+	_options(options),
+	_coalesced(0),
+	_errors(0),
+	_waiting(0),
+	_stop(false),
+	_flusher(&WriteBack::run, this)
+{
+	// do nothing
+}
+
+template <typename K, typename V>
+WriteBack<K, V>::~WriteBack()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	_flusher.join();
+	// Last chance for anything the flusher couldn't write.
+	try {
+		flush_all();
+	} catch (...) {
+		// do nothing
+	}
+}
+
+template <typename K, typename V>
+void WriteBack<K, V>::mark_dirty(const K& key, const V& value)
+{
+	bool full;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _dirty.find(key);
+		if (it != _dirty.end()) {
+			it->second = value;
+			++_coalesced;
+		} else {
+			_dirty.emplace(key, value);
+		}
+		full = _dirty.size() >= _options.batch_size;
+	}
+	if (full) {
+		_cv.notify_one();
+	}
+}
+
+template <typename K, typename V>
+bool WriteBack<K, V>::dirty(const K& key)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _dirty.find(key) != _dirty.end();
+}
+
+template <typename K, typename V>
+void WriteBack<K, V>::flush(const K& key)
+{
+	// Announced first, so the flusher gives way between batches rather
+	// than taking the write lock straight back.
+	++_waiting;
+	std::lock_guard<std::mutex> write_lock(_write_mutex);
+	--_waiting;
+	std::vector<std::pair<K, V>> batch;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto it = _dirty.find(key);
+		if (it == _dirty.end()) {
+			return;
+		}
+		batch.emplace_back(it->first, std::move(it->second));
+		_dirty.erase(it);
+	}
+	try {
+		_store.write_batch(batch);
+	} catch (...) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_errors;
+		_dirty.emplace(std::move(batch.front().first),
+			std::move(batch.front().second));
+		throw;
+	}
+}
+
+template <typename K, typename V>
+void WriteBack<K, V>::flush_all()
+{
+	std::lock_guard<std::mutex> write_lock(_write_mutex);
+	while (write_some(_options.batch_size) > 0) {
+		// do nothing
+	}
+}
+
+template <typename K, typename V>
+std::size_t WriteBack<K, V>::write_some(std::size_t max)
+{
+	std::vector<std::pair<K, V>> batch;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		batch.reserve(std::min(max, _dirty.size()));
+		for (auto it = _dirty.begin(); it != _dirty.end() &&
+			batch.size() < max; ) {
+			batch.emplace_back(it->first, std::move(it->second));
+			it = _dirty.erase(it);
+		}
+	}
+	if (batch.empty()) {
+		return 0;
+	}
+	try {
+		_store.write_batch(batch);
+	} catch (...) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_errors;
+		// Put the batch back, unless a newer write arrived meanwhile.
+		for (auto& kv : batch) {
+			_dirty.emplace(std::move(kv.first), std::move(kv.second));
+		}
+		throw;
+	}
+	return batch.size();
+}
+
+template <typename K, typename V>
+std::size_t WriteBack<K, V>::pending()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _dirty.size();
+}
+
+template <typename K, typename V>
+std::uint64_t WriteBack<K, V>::coalesced()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _coalesced;
+}
+
+template <typename K, typename V>
+std::uint64_t WriteBack<K, V>::errors()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _errors;
+}
+
+template <typename K, typename V>
+void WriteBack<K, V>::run()
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait_for(lock, _options.interval, [this]() {
+				return _stop || _dirty.size() >= _options.batch_size;
+			});
+			if (_stop) {
+				return;
+			}
+		}
+		// Drain whatever is dirty now, one batch at a time; writes that
+		// arrive meanwhile wait for the next round and keep coalescing. The
+		// write lock is taken per batch, so a flush(key) from a cache that
+		// is evicting under its own lock waits for one batch at most.
+		try {
+			std::size_t budget = pending();
+			while (budget > 0) {
+				while (_waiting.load() > 0) {
+					std::this_thread::yield();
+				}
+				std::size_t n;
+				{
+					std::lock_guard<std::mutex> write_lock(_write_mutex);
+					n = write_some(_options.batch_size);
+				}
+				if (n == 0) {
+					break;
+				}
+				budget -= std::min(budget, n);
+			}
+		} catch (...) {
+			// Counted in write_some(); retried on the next round.
+		}
+	}
+}
@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+
+# Regression gate for cache-bench. Runs the benchmark binary several times
+# pinned to one core, drops outlier runs, and compares each benchmark's
+# median ns/op against a baseline JSON checked into the repo. A benchmark
+# regresses when it is slower by more than --threshold percent and a
+# one-sided Mann-Whitney U test says the slowdown is not noise; more
+# allocations per op than the baseline is a regression outright. Exits 1
+# if anything regressed.
+#
+# Usage: bench-compare.py [--bench=build/cache-bench] [--runs=7]
+#                         [--baseline=tools/bench-baseline.json]
+#                         [--threshold=5] [--alpha=0.05] [--cpu=<core>]
+#                         [--filter=<substring>] [--reps=<n>] [--warmup=<n>]
+#                         [--save] [--json=<out>]
+#
+# --save records this run as the new baseline instead of comparing. The
+# checked-in baseline was recorded with --runs=5 --reps=5 --warmup=1 on a
+# shared build host; record your own on the machine that runs the gate.
+
+import argparse
+import itertools
+import json
+import math
+import os
+import random
+import statistics
+import subprocess
+import sys
+
+BASELINE_VERSION = 1
+# Enumerate every rank split for an exact p-value up to this many.
+EXACT_LIMIT = 200000
+BOOTSTRAP_RESAMPLES = 2000
+
+
+def pin_to(cpu):
+	def pin():
+		if hasattr(os, "sched_setaffinity"):
+			os.sched_setaffinity(0, {cpu})
+	return pin
+
+
+def run_bench(args):
+	"""Runs the benchmark args.runs times; returns {name: result} per run."""
+	command = [args.bench, "--json", f"--reps={args.reps}",
+		f"--warmup={args.warmup}"]
+	if args.filter:
+		command.append(f"--filter={args.filter}")
+	runs = []
+	for i in range(args.runs):
+		print(f"run {i + 1}/{args.runs}: {' '.join(command)}",
+			file=sys.stderr)
+		out = subprocess.run(command, check=True, stdout=subprocess.PIPE,
+			preexec_fn=pin_to(args.cpu) if args.cpu is not None else None)
+		report = json.loads(out.stdout)
+		runs.append({b["name"]: b for b in report["benchmarks"]})
+	return runs
+
+
+def drop_outliers(samples):
+	"""Drops samples outside Tukey's fences, 1.5 IQR past the quartiles."""
+	if len(samples) < 4:
+		return list(samples)
+	q1, _, q3 = statistics.quantiles(samples, n=4)
+	fence = 1.5 * (q3 - q1)
+	kept = [s for s in samples if q1 - fence <= s <= q3 + fence]
+	return kept or list(samples)
+
+
+def median_ci(samples, confidence=0.95, seed=1):
+	"""Bootstrap confidence interval of the median; seeded, so repeatable."""
+	rng = random.Random(seed)
+	medians = sorted(statistics.median(rng.choices(samples, k=len(samples)))
+		for _ in range(BOOTSTRAP_RESAMPLES))
+	tail = (1 - confidence) / 2
+	low = medians[int(tail * (len(medians) - 1))]
+	high = medians[int((1 - tail) * (len(medians) - 1))]
+	return low, high
+
+
+def summarize(runs):
+	"""Per benchmark: the kept median ns/op samples and their summary."""
+	names = []
+	for run in runs:
+		names += [n for n in run if n not in names]
+	summary = {}
+	for name in names:
+		results = [run[name] for run in runs if name in run]
+		samples = drop_outliers([r["median_ns"] for r in results])
+		low, high = median_ci(samples)
+		summary[name] = {
+			"samples": samples,
+			"median_ns": statistics.median(samples),
+			"ci_ns": [low, high],
+			"allocs_per_op": max(r.get("allocs_per_op", 0) for r in results),
+		}
+	return summary
+
+
+def ranks(values):
+	"""Ranks from 1, ties sharing their mean rank."""
+	order = sorted(range(len(values)), key=lambda i: values[i])
+	result = [0.0] * len(values)
+	i = 0
+	while i < len(order):
+		j = i
+		while j + 1 < len(order) and values[order[j + 1]] == values[order[i]]:
+			j += 1
+		for k in range(i, j + 1):
+			result[order[k]] = (i + j) / 2 + 1
+		i = j + 1
+	return result
+
+
+def slower_p(baseline, current):
+	"""One-sided Mann-Whitney U: p that current is not slower than baseline.
+	Exact over every rank split when there are few enough, normal
+	approximation with tie correction otherwise."""
+	n1, n2 = len(current), len(baseline)
+	if n1 == 0 or n2 == 0:
+		return 1.0
+	r = ranks(current + baseline)
+	observed = sum(r[:n1])
+	if math.comb(n1 + n2, n1) <= EXACT_LIMIT:
+		total = 0
+		extreme = 0
+		for pick in itertools.combinations(r, n1):
+			total += 1
+			if sum(pick) >= observed - 1e-9:
+				extreme += 1
+		return extreme / total
+	u = observed - n1 * (n1 + 1) / 2
+	n = n1 + n2
+	ties = {}
+	for value in r:
+		ties[value] = ties.get(value, 0) + 1
+	correction = sum(t ** 3 - t for t in ties.values()) / (n * (n - 1))
+	sigma = math.sqrt(n1 * n2 / 12 * (n + 1 - correction))
+	if sigma == 0:
+		return 1.0
+	z = (u - n1 * n2 / 2 - 0.5) / sigma
+	return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def compare(baseline, current, threshold, alpha):
+	"""Returns rows of (name, verdict, baseline, current, change, p)."""
+	rows = []
+	for name, now in current.items():
+		then = baseline.get(name)
+		if then is None:
+			rows.append((name, "new", None, now, None, None))
+			continue
+		change = (now["median_ns"] / then["median_ns"] - 1) * 100 \
+			if then["median_ns"] > 0 else 0.0
+		p = slower_p(then["samples"], now["samples"])
+		faster_p = slower_p(now["samples"], then["samples"])
+		if now["allocs_per_op"] > then.get("allocs_per_op", 0) + 0.01:
+			verdict = "REGRESSED (allocs)"
+		elif change > threshold and p < alpha:
+			verdict = "REGRESSED"
+		elif change < -threshold and faster_p < alpha:
+			verdict = "improved"
+		else:
+			verdict = "ok"
+		rows.append((name, verdict, then, now, change, p))
+	for name in baseline:
+		if name not in current:
+			rows.append((name, "missing", baseline[name], None, None, None))
+	return rows
+
+
+def print_rows(rows):
+	width = max([4] + [len(r[0]) for r in rows])
+	print(f"{'name':<{width}} {'baseline ns':>12} {'current ns':>12} "
+		f"{'95% CI':>21} {'change':>8} {'p':>7}  verdict")
+	for name, verdict, then, now, change, p in rows:
+		base = f"{then['median_ns']:12.2f}" if then else f"{'-':>12}"
+		cur = f"{now['median_ns']:12.2f}" if now else f"{'-':>12}"
+		ci = f"[{now['ci_ns'][0]:.2f}, {now['ci_ns'][1]:.2f}]" if now else "-"
+		delta = f"{change:+7.1f}%" if change is not None else f"{'-':>8}"
+		prob = f"{p:7.3f}" if p is not None else f"{'-':>7}"
+		print(f"{name:<{width}} {base} {cur} {ci:>21} {delta} {prob}  "
+			f"{verdict}")
+
+
+def write_summary(path, summary):
+	with open(path, "w") as f:
+		json.dump({"version": BASELINE_VERSION, "benchmarks": summary}, f,
+			indent=2)
+		f.write("\n")
+
+
+def main():
+	parser = argparse.ArgumentParser(
+		description="Compare cache-bench against a stored baseline.")
+	parser.add_argument("--bench", default="build/cache-bench")
+	parser.add_argument("--baseline", default=os.path.join(
+		os.path.dirname(os.path.abspath(__file__)), "bench-baseline.json"))
+	# Fewer than 4 runs a side can't reach p < 0.05.
+	parser.add_argument("--runs", type=int, default=7)
+	parser.add_argument("--reps", type=int, default=11)
+	parser.add_argument("--warmup", type=int, default=2)
+	parser.add_argument("--threshold", type=float, default=5.0,
+		help="percent slowdown that fails the gate")
+	parser.add_argument("--alpha", type=float, default=0.05,
+		help="significance level")
+	parser.add_argument("--cpu", type=int,
+		default=max(os.cpu_count() or 1, 1) - 1,
+		help="core to pin the benchmark to")
+	parser.add_argument("--filter", default="")
+	parser.add_argument("--save", action="store_true",
+		help="record this run as the baseline")
+	parser.add_argument("--json", help="also write this run's summary here")
+	args = parser.parse_args()
+	if args.runs < 1:
+		parser.error("--runs must be at least 1")
+
+	# Check the baseline before spending minutes on runs that can't use it.
+	stored = None
+	if not args.save:
+		try:
+			with open(args.baseline) as f:
+				stored = json.load(f)
+		except FileNotFoundError:
+			sys.exit(f"No baseline at {args.baseline}; record one with --save")
+		if stored.get("version") != BASELINE_VERSION:
+			sys.exit(f"{args.baseline}: unsupported baseline version")
+
+	current = summarize(run_bench(args))
+	if args.json:
+		write_summary(args.json, current)
+	if args.save:
+		write_summary(args.baseline, current)
+		print(f"Saved {len(current)} benchmarks to {args.baseline}")
+		return 0
+
+	# Benchmarks the filter skipped aren't missing.
+	baseline = {name: result for name, result in stored["benchmarks"].items()
+		if args.filter in name}
+	rows = compare(baseline, current, args.threshold, args.alpha)
+	print_rows(rows)
+	regressed = [r[0] for r in rows if r[1].startswith("REGRESSED")]
+	if regressed:
+		print(f"{len(regressed)} regression(s) over {args.threshold}%: "
+			f"{', '.join(regressed)}", file=sys.stderr)
+		return 1
+	return 0
+
+
+if __name__ == "__main__":
+	sys.exit(main())
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+
+# Converts a csc::Tracer dump to Chrome trace JSON, for chrome://tracing or
+# https://ui.perfetto.dev. Each record becomes a complete ("X") event on its
+# thread's track, so nested phases stack into a flame chart.
+#
+# Usage: trace2json.py <trace.bin> [out.json]
+
+import json
+import struct
+import sys
+
+DUMP_MAGIC = 0x4d435343		# "CSCM"
+DUMP_END = 0x444e4543		# "CEND"
+DUMP_VERSION = 1
+DUMP_KIND_TRACE = 3
+
+# In csc::TracePhase order.
+PHASES = [
+	"get",
+	"insert",
+	"lock wait",
+	"hash",
+	"bucket scan",
+	"lru relink",
+	"evict",
+	"load",
+]
+
+HEADER = struct.Struct("<IHHQ")
+RECORD = struct.Struct("<QQIHH")
+TRAILER = struct.Struct("<IQ")
+
+
+def read_trace(path):
+	with open(path, "rb") as f:
+		data = f.read()
+	magic, version, kind, count = HEADER.unpack_from(data, 0)
+	if magic != DUMP_MAGIC or version != DUMP_VERSION or \
+		kind != DUMP_KIND_TRACE:
+		sys.exit(f"{path}: not a trace dump")
+	offset = HEADER.size
+	(ticks_per_ns,) = struct.unpack_from("<d", data, offset)
+	offset += 8
+	records = [RECORD.unpack_from(data, offset + i * RECORD.size)
+		for i in range(count)]
+	offset += count * RECORD.size
+	end, trailer_count = TRAILER.unpack_from(data, offset)
+	if end != DUMP_END or trailer_count != count:
+		sys.exit(f"{path}: truncated or corrupt")
+	return ticks_per_ns, records
+
+
+def to_chrome(ticks_per_ns, records):
+	origin = min((r[0] for r in records), default=0)
+	events = []
+	for start, ticks, thread, phase, _ in records:
+		name = PHASES[phase] if phase < len(PHASES) else f"phase {phase}"
+		events.append({
+			"name": name,
+			"cat": "cache",
+			"ph": "X",
+			"pid": 0,
+			"tid": thread,
+			# Chrome wants microseconds.
+			"ts": (start - origin) / ticks_per_ns / 1000.0,
+			"dur": ticks / ticks_per_ns / 1000.0,
+		})
+	return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+	if len(sys.argv) not in (2, 3):
+		sys.exit(f"Usage: {sys.argv[0]} <trace.bin> [out.json]")
+	ticks_per_ns, records = read_trace(sys.argv[1])
+	trace = to_chrome(ticks_per_ns, records)
+	if len(sys.argv) == 3:
+		with open(sys.argv[2], "w") as f:
+			json.dump(trace, f)
+	else:
+		json.dump(trace, sys.stdout)
+
+
+if __name__ == "__main__":
+	main()